@@ -1,6 +1,7 @@
 #pragma once
 #include "AudioStream.hpp"
 #include "Sample.hpp"
+#include "AudioStats.hpp"
 
 extern class Audio* g_audio;
 
@@ -15,24 +16,55 @@ public:
 	Audio();
 	~Audio();
 	// Initializes the audio device
-	bool Init();
+	//	bufferSize is the device buffer size in samples and sampleRate the output rate, 0 uses the driver default
+	//	smaller buffers lower the output latency at the cost of a higher chance of underruns
+	bool Init(uint32 bufferSize = 0, uint32 sampleRate = 0);
+	// Initializes without an audio device, the mixer only runs inside Render
+	//	streams are decoded and commands applied on the calling thread, so rendering the same thing twice gives the same output
+	bool InitOffline(uint32 bufferSize = 512, uint32 sampleRate = 44100);
+	// Mixes <numSamples> interleaved stereo samples as fast as possible, only after InitOffline
+	void Render(float* out, uint32 numSamples);
+	// Renders <numSamples> and writes them to a 32 bit float wav file
+	bool RenderToFile(const String& path, uint32 numSamples);
 	void SetGlobalVolume(float vol);
 
 	// Opens a stream at path
 	//	settings preload loads the whole file into memory before playing
-	AudioStream CreateStream(const String& path, bool preload = false);
+	//	cachedLength keeps the first milliseconds of the stream decoded in the audio cache, so the next time the stream is opened it can start without decoding
+	AudioStream CreateStream(const String& path, bool preload = false, int32 cachedLength = 0);
+	// Opens a stream at path that plays the range starting at startTime (in milliseconds)
+	//	the decoded range is kept in the audio cache, so opening the same range again doesn't decode or read the file
+	//	the stream is positioned at the start of the range, playback past the end of the range is not guaranteed
+	AudioStream CreateCachedStream(const String& path, int32 startTime, int32 duration);
 	// Open a wav file at path
 	Sample CreateSample(const String& path);
 
 	// Target/Output sample rate
 	uint32 GetSampleRate() const;
 
+	// Measured time in seconds between mixing a sample and it being played by the device, including the limiter's lookahead
+	double GetOutputLatency() const;
+	// Levels of the mixed output after the limiter, updated every mix block
+	AudioMeter GetOutputMeter() const;
+	// Timing of the audio callbacks, for the debug HUD
+	const AudioStats& GetStats() const;
+	// When enabled, stream positions are corrected by the output latency so they match what is being heard
+	void SetLatencyCompensation(bool enabled);
+	bool GetLatencyCompensation() const;
+
+	// Memory used for decoded audio that is kept around between streams (previews, chart intros)
+	void SetCacheMemoryBudget(size_t bytes);
+	// Folder where decoded audio that doesn't fit in memory is stored, empty to disable
+	void SetCacheFolder(const String& folder);
+
 	// Private
 	class Audio_Impl* GetImpl();
 
-	// Calculated audio latency by the audio driver (currently unused)
+	// Calculated audio latency by the audio driver in milliseconds
 	int64 audioLatency;
 
 private:
+	bool m_Init(class IAudioOutput* output);
+
 	bool m_initialized = false;
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 
 /*
 	Base class for Digital Signal Processors
@@ -11,11 +12,39 @@ public:
 	virtual ~DSP();
 	// Process <numSamples> amount of samples in stereo float format
 	virtual void Process(float* out, uint32 numSamples) = 0;
+	// Allocates everything needed to process at the given rate, so changing settings afterwards never allocates
+	//	called when the DSP is added to an item, or up front by a DSPPool
+	virtual void Prepare(uint32 sampleRate) {}
+	// Clears the processing state so the DSP can be used again, only called while it is not added to an item
+	virtual void Reset() {}
+	// Number of frames the DSP delays the signal by
+	virtual uint32 GetLatency() const { return 0; }
+	// Nanoseconds the last call to Process took, measured by the mixer
+	uint32 GetProcessTime() const
+	{
+		return m_processTime.load(std::memory_order_relaxed);
+	}
 
 	float mix = 1.0f;
 	uint32 priority = 0;
 	class AudioBase* audioBase = nullptr;
 	class Audio_Impl* audio = nullptr;
+
+private:
+	std::atomic<uint32> m_processTime = { 0 };
+
+	friend class AudioBase;
+	friend class Audio_Impl;
+};
+
+// Signal levels of a mixed block
+struct AudioMeter
+{
+	// Largest absolute sample value
+	float peak = 0.0f;
+	float rms = 0.0f;
+	// Gain applied by the limiter at the end of the block, 1 when it isn't limiting
+	float gain = 1.0f;
 };
 
 /*
@@ -27,6 +56,7 @@ public:
 	virtual ~AudioBase();
 	// Process <numSamples> amount of samples in stereo float format
 	virtual void Process(float* out, uint32 numSamples) = 0;
+	// Runs the DSP chain as seen by the mixer, only called from the mixer
 	void ProcessDSPs(float*& out, uint32 numSamples);
 	// Adds a signal processor to the audio
 	void AddDSP(DSP* dsp);
@@ -44,9 +74,36 @@ public:
 	{
 		return m_volume;
 	}
+	// Nanoseconds it took to render the last block of this item, including it's DSP's
+	uint32 GetRenderTime() const
+	{
+		return m_renderTime.load(std::memory_order_relaxed);
+	}
+	// Frames that the DSP's being rendered on this item delay it's output by
+	uint32 GetDSPLatency() const
+	{
+		return m_dspLatency.load(std::memory_order_relaxed);
+	}
 
+	// DSP's added to this item from the game's side
 	Vector<DSP*> DSPs;
 	class Audio_Impl* audio = nullptr;
+
+	// Maximum number of DSP's on a single item
+	static const uint32 maxDSPs = 16;
+
 private:
+	// Called by the mixer when the DSP chain changes
+	void m_UpdateDSPLatency();
+
+	// Priority sorted DSP chain that the mixer runs
+	//	this is only modified by the mixer when it processes AddDSP/RemoveDSP commands, so it never allocates
+	DSP* m_renderDSPs[maxDSPs] = { nullptr };
+	uint32 m_numRenderDSPs = 0;
+	std::atomic<uint32> m_dspLatency = { 0 };
+	std::atomic<uint32> m_renderTime = { 0 };
+
 	float m_volume = 1.0f;
+
+	friend class Audio_Impl;
 };
\ No newline at end of file
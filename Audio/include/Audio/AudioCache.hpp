@@ -0,0 +1,82 @@
+#pragma once
+
+// Threading
+#include <mutex>
+
+struct PCMCacheHeader;
+
+/*
+	Decoded range of an audio file, stored as interleaved 16-bit stereo
+*/
+struct PCMSegment
+{
+	String path;
+	// Requested range in milliseconds, this is what the cache is searched by
+	int32 startTime = 0;
+	int32 duration = 0;
+	uint32 sampleRate = 0;
+	// Stream sample position of the first frame
+	int64 startSample = 0;
+	Vector<int16> data;
+
+	uint32 GetNumFrames() const
+	{
+		return (uint32)(data.size() / 2);
+	}
+	int64 GetEndSample() const
+	{
+		return startSample + GetNumFrames();
+	}
+	size_t GetMemoryUsage() const
+	{
+		return data.size() * sizeof(int16);
+	}
+};
+
+/*
+	Least recently used cache of decoded pcm segments (song previews and the start of charts)
+	Segments that don't fit in the memory budget are dropped or, when a disk folder is set, written to disk
+	Ref counts aren't atomic, so segments are only copied or released through the cache
+*/
+class AudioCache
+{
+public:
+	// Finds a segment in memory or on disk, returns null if there is none
+	Ref<PCMSegment> Find(const String& path, int32 startTime, int32 duration);
+	// Adds a segment and evicts the least recently used ones until the cache is within budget again
+	//	the caller keeps its reference, release it with Release
+	void Add(const Ref<PCMSegment>& segment);
+	// Releases a reference to a segment that might be shared with the cache
+	void Release(Ref<PCMSegment>& segment);
+	void Clear();
+
+	void SetMemoryBudget(size_t bytes);
+	size_t GetMemoryBudget() const;
+	size_t GetMemoryUsage() const;
+	// Folder to spill evicted segments to, relative to the working directory, empty disables spilling
+	void SetDiskFolder(const String& folder);
+
+private:
+	struct Entry
+	{
+		Ref<PCMSegment> segment;
+		List<String>::iterator lruPosition;
+	};
+
+	static String m_GetKey(const String& path, int32 startTime, int32 duration);
+	// Disk functions take a copy of the disk folder that was made under the lock
+	static String m_GetDiskPath(const String& folder, const String& key);
+	void m_Insert(const String& key, const Ref<PCMSegment>& segment, Vector<Ref<PCMSegment>>& evicted);
+	// Opens a file from the disk cache and reads it's header, fails if the file is damaged or the source file changed since it was saved
+	static bool m_OpenDiskFile(const String& diskPath, const String& path, File& file, PCMCacheHeader& header);
+	static Ref<PCMSegment> m_Load(const String& folder, const String& key, const String& path);
+	static bool m_Save(const String& folder, const String& key, const PCMSegment& segment);
+
+	mutable std::mutex m_lock;
+	Map<String, Entry> m_entries;
+	// Most recently used at the front
+	List<String> m_lru;
+	size_t m_memoryUsage = 0;
+	size_t m_memoryBudget = 128 * 1024 * 1024;
+	String m_diskFolder;
+};
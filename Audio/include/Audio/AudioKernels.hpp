@@ -0,0 +1,63 @@
+/*
+	Vectorized inner loops used by the mixer, samples and stream decoders
+	All functions work on float sample data, count parameters are in samples per channel unless stated otherwise
+	The instruction set is selected at compile time (AVX2 > SSE2 > NEON > scalar)
+*/
+#pragma once
+
+namespace AudioKernels
+{
+	// Biquad filter coefficients, normalized so a0 is 1
+	struct BiquadCoefficients
+	{
+		float b0 = 1.0f;
+		float b1 = 0.0f;
+		float b2 = 0.0f;
+		float a1 = 0.0f;
+		float a2 = 0.0f;
+	};
+	// Delay values of a stereo biquad filter (transposed direct form 2)
+	struct BiquadState
+	{
+		float s1[2] = { 0.0f };
+		float s2[2] = { 0.0f };
+	};
+
+	// Name of the instruction set the kernels were compiled for
+	const char* GetInstructionSet();
+
+	// dst[i] += src[i] * gain, for <count> floats
+	void MixAdd(float* dst, const float* src, float gain, uint32 count);
+	// data[i] *= gain, for <count> floats
+	void Scale(float* data, float gain, uint32 count);
+	// Scales interleaved stereo by a gain that moves linearly from <from> to <to>, the last sample is scaled by <to>
+	void ScaleRamp(float* data, float from, float to, uint32 numSamples);
+	// Largest absolute value of <count> floats
+	float PeakAbs(const float* data, uint32 count);
+	// Sum of the squares of <count> floats
+	float SumSquares(const float* data, uint32 count);
+
+	// Converts planar stereo to interleaved stereo
+	void Interleave(float* dst, const float* left, const float* right, uint32 numSamples);
+	// Converts interleaved stereo to planar stereo
+	void Deinterleave(float* left, float* right, const float* src, uint32 numSamples);
+	// Copies interleaved stereo data into an output with <dstChannels> channels, channels past the first 2 are left untouched
+	void CopyToChannels(float* dst, uint32 dstChannels, const float* src, uint32 numSamples);
+
+	// Converts signed 16 bit samples to float in the range [-1,1], for <count> values
+	void Int16ToFloat(float* dst, const int16* src, uint32 count);
+	// Converts signed 16 bit mono to interleaved float stereo
+	void Int16MonoToStereo(float* dst, const int16* src, uint32 numSamples);
+	// Converts signed 16 bit interleaved stereo to planar float stereo
+	void Int16ToPlanar(float* left, float* right, const int16* src, uint32 numSamples);
+	// Converts float samples to signed 16 bit, clipping values outside of [-1,1], for <count> values
+	void FloatToInt16(int16* dst, const float* src, uint32 count);
+
+	// Filters a single frame of interleaved stereo, dst[0] and dst[1] are set to the sum of src * coefficients for each channel
+	//	coefficients contains every tap twice (once for each channel), numTaps is the number of frames read from src
+	void ConvolveStereo(float* dst, const float* src, const float* coefficients, uint32 numTaps);
+
+	// Filters interleaved stereo in place, both channels are processed together
+	//	the coefficients move linearly from <from> to <to> over the block, so parameter changes don't click
+	void BiquadStereo(float* data, uint32 numSamples, BiquadState& state, const BiquadCoefficients& from, const BiquadCoefficients& to);
+}
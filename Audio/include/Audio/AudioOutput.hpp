@@ -6,28 +6,91 @@ public:
 	virtual void Mix(float* data, uint32& numSamples) = 0;
 };
 
+/*
+	Interface for the places the mixer's output can go to
+*/
+class IAudioOutput
+{
+public:
+	virtual ~IAudioOutput() = default;
+
+	// Safe to start mixing
+	virtual void Start(IMixer* mixer) = 0;
+	// Should stop mixing
+	virtual void Stop() = 0;
+
+	virtual uint32_t GetNumChannels() const = 0;
+	virtual uint32_t GetSampleRate() const = 0;
+
+	// The actual length of the buffer in seconds
+	virtual double GetBufferLength() const = 0;
+	// Time in seconds between handing samples to the device and them being played, including the buffer length
+	virtual double GetLatency() const = 0;
+	// The mixer is called by a device at the rate the audio is played, false when it only runs when asked to
+	virtual bool IsRealtime() const
+	{
+		return true;
+	}
+};
+
 /*
 	Low level audio output
 */
-class AudioOutput : public Unique
+class AudioOutput : public IAudioOutput, Unique
 {
 public:
 	AudioOutput();
 	~AudioOutput();
 
-	bool Init();
+	// Opens the output device
+	//	bufferSize is the requested device buffer size in samples, sampleRate the requested output rate
+	//	either can be 0 to use the driver's default, the driver may pick different values than requested
+	bool Init(uint32 bufferSize = 0, uint32 sampleRate = 0);
 
-	// Safe to start mixing
-	void Start(IMixer* mixer);
-	// Should stop mixing
-	void Stop();
+	virtual void Start(IMixer* mixer) override;
+	virtual void Stop() override;
 
-	uint32_t GetNumChannels() const;
-	uint32_t GetSampleRate() const;
+	virtual uint32_t GetNumChannels() const override;
+	virtual uint32_t GetSampleRate() const override;
 
-	// The actual length of the buffer in seconds
-	double GetBufferLength() const;
+	virtual double GetBufferLength() const override;
+	virtual double GetLatency() const override;
 
 private:
 	class AudioOutput_Impl* m_impl;
 };
+
+/*
+	Output without a device, the mixer only runs when Render is called and as fast as possible
+	used for benchmarks and for comparing rendered audio between runs
+*/
+class OfflineAudioOutput : public IAudioOutput, Unique
+{
+public:
+	// bufferSize is the number of samples the mixer is asked for at once, like a device buffer
+	OfflineAudioOutput(uint32 bufferSize = 512, uint32 sampleRate = 44100);
+
+	virtual void Start(IMixer* mixer) override;
+	virtual void Stop() override;
+
+	virtual uint32_t GetNumChannels() const override;
+	virtual uint32_t GetSampleRate() const override;
+
+	virtual double GetBufferLength() const override;
+	virtual double GetLatency() const override;
+	virtual bool IsRealtime() const override
+	{
+		return false;
+	}
+
+	// Runs the mixer for <numSamples> interleaved stereo samples
+	void Render(float* out, uint32 numSamples);
+
+	// Writes interleaved stereo samples to a 32 bit float wav file
+	static bool WriteWav(const String& path, const float* data, uint32 numSamples, uint32 sampleRate);
+
+private:
+	IMixer* m_mixer = nullptr;
+	uint32 m_bufferSize;
+	uint32 m_sampleRate;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <Shared/SeqLock.hpp>
+
+// Timing of a single audio callback, times are in nanoseconds
+struct AudioCallbackTiming
+{
+	// Clock time at the start of the callback, see Audio_Impl::GetClockTime
+	int64 start = 0;
+	// Time spent in the callback
+	uint32 duration = 0;
+	// Time it takes to play the samples of the callback, mixing should never take longer than this
+	uint32 budget = 0;
+	// Time spent rendering items (streams and their DSP's), sample voices and global DSP's
+	uint32 itemTime = 0;
+	uint32 voiceTime = 0;
+	uint32 globalDSPTime = 0;
+	uint32 numItems = 0;
+};
+
+/*
+	Always on timing of the audio callback
+	Written by the mixer only, everything can be read from any thread without locking
+	The last callbacks are kept in a ring where every slot is a SeqLock, so readers never see a half written record
+*/
+class AudioStats
+{
+public:
+	// Number of callbacks kept
+	static const uint32 historySize = 256;
+	// Bucket i of the duration histogram counts callbacks that took less than GetBucketLimit(i), the last one counts the rest
+	static const uint32 numBuckets = 10;
+
+	// Averages over a number of recent callbacks, in milliseconds
+	struct Summary
+	{
+		uint32 numCallbacks = 0;
+		double averageDuration = 0.0;
+		double maxDuration = 0.0;
+		double budget = 0.0;
+	};
+
+	// Mixer side
+	void AddCallback(const AudioCallbackTiming& timing, bool realtime);
+	// A callback output silence because a game thread was holding the mixer
+	void AddDroppedCallback();
+	// Called from the mixer or a mix worker when DSP's were skipped to meet the deadline
+	void AddBypassedBlock();
+	// An item was left out of a block because a mix worker didn't finish it in time
+	void AddDroppedItem();
+
+	uint64 GetNumCallbacks() const;
+	// Callbacks that took longer than their budget, the engine is too slow
+	uint64 GetNumOverruns() const;
+	// Callbacks that started so long after the previous one that the device must have run out of samples
+	//	the mixer can't see the device's buffer, so this is estimated from the time between callbacks
+	//	these are caused by the system when they happen without overruns
+	uint64 GetNumUnderruns() const;
+	uint64 GetNumDroppedCallbacks() const;
+	uint64 GetNumBypassedBlocks() const;
+	uint64 GetNumDroppedItems() const;
+	uint64 GetBucket(uint32 index) const;
+	// Upper limit of a histogram bucket in nanoseconds
+	static uint32 GetBucketLimit(uint32 index);
+
+	// Copies up to <maxCount> of the most recent callbacks to <out>, oldest first, returns the number copied
+	uint32 GetRecentCallbacks(AudioCallbackTiming* out, uint32 maxCount) const;
+	Summary Summarize(uint32 numCallbacks) const;
+	// Writes the counters and the histogram to the log
+	void Log() const;
+
+private:
+	static void m_Increment(std::atomic<uint64>& counter)
+	{
+		counter.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::atomic<uint64> m_numCallbacks = { 0 };
+	std::atomic<uint64> m_numOverruns = { 0 };
+	std::atomic<uint64> m_numUnderruns = { 0 };
+	std::atomic<uint64> m_numDropped = { 0 };
+	std::atomic<uint64> m_numBypassed = { 0 };
+	std::atomic<uint64> m_numDroppedItems = { 0 };
+	std::atomic<uint64> m_buckets[numBuckets] = {};
+	SeqLock<AudioCallbackTiming> m_history[historySize];
+
+	// Only used by the mixer
+	int64 m_lastStart = 0;
+	uint32 m_lastBudget = 0;
+};
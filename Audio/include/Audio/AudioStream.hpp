@@ -9,6 +9,8 @@ class AudioStreamRes : public AudioBase
 {
 public:
 	static Ref<AudioStreamRes> Create(class Audio* audio, const String& path, bool preload);
+	// Opens a stream that only plays the given range, served from the audio cache when possible
+	static Ref<AudioStreamRes> CreateCached(class Audio* audio, const String& path, int32 startTime, int32 duration);
 	virtual ~AudioStreamRes() = default;
 public:
 	// Starts playback of the stream or continues a paused stream
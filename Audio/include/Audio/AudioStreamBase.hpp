@@ -2,14 +2,34 @@
 #include "Audio.hpp"
 #include "AudioStream.hpp"
 #include "Audio_Impl.hpp"
+#include "AudioCache.hpp"
+#include "Resampler.hpp"
 
+/*
+	Base class for decoded audio streams
+	Decoding happens ahead of time on the audio decode thread, which fills a ring buffer of interleaved stereo frames
+	The decoded frames are converted to the output rate before they are buffered
+	The mixer only reads from this buffer and never waits on the decoder
+*/
 class AudioStreamBase : public AudioStreamRes
 {
-protected:
-	// Fixed point format for sample positions (used in resampling)
-	static const uint64 fp_sampleStep;
+public:
+	// Stream position at the start of the last rendered block, published by the mixer
+	struct PositionSnapshot
+	{
+		// Output sample index the block started at
+		int64 blockOutputPosition;
+		// Stream sample position at the start of the block
+		double streamPosition;
+		// Stream samples per output sample
+		double sampleStep;
+		// Value of m_positionGeneration when the block was rendered
+		uint32 generation;
+	};
 
-	Audio* m_audio;
+protected:
+	Audio* m_audio = nullptr;
+	String m_path;
 	File m_file;
 	Buffer m_data;
 	MemoryReader m_memoryReader;
@@ -17,51 +37,93 @@ protected:
 	bool m_preloaded = false;
 	BinaryStream& Reader();
 
+	// Held by the decode thread while decoding and by the game when seeking, never taken by the mixer
 	mutex m_lock;
 
+	// Output of DecodeData_Internal, decode thread only
 	float** m_readBuffer = nullptr;
 	uint32 m_bufferSize = 4096;
 	uint32 m_numChannels = 0;
 	uint32 m_currentBufferSize = 0;
 	uint32 m_remainingBufferData = 0;
+	// Interleaved copy of the read buffer before it is resampled
+	float* m_interleaveBuffer = nullptr;
+	// Converts decoded frames to the output rate, decode thread only
+	Resampler m_resampler;
+	float* m_resampleBuffer = nullptr;
+	// Number of decoded samples to throw away after a seek that landed before the requested position
+	int64 m_decodeSkip = 0;
+	// Stream position of the next frame written to m_decodedData
+	int64 m_decodePosition = 0;
 
-	int64 m_samplePos = 0;
-	int64 m_samplesTotal = 0; // Total pcm length of audio stream
+	// Range that is played from decoded pcm instead of the decoder
+	Ref<PCMSegment> m_cachedSegment;
+	// Range that is being captured while decoding, added to the audio cache when complete
+	Ref<PCMSegment> m_capture;
+	uint32 m_captureFrames = 0;
+
+	// Decoded interleaved stereo frames at the output rate, written by the decode thread and read by the mixer
+	RingBuffer<float> m_decodedData;
+	// Set by the decode thread after the last frame was written
+	std::atomic<bool> m_decodeEnded = { false };
 
-	// Resampling values
-	uint64 m_sampleStep = 0;
-	uint64 m_sampleStepIncrement = 0;
+	// Seek requests from the game, the mixer discards m_decodedData and acknowledges them
+	//	the decode thread doesn't write new data until the current request is acknowledged
+	std::atomic<uint32> m_seekRequest = { 0 };
+	std::atomic<uint32> m_seekAcknowledged = { 0 };
+	std::atomic<int64> m_seekPosition = { 0 };
 
-	Timer m_deltaTimer;
-	Timer m_streamTimer;
-	double m_streamTimeOffset = 0.0f;
-	double m_offsetCorrection = 0.0f;
+	// Position of the next sample that is mixed, only written by the mixer and read by the game while paused or stopped
+	std::atomic<int64> m_samplePos = { 0 };
+	int64 m_samplesTotal = 0; // Total pcm length of audio stream
+
+	// Stream position of the last seek and the number of output frames mixed since then, only used by the mixer
+	int64 m_mixStart = 0;
+	int64 m_mixedFrames = 0;
+	// Stream samples per output sample
+	double m_sampleStep = 1.0;
 
-	double m_deltaSum = 0.0f;
-	int32 m_deltaSamples = 0;
+	// Position as heard on the output, the generation is incremented on seek/pause/play so old snapshots are ignored
+	SeqLock<PositionSnapshot> m_position;
+	std::atomic<uint32> m_positionGeneration = { 0 };
 
-	bool m_paused = false;
-	bool m_playing = false;
-	bool m_ended = false;
+	// Set by the game, the mixer clears m_playing when the stream ended
+	std::atomic<bool> m_paused = { false };
+	std::atomic<bool> m_playing = { false };
+	// Set by the mixer, which can't log, the decode thread logs the end of the stream when it sees it
+	std::atomic<bool> m_ended = { false };
+	bool m_endLogged = false;
 
 	float m_volume = 0.8f;
 
 public:
+	~AudioStreamBase();
 	virtual bool Init(Audio* audio, const String& path, bool preload);
 	void InitSampling(uint32 sampleRate);
+	// Plays the given range from the audio cache, or adds it to the cache while decoding if it's not in there yet
+	//	also moves the stream to the start of the range
+	void CacheRange(int32 startTime, int32 duration);
+
+	// Decodes until the ring buffer is full or the stream ended, called from the decode thread
+	//	returns true if any data was decoded
+	bool DecodeAhead();
+	// Stops decoding and removes the stream from the mixer
+	//	implementations call this in their destructor, before their decoder state is destroyed
+	void Deregister();
 
 	virtual void Play() override;
 	virtual void Pause() override;
 	virtual bool HasEnded() const override;
 	uint64 SecondsToSamples(double s) const;
 	double SamplesToSeconds(int64 s) const;
-	double GetPositionSeconds(bool allowFreezeSkip = true) const;
+	// Position calculated from the audio clock, without latency compensation
+	double GetPositionSeconds() const;
 	virtual int32 GetPosition() const override;
 	virtual void SetPosition(int32 pos) override;
-	void RestartTiming();
 	virtual void Process(float* out, uint32 numSamples) override;
 
 	// Implementation specific set position
+	//	may seek to a position before <pos> (e.g. the start of a frame), the difference is skipped while decoding
 	virtual void SetPosition_Internal(int32 pos) = 0;
 	virtual int32 GetStreamPosition_Internal() = 0;
 	// Internal sample rate
@@ -69,4 +131,9 @@ public:
 	// Implementation specific decode
 	// return negative for end of stream or failure
 	virtual int32 DecodeData_Internal() = 0;
+
+protected:
+	// Decode thread only
+	void m_CaptureFrames(const float* data, uint32 numFrames);
+	void m_FinishCapture();
 };
\ No newline at end of file
@@ -1,16 +1,60 @@
 #pragma once
 #include "AudioOutput.hpp"
 #include "AudioBase.hpp"
+#include "AudioCache.hpp"
+#include "VoicePool.hpp"
+#include "AudioStats.hpp"
+#include <Shared/RingBuffer.hpp>
+#include <Shared/SeqLock.hpp>
+#include <Shared/Thread.hpp>
 
 // Threading
 #include <thread>
 #include <mutex>
+#include <atomic>
 using std::thread;
 using std::mutex;
 
+/*
+	Change to the set of rendered items or their DSP's
+	these are queued by the game and applied by the mixer at the start of a block
+*/
+struct AudioCommand
+{
+	enum Type : uint8
+	{
+		Register,
+		Deregister,
+		AddDSP,
+		RemoveDSP,
+		PlaySample,
+		StopSample,
+	};
+	Type type;
+	AudioBase* item;
+	DSP* dsp;
+	// Sequence number used to wait for the mixer to apply this command
+	uint64 id;
+};
+
+/*
+	Position of the output published by the mixer at the start of every device callback
+*/
+struct AudioClockState
+{
+	// Number of samples handed to the device before this callback
+	int64 samplePosition;
+	// Number of samples handed to the device in this callback
+	int64 numSamples;
+	// Time the callback started, see Audio_Impl::GetClockTime
+	int64 timestamp;
+	int64 sampleRate;
+};
+
 class Audio_Impl : public IMixer
 {
 public:
+	Audio_Impl();
 	void Start();
 	void Stop();
 	// Get samples
@@ -18,16 +62,47 @@ public:
 	// Registers an AudioBase to be rendered
 	void Register(AudioBase* audio);
 	// Removes an AudioBase so it is no longer rendered
+	//	after this returns the mixer will no longer access the object
 	void Deregister(AudioBase* audio);
+	// Adds or removes a DSP from an item's processing chain
+	//	after RemoveDSP returns the mixer will no longer access the DSP
+	void AddDSP(AudioBase* audio, DSP* dsp);
+	void RemoveDSP(AudioBase* audio, DSP* dsp);
+	// Starts a new voice for a sample or stops all of it's voices, these don't wait for the mixer
+	void PlaySample(class SampleRes* sample);
+	void StopSample(class SampleRes* sample);
+	// Adds or removes a stream from the decode thread
+	//	RegisterStream decodes the first part of the stream on the calling thread
+	//	after DeregisterStream returns the decode thread will no longer access the stream
+	void RegisterStream(class AudioStreamBase* stream);
+	void DeregisterStream(class AudioStreamBase* stream);
 
 	uint32 GetSampleRate() const;
 	double GetSecondsPerSample() const;
 
+	// Output sample index that is being handed to the device right now, interpolated between callbacks
+	//	can be called from any thread
+	double GetOutputPosition() const;
+	// Output sample index of the first sample in the block that is currently being rendered
+	//	only valid inside AudioBase::Process
+	int64 GetBlockOutputPosition() const;
+	// Number of threads that render items next to the mixer
+	uint32 GetNumMixWorkers() const;
+	// Number of blocks where DSP's were skipped because rendering the items took too long
+	uint64 GetNumBypassedBlocks() const;
+	// Monotonic time in nanoseconds used for the audio clock
+	static int64 GetClockTime();
+
 	float globalVolume = 1.0f;
+	// Meet the mix deadline when rendering offline as well, used by tests
+	bool enforceMixDeadline = false;
 
-	mutex lock;
+	// Only accessed by the mixer, changed through the command queue
 	Vector<AudioBase*> itemsToRender;
 	Vector<DSP*> globalDSPs;
+	VoicePool voices;
+	// Timing of the callbacks
+	AudioStats stats;
 
 	class LimiterDSP* limiter = nullptr;
 
@@ -36,7 +111,98 @@ public:
 	uint32 m_sampleBufferLength = 384;
 	uint32 m_remainingSamples = 0;
 
+	// Scratch buffers for sample voices
+	float* m_itemBuffer = nullptr;
+	float* m_voiceBuffer = nullptr;
+	// Every item in itemsToRender is rendered into it's own slot, so they can be rendered in parallel and summed in order
+	float* m_itemBuffers = nullptr;
+	uint32 m_itemBufferStride = 0;
+
+	// Device latency plus the time samples spend waiting in the mixer's sample buffer, in seconds
+	double outputLatency = 0.0;
+	// Subtract outputLatency from stream positions
+	bool compensateLatency = false;
+
+	// Maximum number of items that can be rendered at the same time
+	static const uint32 maxItemsToRender = 256;
+	// Maximum number of threads that render items next to the mixer
+	static const uint32 maxMixWorkers = 3;
+	// Part of a block's duration that rendering the items may take, items started after that skip their DSP's
+	static constexpr double mixDeadline = 0.75;
+	// Part of a block's duration after which the mixer stops waiting for the mix workers, items they didn't finish are dropped
+	static constexpr double mixTimeout = 0.9;
+
+	// Decoded pcm of previews and chart intros
+	AudioCache cache;
+
 	thread audioThread;
-	bool runAudioThread = false;
-	AudioOutput* output = nullptr;
-};
\ No newline at end of file
+	std::atomic<bool> runAudioThread = { false };
+	IAudioOutput* output = nullptr;
+
+private:
+	// Queues a command for the mixer and returns it's sequence number
+	uint64 m_QueueCommand(AudioCommand::Type type, AudioBase* item, DSP* dsp = nullptr);
+	// Blocks the calling (game) thread until the mixer has applied the given command
+	void m_WaitForCommand(uint64 id);
+	// Applies all pending commands, called by whoever currently owns the render lists
+	void m_ProcessCommands();
+	void m_ProcessCommandsExclusive();
+	// Keeps the ring buffers of all streams filled
+	void m_DecodeThread();
+	// Fills the ring buffers of all streams once, returns true if anything was decoded
+	bool m_DecodeStreams();
+	// Renders all items of the current block into their slots, using the mix workers when there is more than one item
+	void m_RenderItems();
+	// Renders items of the current block until there are none left to claim, called by the mixer and the mix workers
+	void m_ClaimItems();
+	void m_RenderItem(uint32 index);
+	// Waits for mix workers that are still rendering items the mixer dropped, before the items can be rendered again or removed
+	void m_WaitForMixWorkers();
+	void m_MixWorker();
+
+	// Commands from the game to the mixer
+	RingBuffer<AudioCommand> m_commands;
+	// Serializes writes to the command queue when multiple game threads are involved, never taken by the mixer
+	mutex m_commandLock;
+	uint64 m_nextCommandId = 1;
+	std::atomic<uint64> m_processedCommandId = { 0 };
+
+	// Set while the render lists are being used, either by the mixer or by a game thread processing commands for a stalled mixer
+	std::atomic_flag m_renderLock = ATOMIC_FLAG_INIT;
+
+	// Total number of mixed samples handed to the device, mixer only
+	int64 m_outputSamples = 0;
+	int64 m_blockOutputPosition = 0;
+	SeqLock<AudioClockState> m_clock;
+
+	// Threads that help rendering items every block
+	Vector<thread> m_mixWorkers;
+	std::atomic<bool> m_runMixWorkers = { false };
+	// Posted once per worker every block by the mixer, which never takes a lock to wake them
+	Semaphore m_mixWorkerSignal;
+	// Items of the current block, the number of items in bits 16-31 and the next item to claim in bits 0-15
+	//	packed so a worker that wakes up late never sees a count and index from different blocks
+	std::atomic<uint64> m_mixWork = { 0 };
+	std::atomic<uint32> m_mixItemsDone = { 0 };
+	uint32 m_mixItemsStarted = 0;
+	// State of every item of the current block, only the slots of finished items are mixed
+	//	an item is either finished by the thread rendering it or dropped by the mixer when it times out, never both
+	enum ItemState : uint8
+	{
+		ItemPending = 0,
+		ItemDone,
+		ItemDropped,
+	};
+	std::atomic<uint8> m_itemStates[maxItemsToRender] = {};
+	// Clock time after which items skip their DSP's, 0 for no deadline
+	int64 m_mixDeadlineTime = 0;
+	// Clock time after which the mixer stops waiting for the mix workers, 0 for no timeout
+	int64 m_mixTimeoutTime = 0;
+	std::atomic<bool> m_bypassDSPs = { false };
+
+	// Streams are decoded on this thread so the mixer never has to wait for a decoder
+	thread m_decodeThread;
+	std::atomic<bool> m_runDecodeThread = { false };
+	mutex m_decodeLock;
+	Vector<class AudioStreamBase*> m_decodeStreams;
+};
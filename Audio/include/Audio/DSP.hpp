@@ -3,7 +3,48 @@
 */
 #pragma once
 #include "AudioBase.hpp"
+#include "AudioKernels.hpp"
 #include <Shared/Interpolation.hpp>
+#include <Shared/SeqLock.hpp>
+
+/*
+	Circular buffer of interleaved stereo frames with a power of two size, so positions wrap with a mask
+	the size is only changed by Init, changing the delay of an effect while it plays never allocates
+*/
+class DelayLine
+{
+public:
+	// Makes room for a delay of at least <maxDelay> frames, cleared to silence
+	void Init(uint32 maxDelay);
+	// Clears the frames that were written since the last clear
+	void Clear();
+
+	void Write(float left, float right)
+	{
+		float* frame = m_data.data() + m_position * 2;
+		frame[0] = left;
+		frame[1] = right;
+		m_position = (m_position + 1) & m_mask;
+		if(m_written <= m_mask)
+			m_written++;
+	}
+	// Frame written <delay> frames before the last written frame, 0 is the last written frame
+	const float* Read(uint32 delay) const
+	{
+		return m_data.data() + ((m_position - 1 - delay) & m_mask) * 2;
+	}
+	uint32 GetMaxDelay() const
+	{
+		return m_mask;
+	}
+
+private:
+	Vector<float> m_data;
+	uint32 m_mask = 0;
+	uint32 m_position = 0;
+	// Number of frames that need to be cleared
+	uint32 m_written = 0;
+};
 
 class PanDSP : public DSP
 {
@@ -16,19 +57,15 @@ public:
 // Biquad Filter
 // Thanks to https://www.youtube.com/watch?v=FnpkBE4kJ6Q&list=WL&index=8 for the explanation
 // Also http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt for the coefficient formulas
+//	parameter changes are applied smoothly over the next processed block
+//	coefficients are looked up in a per-thread table keyed on the quantized parameters, so sweeps don't recalculate them every call
 class BQFDSP : public DSP
 {
 public:
-	float b0 = 1.0f;
-	float b1 = 0.0f;
-	float b2 = 0.0f;
-	float a0 = 1.0f;
-	float a1 = 0.0f;
-	float a2 = 0.0f;
-
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 
-	// Sets the filter parameters
+	// Sets the filter parameters, can be called from any single thread while the filter is being processed
 	void SetPeaking(float q, float freq, float gain);
 	void SetLowPass(float q, float freq);
 	void SetHighPass(float q, float freq);
@@ -36,13 +73,17 @@ public:
 	void SetPeaking(float q, float freq, float gain, float sampleRate);
 	void SetLowPass(float q, float freq, float sampleRate);
 	void SetHighPass(float q, float freq, float sampleRate);
+
+	// Coefficients that are being moved towards
+	AudioKernels::BiquadCoefficients GetCoefficients() const;
+
 private:
-	// Delayed samples
-	static const uint32 order = 2;
-	// FIR Delay buffers
-	float zb[2][order];
-	// IIR Delay buffers
-	float za[2][order];
+	// Written by the Set functions, read once per block by Process
+	SeqLock<AudioKernels::BiquadCoefficients> m_target;
+	// Coefficients at the end of the last processed block
+	AudioKernels::BiquadCoefficients m_current;
+	bool m_started = false;
+	AudioKernels::BiquadState m_state;
 };
 
 // Combinded Low/High-pass and Peaking filter
@@ -53,20 +94,51 @@ public:
 	void SetHighPass(float q, float freq, float peakQ, float peakGain);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 private:
 	BQFDSP a;
 	BQFDSP peak;
 };
 
-// Basic limiter
+/*
+	Lookahead peak limiter for the master output
+	The output is delayed by <lookahead> frames, so the gain is already lowered when a peak is played instead of clipping it
+	The gain is set once per sub block of <blockFrames> from the peak of that block and the next one, and ramps linearly in between
+*/
 class LimiterDSP : public DSP
 {
 public:
+	// Frames per gain step
+	static const uint32 blockFrames = 32;
+	// Delay added to the output in frames
+	static const uint32 lookahead = blockFrames * 2;
+
+	// Highest output level
+	float ceiling = 0.9f;
+	// Seconds to recover most of the gain reduction after a peak
 	float releaseTime = 0.1f;
+
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
+	virtual uint32 GetLatency() const override;
+
+	// Levels of the last processed output, can be read from any thread
+	AudioMeter GetMeter() const;
+
 private:
-	float m_currentMaxVolume = 1.0f;
-	float m_currentReleaseTimer = releaseTime;
+	// Applies the gain ramp to the block that is about to be played once the block after it is known
+	void m_FinishBlock();
+
+	// Ring of sub blocks: one being written, one waiting for the peak of the next one and one being played
+	float m_blocks[3][blockFrames * 2] = {};
+	uint32 m_writeBlock = 0;
+	uint32 m_position = 0;
+	// Highest gain that doesn't clip the block waiting for it's ramp
+	float m_waitingGain = 1.0f;
+	float m_gain = 1.0f;
+	float m_releaseCoefficient = 0.0f;
+
+	SeqLock<AudioMeter> m_meter;
 };
 
 class BitCrusherDSP : public DSP
@@ -75,6 +147,7 @@ public:
 	// Duration of samples, <1 = disable
 	void SetPeriod(float period = 0);
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 private:
 	uint32 m_period = 1;
 	uint32 m_increment = 0;
@@ -93,6 +166,7 @@ public:
 	float low = 0.1f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 private:
 	float m_gating = 0.75f;
 	uint32 m_length = 0;
@@ -105,35 +179,48 @@ private:
 class TapeStopDSP : public DSP
 {
 public:
+	// Longest stop in milliseconds
+	static const uint32 maxLength = 8000;
+
+	// Duration of the stop in milliseconds
 	void SetLength(uint32 length);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Prepare(uint32 sampleRate) override;
+	virtual void Reset() override;
 private:
 	uint32 m_length = 0;
-	Vector<float> m_sampleBuffer;
+	// Playback falls behind the input by at most half the length of the stop
+	DelayLine m_delay;
 	float m_sampleIdx = 0.0f;
-	uint32 m_lastSample = 0;
 	uint32 m_currentSample = 0;
 };
 
 class RetriggerDSP : public DSP
 {
 public:
+	// Longest loop in milliseconds
+	static const uint32 maxLength = 4000;
+
+	// Length of the repeated part in milliseconds
 	void SetLength(uint32 length);
 	void SetResetDuration(uint32 resetDuration);
 	void SetGating(float gating);
-	void SetMaxLength(uint32 length);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Prepare(uint32 sampleRate) override;
+	virtual void Reset() override;
 private:
 	float m_gating = 0.75f;
 	uint32 m_length = 0;
 	uint32 m_gateLength = 0;
 	uint32 m_resetDuration = 0;
+	// Loop buffer of interleaved frames, sized for maxLength
 	Vector<float> m_sampleBuffer;
+	// Frames recorded into the buffer since the last reset
+	uint32 m_recorded = 0;
 	uint32 m_loops = 0;
 	uint32 m_currentSample = 0;
-	bool m_bufferReserved = false;
 };
 
 class WobbleDSP : public BQFDSP
@@ -147,6 +234,7 @@ public:
 	float q = 1.414f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 private:
 	uint32 m_length;
 	uint32 m_currentSample = 0;
@@ -167,6 +255,7 @@ public:
 	void SetLength(uint32 length);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 
 private:
 	uint32 m_length = 0;
@@ -186,10 +275,16 @@ private:
 class FlangerDSP : public DSP
 {
 public:
+	// Longest delay in samples at 44100Hz
+	static const uint32 maxDelay = 512;
+
 	void SetLength(uint32 length);
+	// Delay range in samples at 44100Hz
 	void SetDelayRange(uint32 min, uint32 max);
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Prepare(uint32 sampleRate) override;
+	virtual void Reset() override;
 private:
 	uint32 m_length = 0;
 
@@ -197,25 +292,29 @@ private:
 	uint32 m_min = 0;
 	uint32 m_max = 0;
 
-	Vector<float> m_sampleBuffer;
+	DelayLine m_delay;
 	uint32 m_time = 0;
-	uint32 m_bufferLength = 0;
-	size_t m_bufferOffset = 0;
 };
 
 class EchoDSP : public DSP
 {
 public:
+	// Longest delay in milliseconds
+	static const uint32 maxLength = 4000;
+
+	// Delay in milliseconds
 	void SetLength(uint32 length);
 
 	float feedback = 0.6f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Prepare(uint32 sampleRate) override;
+	virtual void Reset() override;
 private:
-	uint32 m_bufferLength = 0;
-	size_t m_bufferOffset = 0;
+	uint32 m_length = 0;
+	uint32 m_position = 0;
 	uint32 m_numLoops = 0;
-	Vector<float> m_sampleBuffer;
+	DelayLine m_delay;
 };
 
 
@@ -231,21 +330,34 @@ public:
 	Interpolation::CubicBezier curve;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Reset() override;
 private:
 	uint32 m_length = 0;
 	size_t m_time = 0;
 };
 
+/*
+	Pitch shifter that plays back a short delay line at a different speed than it is written
+	Two read positions half a window apart are crossfaded, each one is faded out when it wraps around to the other end of the window
+	The shifted signal is delayed by half a window on average, see GetLatency
+*/
 class PitchShiftDSP : public DSP
 {
 public:
-	// Pitch change amount
-	float amount = 0.0f;
+	// Window length in milliseconds, longer windows sound smoother on low notes but add latency
+	static const uint32 windowLength = 25;
 
-	PitchShiftDSP();
-	~PitchShiftDSP();
+	// Pitch change in semitones
+	float amount = 0.0f;
 
 	virtual void Process(float* out, uint32 numSamples);
+	virtual void Prepare(uint32 sampleRate) override;
+	virtual void Reset() override;
+	virtual uint32 GetLatency() const override;
 private:
-	class PitchShiftDSP_Impl* m_impl;
+	DelayLine m_delay;
+	// Window length in frames
+	uint32 m_window = 0;
+	// Position of the first read position in the window [0,1), the second one is half a window further
+	float m_phase = 0.0f;
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "AudioBase.hpp"
+#include <typeindex>
+
+/*
+	Keeps removed DSP's around so they can be used again, instead of creating and deleting them every time an effect is activated
+	Instances are prepared when they are reserved, so taking one from the pool doesn't allocate
+	Only used from the game thread
+*/
+class DSPPool : Unique
+{
+public:
+	~DSPPool();
+
+	// Creates <count> instances of T prepared for <sampleRate>
+	template<typename T>
+	void Reserve(uint32 count, uint32 sampleRate)
+	{
+		Vector<DSP*>& free = m_free[std::type_index(typeid(T))];
+		for(uint32 i = 0; i < count; i++)
+		{
+			DSP* dsp = new T();
+			dsp->Prepare(sampleRate);
+			free.Add(dsp);
+		}
+	}
+	// Takes an instance of T from the pool, a new one is created when none are left
+	template<typename T>
+	T* Acquire()
+	{
+		Vector<DSP*>* free = m_free.Find(std::type_index(typeid(T)));
+		if(!free || free->empty())
+			return new T();
+		DSP* dsp = free->back();
+		free->pop_back();
+		return static_cast<T*>(dsp);
+	}
+	// Returns an instance to the pool, it should be removed from it's audio first
+	void Release(DSP* dsp);
+
+	// Number of instances of T that are ready to be used
+	template<typename T>
+	uint32 GetNumFree() const
+	{
+		const Vector<DSP*>* free = m_free.Find(std::type_index(typeid(T)));
+		return free ? (uint32)free->size() : 0;
+	}
+
+private:
+	Map<std::type_index, Vector<DSP*>> m_free;
+};
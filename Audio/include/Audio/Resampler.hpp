@@ -0,0 +1,68 @@
+#pragma once
+
+/*
+	Windowed sinc resampler for interleaved stereo
+	Every output frame is filtered from numTaps input frames, using a table of filters for the positions between two input frames
+	The table is calculated once in Init, positions are tracked as an exact fraction so long streams don't drift
+*/
+class Resampler
+{
+public:
+	// Number of input frames used for every output frame
+	static const uint32 numTaps = 32;
+	// Limit on the size of the filter table, ratios that need more phases use the nearest one
+	static const uint32 maxPhases = 1024;
+
+	void Init(uint32 inputRate, uint32 outputRate);
+	// Clears buffered input
+	//	the first <historyFrames> input frames after this are only used to filter the frames after them, see GetMaxHistory
+	void Reset(uint32 historyFrames = 0);
+	// Converts input frames to output frames until either the output is full or all input is used
+	//	<inputUsed> is set to the number of input frames that were used, the rest should be passed again in the next call
+	//	returns the number of output frames written
+	uint32 Process(float* out, uint32 maxOutputFrames, const float* in, uint32 numInputFrames, uint32& inputUsed);
+
+	// Input and output rate are the same, the input is copied without filtering
+	bool IsPassthrough() const
+	{
+		return m_inputRate == m_outputRate;
+	}
+	// Number of input frames before the first output frame that affect it
+	//	passing these after a reset prevents a fade in from silence when starting in the middle of a stream
+	uint32 GetMaxHistory() const
+	{
+		return IsPassthrough() ? 0 : numTaps / 2 - 1;
+	}
+	// Input frames per output frame
+	double GetRatio() const
+	{
+		return (double)m_inputRate / (double)m_outputRate;
+	}
+	uint32 GetInputRate() const
+	{
+		return m_inputRate;
+	}
+	uint32 GetOutputRate() const
+	{
+		return m_outputRate;
+	}
+
+private:
+	void m_BuildFilters();
+
+	uint32 m_inputRate = 0;
+	uint32 m_outputRate = 0;
+	// Every output frame advances the input position by m_step / m_denominator frames
+	uint32 m_step = 1;
+	uint32 m_denominator = 1;
+	uint32 m_numPhases = 1;
+	// numPhases filters of numTaps coefficients, every coefficient is stored twice so they line up with interleaved stereo
+	Vector<float> m_filters;
+
+	// Buffered interleaved input frames
+	Vector<float> m_input;
+	uint32 m_inputFrames = 0;
+	// Position of the next output frame, the first input frame used is m_input[m_index]
+	uint32 m_index = 0;
+	uint32 m_fraction = 0;
+};
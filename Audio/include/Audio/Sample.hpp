@@ -3,6 +3,8 @@
 
 /*
 	Audio sample, only supports wav files in signed 16 bit stereo or mono
+	The data is converted to stereo at the output rate when loading and doesn't change after that
+	Playback happens on voices from the mixer's voice pool, a sample is never in the mixer's list of items itself
 */
 class SampleRes : public AudioBase
 {
@@ -10,13 +12,21 @@ public:
 	static Ref<SampleRes> Create(class Audio* audio, const String& path);
 	virtual ~SampleRes() = default;
 
+	// Samples are rendered by the voice pool
+	virtual void Process(float* out, uint32 numSamples) override
+	{
+	}
+
 public:
-	virtual const Buffer& GetData() const = 0;
+	// Interleaved 16 bit stereo at the output rate
+	virtual const Vector<int16>& GetData() const = 0;
 	virtual uint32 GetBitsPerSample() const = 0;
 	virtual uint32 GetNumChannels() const = 0;
 
-	// Plays this sample from the start
+	// Plays this sample from the start, earlier playback that hasn't ended yet keeps playing
 	virtual void Play() = 0;
+	// Stops all playback of this sample
+	virtual void Stop() = 0;
 };
 
-typedef Ref<SampleRes> Sample;
\ No newline at end of file
+typedef Ref<SampleRes> Sample;
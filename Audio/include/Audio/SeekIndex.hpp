@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+	Sorted table of sample positions and the byte offsets they start at in a compressed audio file
+	Allows streams to seek without scanning or decoding from the start of the file
+	Indices are cached on disk, validated against the size and write time of the audio file
+*/
+class SeekIndex
+{
+public:
+	struct Entry
+	{
+		int64 sample;
+		uint64 offset;
+	};
+
+	void Clear();
+	// Adds an entry, entries need to be added in increasing sample order
+	void Add(int64 sample, uint64 offset);
+	// Finds the last entry that starts at or before <sample>
+	//	returns the index of the entry or -1 if there is none
+	int32 Find(int64 sample) const;
+
+	const Entry& operator[](size_t index) const
+	{
+		return m_entries[index];
+	}
+	size_t GetSize() const
+	{
+		return m_entries.size();
+	}
+	bool IsEmpty() const
+	{
+		return m_entries.empty();
+	}
+
+	// Total length of the audio in samples
+	int64 samplesTotal = 0;
+
+	// Loads the cached index for an audio file, fails if there is none or the file changed since it was saved
+	bool Load(const String& sourcePath);
+	bool Save(const String& sourcePath) const;
+
+	// Folder the indices are stored in, relative to the working directory (next to the map database)
+	static String cacheFolder;
+
+private:
+	static String m_GetCachePath(const String& sourcePath);
+
+	Vector<Entry> m_entries;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+	Fixed set of voices that play samples, owned by the mixer
+	Every call to SampleRes::Play starts a new voice, so a sample that is triggered again before it ended plays on top of itself
+	Only active voices are kept in the front of the array, an idle pool costs nothing to mix
+*/
+class VoicePool
+{
+public:
+	// Total number of samples that can play at the same time
+	static const uint32 maxVoices = 64;
+	// Number of overlapping voices of a single sample
+	static const uint32 maxVoicesPerSample = 8;
+
+	// Starts a new voice for a sample
+	//	when the sample already has maxVoicesPerSample voices it's oldest voice is restarted
+	//	when the pool is full the voice that is closest to ending is taken over
+	void Play(class SampleRes* sample);
+	// Stops all voices of a sample
+	void Stop(const class AudioBase* sample);
+	void StopAll();
+	// Adds all active voices to <out>
+	//	the voices of each sample are summed into <scratch> to run the sample's DSP's once over all of them
+	//	<scratch> and <voiceBuffer> need room for <numSamples> stereo samples
+	void Mix(float* out, float* scratch, float* voiceBuffer, uint32 numSamples);
+
+	uint32 GetNumActive() const
+	{
+		return m_numActive;
+	}
+	uint32 GetNumActive(const class AudioBase* sample) const;
+
+private:
+	struct Voice
+	{
+		SampleRes* sample;
+		// Cached from the sample, it's data doesn't change while it can be played
+		const int16* pcm;
+		uint32 numFrames;
+		uint32 position;
+		uint64 startIndex;
+	};
+
+	void m_Remove(uint32 index);
+
+	// Active voices are [0, m_numActive)
+	Voice m_voices[maxVoices];
+	uint32 m_numActive = 0;
+	uint64 m_nextStartIndex = 0;
+};
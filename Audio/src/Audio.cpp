@@ -1,29 +1,58 @@
 #include "stdafx.h"
 #include "Audio.hpp"
 #include "AudioStream.hpp"
+#include "AudioStreamBase.hpp"
 #include "Audio_Impl.hpp"
 #include "AudioOutput.hpp"
 #include "DSP.hpp"
+#include "AudioKernels.hpp"
+#include "Sample.hpp"
+#include <Shared/Thread.hpp>
 
 Audio* g_audio = nullptr;
 Audio_Impl impl;
 
-void Audio_Impl::Mix(float* data, uint32& numSamples)
-{
 #if _DEBUG
-	static const uint32 guardBand = 1024;
+static const uint32 guardBand = 1024;
 #else
-	static const uint32 guardBand = 0;
+static const uint32 guardBand = 0;
 #endif
 
-	// Per-Channel data buffer
-	float* tempData = new float[m_sampleBufferLength * 2 + guardBand];
-	uint32* guardBuffer = (uint32*)tempData + 2 * m_sampleBufferLength;
-	double adv = GetSecondsPerSample();
-
+Audio_Impl::Audio_Impl()
+{
+	m_commands.Init(512);
+	itemsToRender.reserve(maxItemsToRender);
+}
+void Audio_Impl::Mix(float* data, uint32& numSamples)
+{
 	uint32 outputChannels = this->output->GetNumChannels();
 	memset(data, 0, numSamples * sizeof(float) * outputChannels);
 
+	// A game thread is applying commands for a stalled mixer, output silence instead of waiting for it
+	if(m_renderLock.test_and_set(std::memory_order_acquire))
+	{
+		stats.AddDroppedCallback();
+		return;
+	}
+
+	AudioCallbackTiming timing;
+	timing.start = GetClockTime();
+
+	// Publish the output position before rendering, so readers can interpolate over the duration of this callback
+	AudioClockState clock;
+	clock.samplePosition = m_outputSamples;
+	clock.numSamples = numSamples;
+	clock.timestamp = timing.start;
+	clock.sampleRate = output->GetSampleRate();
+	m_clock.Store(clock);
+
+	// Apply changes made by the game since the last callback
+	m_ProcessCommands();
+
+	// Offline outputs have no decode thread, decode here so the result doesn't depend on timing
+	if(!output->IsRealtime())
+		m_DecodeStreams();
+
 	uint32 currentNumberOfSamples = 0;
 	while(currentNumberOfSamples < numSamples)
 	{
@@ -32,51 +61,39 @@ void Audio_Impl::Mix(float* data, uint32& numSamples)
 		{
 			// Clear sample buffer storing a fixed amount of samples
 			memset(m_sampleBuffer, 0, sizeof(float) * 2 * m_sampleBufferLength);
+			m_blockOutputPosition = m_outputSamples + currentNumberOfSamples;
 
-			// Render items
-			lock.lock();
-			for(auto& item : itemsToRender)
+			// Render items, then mix them into the buffer in list order so the result doesn't depend on which thread finished first
+			int64 start = GetClockTime();
+			m_RenderItems();
+			for(uint32 i = 0; i < itemsToRender.size(); i++)
 			{
-				// Clearn per-channel data (and guard buffer in debug mode)
-				memset(tempData, 0, sizeof(float) * (2 * m_sampleBufferLength + guardBand));
-				item->Process(tempData, m_sampleBufferLength);
-#if _DEBUG
-				// Check for memory corruption
-				for(uint32 i = 0; i < guardBand; i++)
-				{
-					assert(guardBuffer[i] == 0);
-				}
-#endif
-				item->ProcessDSPs(tempData, m_sampleBufferLength);
-#if _DEBUG
-				// Check for memory corruption
-				for(uint32 i = 0; i < guardBand; i++)
-				{
-					assert(guardBuffer[i] == 0);
-				}
-#endif
-
-				// Mix into buffer and apply volume scaling
-				for(uint32 i = 0; i < m_sampleBufferLength; i++)
-				{
-					m_sampleBuffer[i * 2 + 0] += tempData[i * 2] * item->GetVolume();
-					m_sampleBuffer[i * 2 + 1] += tempData[i * 2 + 1] * item->GetVolume();
-				}
+				if(m_itemStates[i].load(std::memory_order_acquire) != ItemDone)
+					continue;
+				AudioKernels::MixAdd(m_sampleBuffer, m_itemBuffers + i * m_itemBufferStride, itemsToRender[i]->GetVolume(), 2 * m_sampleBufferLength);
 			}
+			int64 end = GetClockTime();
+			timing.itemTime += (uint32)(end - start);
+			timing.numItems = (uint32)itemsToRender.size();
+
+			// Render samples
+			start = end;
+			voices.Mix(m_sampleBuffer, m_itemBuffer, m_voiceBuffer, m_sampleBufferLength);
+			end = GetClockTime();
+			timing.voiceTime += (uint32)(end - start);
 
 			// Process global DSPs
 			for(auto dsp : globalDSPs)
 			{
+				start = end;
 				dsp->Process(m_sampleBuffer, m_sampleBufferLength);
+				end = GetClockTime();
+				dsp->m_processTime.store((uint32)(end - start), std::memory_order_relaxed);
+				timing.globalDSPTime += (uint32)(end - start);
 			}
-			lock.unlock();
 
 			// Apply volume levels
-			for(uint32 i = 0; i < m_sampleBufferLength; i++)
-			{
-				m_sampleBuffer[i * 2 + 0] *= globalVolume;
-				m_sampleBuffer[i * 2 + 1] *= globalVolume;
-			}
+			AudioKernels::Scale(m_sampleBuffer, globalVolume, 2 * m_sampleBufferLength);
 
 			// Set new remaining buffer data
 			m_remainingSamples = m_sampleBufferLength;
@@ -85,55 +102,394 @@ void Audio_Impl::Mix(float* data, uint32& numSamples)
 		// Copy samples from sample buffer
 		uint32 sampleOffset = m_sampleBufferLength - m_remainingSamples;
 		uint32 maxSamples = Math::Min(numSamples - currentNumberOfSamples, m_remainingSamples);
-		for(uint32 c = 0; c < outputChannels; c++)
-		{
-			if(c < 2)
-			{
-				for(uint32 i = 0; i < maxSamples; i++)
-				{
-					data[(currentNumberOfSamples + i) * outputChannels + c] = m_sampleBuffer[(sampleOffset + i) * 2 + c];
-				}
-			}
-			// TODO: Mix to surround channels as well?
-		}
+		// TODO: Mix to surround channels as well?
+		AudioKernels::CopyToChannels(data + currentNumberOfSamples * outputChannels, outputChannels, m_sampleBuffer + sampleOffset * 2, maxSamples);
 		m_remainingSamples -= maxSamples;
 		currentNumberOfSamples += maxSamples;
 	}
+	m_outputSamples += numSamples;
 
-	delete[] tempData;
+	m_renderLock.clear(std::memory_order_release);
+
+	timing.duration = (uint32)(GetClockTime() - timing.start);
+	timing.budget = (uint32)((uint64)numSamples * 1000000000 / clock.sampleRate);
+	stats.AddCallback(timing, output->IsRealtime());
 }
 void Audio_Impl::Start()
 {
 	m_sampleBuffer = new float[2 * m_sampleBufferLength];
+	m_itemBuffer = new float[2 * m_sampleBufferLength + guardBand];
+	m_voiceBuffer = new float[2 * m_sampleBufferLength];
+	m_itemBufferStride = 2 * m_sampleBufferLength + guardBand;
+	m_itemBuffers = new float[maxItemsToRender * m_itemBufferStride];
+	m_remainingSamples = 0;
+	m_outputSamples = 0;
 
 	limiter = new LimiterDSP();
 	limiter->audio = this;
 	limiter->releaseTime = 0.2f;
 	globalDSPs.Add(limiter);
+
+	// Leave a core for the game and one for the mixer
+	uint32 numCores = std::thread::hardware_concurrency();
+	uint32 numWorkers = Math::Min(numCores > 2 ? numCores - 2 : 0, maxMixWorkers);
+	m_runMixWorkers = true;
+	for(uint32 i = 0; i < numWorkers; i++)
+	{
+		m_mixWorkers.emplace_back(&Audio_Impl::m_MixWorker, this);
+	}
+
+	// Without a device the mixer only runs when asked to, commands are applied right away and streams are decoded by the mixer
+	if(output->IsRealtime())
+	{
+		m_runDecodeThread = true;
+		m_decodeThread = thread(&Audio_Impl::m_DecodeThread, this);
+		runAudioThread = true;
+	}
 	output->Start(this);
 }
 void Audio_Impl::Stop()
 {
 	output->Stop();
-	delete limiter;
+	runAudioThread = false;
+
+	m_runDecodeThread = false;
+	if(m_decodeThread.joinable())
+		m_decodeThread.join();
+
+	m_runMixWorkers = false;
+	m_mixWorkerSignal.Post((uint32)m_mixWorkers.size());
+	for(auto& worker : m_mixWorkers)
+		worker.join();
+	m_mixWorkers.clear();
+
+	// Apply whatever the mixer didn't get to
+	m_ProcessCommandsExclusive();
+
 	globalDSPs.Remove(limiter);
+	delete limiter;
+	limiter = nullptr;
+
+	voices.StopAll();
+	cache.Clear();
 
 	delete[] m_sampleBuffer;
 	m_sampleBuffer = nullptr;
+	delete[] m_itemBuffer;
+	m_itemBuffer = nullptr;
+	delete[] m_voiceBuffer;
+	m_voiceBuffer = nullptr;
+	delete[] m_itemBuffers;
+	m_itemBuffers = nullptr;
 }
 void Audio_Impl::Register(AudioBase* audio)
 {
-	lock.lock();
-	itemsToRender.AddUnique(audio);
 	audio->audio = this;
-	lock.unlock();
+	m_QueueCommand(AudioCommand::Register, audio);
 }
 void Audio_Impl::Deregister(AudioBase* audio)
 {
-	lock.lock();
-	itemsToRender.Remove(audio);
+	m_WaitForCommand(m_QueueCommand(AudioCommand::Deregister, audio));
 	audio->audio = nullptr;
-	lock.unlock();
+}
+void Audio_Impl::AddDSP(AudioBase* audio, DSP* dsp)
+{
+	m_QueueCommand(AudioCommand::AddDSP, audio, dsp);
+}
+void Audio_Impl::RemoveDSP(AudioBase* audio, DSP* dsp)
+{
+	m_WaitForCommand(m_QueueCommand(AudioCommand::RemoveDSP, audio, dsp));
+}
+void Audio_Impl::PlaySample(SampleRes* sample)
+{
+	m_QueueCommand(AudioCommand::PlaySample, sample);
+}
+void Audio_Impl::StopSample(SampleRes* sample)
+{
+	m_QueueCommand(AudioCommand::StopSample, sample);
+}
+void Audio_Impl::RegisterStream(AudioStreamBase* stream)
+{
+	// Fill the buffer up front so the stream can start playing right away
+	stream->DecodeAhead();
+
+	m_decodeLock.lock();
+	m_decodeStreams.AddUnique(stream);
+	m_decodeLock.unlock();
+}
+void Audio_Impl::DeregisterStream(AudioStreamBase* stream)
+{
+	m_decodeLock.lock();
+	m_decodeStreams.Remove(stream);
+	m_decodeLock.unlock();
+}
+void Audio_Impl::m_DecodeThread()
+{
+	while(m_runDecodeThread)
+	{
+		// Every buffer is full, check again later
+		if(!m_DecodeStreams())
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+}
+void Audio_Impl::m_RenderItems()
+{
+	m_WaitForMixWorkers();
+
+	uint32 numItems = (uint32)itemsToRender.size();
+	m_bypassDSPs.store(false, std::memory_order_relaxed);
+	for(uint32 i = 0; i < numItems; i++)
+		m_itemStates[i].store(ItemPending, std::memory_order_relaxed);
+
+	// Only meet the deadline when playing to a device, offline rendering should always give the same result
+	m_mixDeadlineTime = 0;
+	m_mixTimeoutTime = 0;
+	if(output->IsRealtime() || enforceMixDeadline)
+	{
+		int64 now = GetClockTime();
+		double blockDuration = 1e9 * (double)m_sampleBufferLength / (double)GetSampleRate();
+		m_mixDeadlineTime = now + (int64)(mixDeadline * blockDuration);
+		m_mixTimeoutTime = now + (int64)(mixTimeout * blockDuration);
+	}
+
+	if(numItems <= 1 || m_mixWorkers.empty())
+	{
+		for(uint32 i = 0; i < numItems; i++)
+			m_RenderItem(i);
+		return;
+	}
+
+	m_mixItemsDone.store(0, std::memory_order_relaxed);
+	m_mixItemsStarted = numItems;
+	m_mixWork.store((uint64)numItems << 16, std::memory_order_release);
+	m_mixWorkerSignal.Post(Math::Min(numItems - 1, (uint32)m_mixWorkers.size()));
+
+	// Render on this thread as well, items claimed after the deadline skip their DSP's
+	m_ClaimItems();
+
+	// Every item is claimed now, only wait for the ones still being rendered by workers until the timeout
+	while(m_mixItemsDone.load(std::memory_order_acquire) < numItems)
+	{
+		if(m_mixTimeoutTime != 0 && GetClockTime() > m_mixTimeoutTime)
+		{
+			for(uint32 i = 0; i < numItems; i++)
+			{
+				uint8 state = ItemPending;
+				if(m_itemStates[i].compare_exchange_strong(state, ItemDropped, std::memory_order_acq_rel))
+					stats.AddDroppedItem();
+			}
+			break;
+		}
+		std::this_thread::yield();
+	}
+}
+void Audio_Impl::m_WaitForMixWorkers()
+{
+	// Only happens after an item was dropped, a whole block later the worker is usually done already
+	while(m_mixItemsDone.load(std::memory_order_acquire) < m_mixItemsStarted)
+	{
+		std::this_thread::yield();
+	}
+}
+void Audio_Impl::m_ClaimItems()
+{
+	uint64 work = m_mixWork.load(std::memory_order_acquire);
+	while(true)
+	{
+		uint32 next = (uint32)(work & 0xFFFF);
+		uint32 count = (uint32)((work >> 16) & 0xFFFF);
+		if(next >= count)
+			break;
+		if(!m_mixWork.compare_exchange_weak(work, work + 1, std::memory_order_acq_rel))
+			continue;
+
+		m_RenderItem(next);
+		m_mixItemsDone.fetch_add(1, std::memory_order_release);
+		work = m_mixWork.load(std::memory_order_acquire);
+	}
+}
+void Audio_Impl::m_RenderItem(uint32 index)
+{
+	AudioBase* item = itemsToRender[index];
+	float* data = m_itemBuffers + index * m_itemBufferStride;
+	int64 start = GetClockTime();
+
+	// Clear per-item data (and guard buffer in debug mode)
+	memset(data, 0, sizeof(float) * m_itemBufferStride);
+	item->Process(data, m_sampleBufferLength);
+#if _DEBUG
+	// Check for memory corruption
+	uint32* guardBuffer = (uint32*)data + 2 * m_sampleBufferLength;
+	for(uint32 i = 0; i < guardBand; i++)
+	{
+		assert(guardBuffer[i] == 0);
+	}
+#endif
+
+	// Past the deadline, play the item without effects rather than cause an underrun
+	if(!m_bypassDSPs.load(std::memory_order_relaxed) && m_mixDeadlineTime != 0 && GetClockTime() > m_mixDeadlineTime)
+	{
+		if(!m_bypassDSPs.exchange(true))
+			stats.AddBypassedBlock();
+	}
+	if(!m_bypassDSPs.load(std::memory_order_relaxed))
+	{
+		item->ProcessDSPs(data, m_sampleBufferLength);
+#if _DEBUG
+		// Check for memory corruption
+		for(uint32 i = 0; i < guardBand; i++)
+		{
+			assert(guardBuffer[i] == 0);
+		}
+#endif
+	}
+	item->m_renderTime.store((uint32)(GetClockTime() - start), std::memory_order_relaxed);
+	uint8 state = ItemPending;
+	m_itemStates[index].compare_exchange_strong(state, ItemDone, std::memory_order_acq_rel);
+}
+void Audio_Impl::m_MixWorker()
+{
+	// Workers hold up the device callback, so they should not be preempted by the game
+	Thread::SetCurrentThreadRealtime();
+
+	while(true)
+	{
+		// Posts can be left over from blocks that finished before this worker woke up, claiming from those finds nothing
+		m_mixWorkerSignal.Wait();
+		if(!m_runMixWorkers)
+			return;
+		m_ClaimItems();
+	}
+}
+bool Audio_Impl::m_DecodeStreams()
+{
+	bool decoded = false;
+	m_decodeLock.lock();
+	for(AudioStreamBase* stream : m_decodeStreams)
+	{
+		decoded |= stream->DecodeAhead();
+	}
+	m_decodeLock.unlock();
+	return decoded;
+}
+uint64 Audio_Impl::m_QueueCommand(AudioCommand::Type type, AudioBase* item, DSP* dsp)
+{
+	m_commandLock.lock();
+	AudioCommand cmd = { type, item, dsp, m_nextCommandId++ };
+	while(!m_commands.Push(cmd))
+	{
+		// Queue is full, wait for the mixer to catch up
+		if(!runAudioThread)
+			m_ProcessCommandsExclusive();
+		else
+			std::this_thread::yield();
+	}
+	m_commandLock.unlock();
+
+	// Nothing is mixing, apply right away
+	if(!runAudioThread)
+		m_ProcessCommandsExclusive();
+
+	return cmd.id;
+}
+void Audio_Impl::m_WaitForCommand(uint64 id)
+{
+	Timer waitTimer;
+	while(m_processedCommandId.load(std::memory_order_acquire) < id)
+	{
+		// The output is not calling the mixer (no device, paused device, etc.), apply the commands on this thread instead
+		if(!runAudioThread || waitTimer.Milliseconds() > 100)
+			m_ProcessCommandsExclusive();
+		else
+			std::this_thread::yield();
+	}
+}
+void Audio_Impl::m_ProcessCommandsExclusive()
+{
+	while(m_renderLock.test_and_set(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+	m_ProcessCommands();
+	m_renderLock.clear(std::memory_order_release);
+}
+void Audio_Impl::m_ProcessCommands()
+{
+	// Items can't be removed while a mix worker is still rendering one
+	m_WaitForMixWorkers();
+
+	AudioCommand cmd;
+	while(m_commands.Pop(cmd))
+	{
+		AudioBase* item = cmd.item;
+		switch(cmd.type)
+		{
+		case AudioCommand::Register:
+			if(!itemsToRender.Contains(item))
+			{
+				// Capacity is reserved up front, the mixer never grows this list
+				assert(itemsToRender.size() < maxItemsToRender);
+				if(itemsToRender.size() < maxItemsToRender)
+					itemsToRender.Add(item);
+			}
+			break;
+		case AudioCommand::Deregister:
+			itemsToRender.Remove(item);
+			voices.Stop(item);
+			item->m_numRenderDSPs = 0;
+			item->m_UpdateDSPLatency();
+			break;
+		case AudioCommand::AddDSP:
+		{
+			assert(item->m_numRenderDSPs < AudioBase::maxDSPs);
+			if(item->m_numRenderDSPs >= AudioBase::maxDSPs)
+				break;
+
+			// Insert sorted by priority
+			uint32 idx = 0;
+			for(; idx < item->m_numRenderDSPs; idx++)
+			{
+				DSP* other = item->m_renderDSPs[idx];
+				if(other == cmd.dsp)
+					break;
+				if(other->priority > cmd.dsp->priority || (other->priority == cmd.dsp->priority && other > cmd.dsp))
+					break;
+			}
+			if(idx < item->m_numRenderDSPs && item->m_renderDSPs[idx] == cmd.dsp)
+				break; // Already added
+			for(uint32 i = item->m_numRenderDSPs; i > idx; i--)
+			{
+				item->m_renderDSPs[i] = item->m_renderDSPs[i - 1];
+			}
+			item->m_renderDSPs[idx] = cmd.dsp;
+			item->m_numRenderDSPs++;
+			item->m_UpdateDSPLatency();
+			break;
+		}
+		case AudioCommand::RemoveDSP:
+			for(uint32 i = 0; i < item->m_numRenderDSPs; i++)
+			{
+				if(item->m_renderDSPs[i] == cmd.dsp)
+				{
+					for(uint32 j = i + 1; j < item->m_numRenderDSPs; j++)
+					{
+						item->m_renderDSPs[j - 1] = item->m_renderDSPs[j];
+					}
+					item->m_numRenderDSPs--;
+					item->m_UpdateDSPLatency();
+					break;
+				}
+			}
+			break;
+		case AudioCommand::PlaySample:
+			voices.Play(static_cast<SampleRes*>(item));
+			break;
+		case AudioCommand::StopSample:
+			voices.Stop(item);
+			break;
+		}
+		m_processedCommandId.store(cmd.id, std::memory_order_release);
+	}
 }
 uint32 Audio_Impl::GetSampleRate() const
 {
@@ -143,6 +499,33 @@ double Audio_Impl::GetSecondsPerSample() const
 {
 	return 1.0 / (double)GetSampleRate();
 }
+double Audio_Impl::GetOutputPosition() const
+{
+	AudioClockState clock = m_clock.Load();
+	if(clock.sampleRate == 0)
+		return 0.0;
+
+	// Advance at the output rate since the last callback, but never past the samples that were actually handed to the device
+	double elapsed = (double)(GetClockTime() - clock.timestamp) * 1e-9 * (double)clock.sampleRate;
+	elapsed = Math::Clamp(elapsed, 0.0, (double)clock.numSamples);
+	return (double)clock.samplePosition + elapsed;
+}
+int64 Audio_Impl::GetBlockOutputPosition() const
+{
+	return m_blockOutputPosition;
+}
+uint32 Audio_Impl::GetNumMixWorkers() const
+{
+	return (uint32)m_mixWorkers.size();
+}
+uint64 Audio_Impl::GetNumBypassedBlocks() const
+{
+	return stats.GetNumBypassedBlocks();
+}
+int64 Audio_Impl::GetClockTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 Audio::Audio()
 {
@@ -154,6 +537,7 @@ Audio::~Audio()
 {
 	if(m_initialized)
 	{
+		impl.stats.Log();
 		impl.Stop();
 		delete impl.output;
 		impl.output = nullptr;
@@ -162,19 +546,50 @@ Audio::~Audio()
 	assert(g_audio == this);
 	g_audio = nullptr;
 }
-bool Audio::Init()
+bool Audio::Init(uint32 bufferSize, uint32 sampleRate)
 {
-	audioLatency = 0;
-
-	impl.output = new AudioOutput();
-	if(!impl.output->Init())
+	AudioOutput* output = new AudioOutput();
+	if(!output->Init(bufferSize, sampleRate))
 	{
-		delete impl.output;
-		impl.output = nullptr;
+		delete output;
 		return false;
 	}
+	return m_Init(output);
+}
+bool Audio::InitOffline(uint32 bufferSize, uint32 sampleRate)
+{
+	return m_Init(new OfflineAudioOutput(bufferSize, sampleRate));
+}
+void Audio::Render(float* out, uint32 numSamples)
+{
+	assert(m_initialized && !impl.output->IsRealtime());
+	static_cast<OfflineAudioOutput*>(impl.output)->Render(out, numSamples);
+}
+bool Audio::RenderToFile(const String& path, uint32 numSamples)
+{
+	Vector<float> data;
+	data.resize(numSamples * 2);
+	Render(data.data(), numSamples);
+	return OfflineAudioOutput::WriteWav(path, data.data(), numSamples, GetSampleRate());
+}
+bool Audio::m_Init(IAudioOutput* output)
+{
+	audioLatency = 0;
+	impl.output = output;
+
+	// Don't render blocks larger than the device buffer, otherwise small buffers gain nothing
+	uint32 outputRate = impl.output->GetSampleRate();
+	uint32 deviceBufferSamples = (uint32)(impl.output->GetBufferLength() * (double)outputRate);
+	if(deviceBufferSamples > 0)
+		impl.m_sampleBufferLength = Math::Clamp(deviceBufferSamples, 64u, impl.m_sampleBufferLength);
+
+	// Samples waiting in the mix block are accounted for by the audio clock, only the device and the limiter's lookahead add latency
+	impl.outputLatency = impl.output->GetLatency() + (double)LimiterDSP::lookahead / (double)outputRate;
+	audioLatency = (int64)(impl.outputLatency * 1000.0);
+	Logf("Audio output latency: %.2f ms (mix block of %d samples)", Logger::Info, impl.outputLatency * 1000.0, impl.m_sampleBufferLength);
 
 	impl.Start();
+	Logf("Audio mixing kernels: %s", Logger::Info, AudioKernels::GetInstructionSet());
 
 	return m_initialized = true;
 }
@@ -186,14 +601,49 @@ uint32 Audio::GetSampleRate() const
 {
 	return impl.output->GetSampleRate();
 }
+double Audio::GetOutputLatency() const
+{
+	return impl.outputLatency;
+}
+const AudioStats& Audio::GetStats() const
+{
+	return impl.stats;
+}
+AudioMeter Audio::GetOutputMeter() const
+{
+	return impl.limiter ? impl.limiter->GetMeter() : AudioMeter();
+}
+void Audio::SetLatencyCompensation(bool enabled)
+{
+	impl.compensateLatency = enabled;
+}
+bool Audio::GetLatencyCompensation() const
+{
+	return impl.compensateLatency;
+}
+void Audio::SetCacheMemoryBudget(size_t bytes)
+{
+	impl.cache.SetMemoryBudget(bytes);
+}
+void Audio::SetCacheFolder(const String& folder)
+{
+	impl.cache.SetDiskFolder(folder);
+}
 class Audio_Impl* Audio::GetImpl()
 {
 	return &impl;
 }
 
-AudioStream Audio::CreateStream(const String& path, bool preload)
+AudioStream Audio::CreateStream(const String& path, bool preload, int32 cachedLength)
+{
+	AudioStream stream = AudioStreamRes::Create(this, path, preload);
+	if(stream && cachedLength > 0)
+		static_cast<AudioStreamBase*>(stream.GetData())->CacheRange(0, cachedLength);
+	return stream;
+}
+AudioStream Audio::CreateCachedStream(const String& path, int32 startTime, int32 duration)
 {
-	return AudioStreamRes::Create(this, path, preload);
+	return AudioStreamRes::CreateCached(this, path, startTime, duration);
 }
 Sample Audio::CreateSample(const String& path)
 {
@@ -17,34 +17,43 @@ AudioBase::~AudioBase()
 }
 void AudioBase::ProcessDSPs(float*& out, uint32 numSamples)
 {
-	for(DSP* dsp : DSPs)
+	int64 start = Audio_Impl::GetClockTime();
+	for(uint32 i = 0; i < m_numRenderDSPs; i++)
 	{
-		dsp->Process(out, numSamples);
+		m_renderDSPs[i]->Process(out, numSamples);
+		int64 end = Audio_Impl::GetClockTime();
+		m_renderDSPs[i]->m_processTime.store((uint32)(end - start), std::memory_order_relaxed);
+		start = end;
 	}
 }
 void AudioBase::AddDSP(DSP* dsp)
 {
-	audio->lock.lock();
+	assert(audio);
 	DSPs.AddUnique(dsp);
-	// Sort by priority
-	DSPs.Sort([](DSP* l, DSP* r)
-	{
-		if(l->priority == r->priority)
-			return l < r;
-		return l->priority < r->priority;
-	});
 	dsp->audioBase = this;
 	dsp->audio = audio;
-	audio->lock.unlock();
+	dsp->Prepare(audio->GetSampleRate());
+	audio->AddDSP(this, dsp);
 }
 void AudioBase::RemoveDSP(DSP* dsp)
 {
 	assert(DSPs.Contains(dsp));
-	audio->lock.lock();
+	// Wait for the mixer to drop the DSP before unlinking it
+	if(audio)
+		audio->RemoveDSP(this, dsp);
 	DSPs.Remove(dsp);
 	dsp->audioBase = nullptr;
 	dsp->audio = nullptr;
-	audio->lock.unlock();
+}
+
+void AudioBase::m_UpdateDSPLatency()
+{
+	uint32 latency = 0;
+	for(uint32 i = 0; i < m_numRenderDSPs; i++)
+	{
+		latency += m_renderDSPs[i]->GetLatency();
+	}
+	m_dspLatency.store(latency, std::memory_order_relaxed);
 }
 
 void AudioBase::Deregister()
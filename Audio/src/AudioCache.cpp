@@ -0,0 +1,233 @@
+#include "stdafx.h"
+#include "AudioCache.hpp"
+
+// Increment when the file layout changes
+static const uint32 pcmCacheMagic = 0x4D435041; // "APCM"
+static const uint32 pcmCacheVersion = 1;
+
+struct PCMCacheHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint64 sourceSize;
+	uint64 sourceWriteTime;
+	int64 startSample;
+	uint32 sampleRate;
+	uint32 numFrames;
+	int32 startTime;
+	int32 duration;
+};
+
+Ref<PCMSegment> AudioCache::Find(const String& path, int32 startTime, int32 duration)
+{
+	String key = m_GetKey(path, startTime, duration);
+	String diskFolder;
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		Entry* entry = m_entries.Find(key);
+		if(entry)
+		{
+			// Move to the front of the list
+			m_lru.splice(m_lru.begin(), m_lru, entry->lruPosition);
+			return entry->segment;
+		}
+		diskFolder = m_diskFolder;
+	}
+	if(diskFolder.empty())
+		return Ref<PCMSegment>();
+
+	// Not in memory, try the disk cache
+	Ref<PCMSegment> segment = m_Load(diskFolder, key, path);
+	if(!segment)
+		return segment;
+
+	Vector<Ref<PCMSegment>> evicted;
+	std::lock_guard<std::mutex> guard(m_lock);
+	m_Insert(key, segment, evicted);
+	// Already on disk, no need to write them again
+	for(auto& e : evicted)
+		e.Release();
+	return segment;
+}
+void AudioCache::Add(const Ref<PCMSegment>& segment)
+{
+	String key = m_GetKey(segment->path, segment->startTime, segment->duration);
+	Vector<Ref<PCMSegment>> evicted;
+	String diskFolder;
+	{
+		std::lock_guard<std::mutex> guard(m_lock);
+		m_Insert(key, segment, evicted);
+		diskFolder = m_diskFolder;
+	}
+	if(evicted.empty())
+		return;
+
+	// Write outside of the lock, the segments are no longer in the cache so their data doesn't change
+	if(!diskFolder.empty())
+	{
+		for(auto& e : evicted)
+		{
+			// Files that were saved for an older version of the source file are replaced
+			String evictedKey = m_GetKey(e->path, e->startTime, e->duration);
+			File existing;
+			PCMCacheHeader header;
+			if(m_OpenDiskFile(m_GetDiskPath(diskFolder, evictedKey), e->path, existing, header))
+				continue;
+			existing.Close();
+			m_Save(diskFolder, evictedKey, *e);
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(m_lock);
+	for(auto& e : evicted)
+		e.Release();
+}
+void AudioCache::Release(Ref<PCMSegment>& segment)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	segment.Release();
+}
+void AudioCache::Clear()
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	m_entries.clear();
+	m_lru.clear();
+	m_memoryUsage = 0;
+}
+void AudioCache::SetMemoryBudget(size_t bytes)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	m_memoryBudget = bytes;
+}
+size_t AudioCache::GetMemoryBudget() const
+{
+	return m_memoryBudget;
+}
+size_t AudioCache::GetMemoryUsage() const
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	return m_memoryUsage;
+}
+void AudioCache::SetDiskFolder(const String& folder)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	m_diskFolder = folder;
+	if(!m_diskFolder.empty() && !Path::IsDirectory(m_diskFolder))
+		Path::CreateDir(m_diskFolder);
+}
+
+String AudioCache::m_GetKey(const String& path, int32 startTime, int32 duration)
+{
+	return Utility::Sprintf("%s|%d|%d", Path::Normalize(Path::Absolute(path)), startTime, duration);
+}
+String AudioCache::m_GetDiskPath(const String& folder, const String& key)
+{
+	// FNV-1a hash of the key
+	uint64 hash = 14695981039346656037ull;
+	for(char c : key)
+	{
+		hash ^= (uint8)c;
+		hash *= 1099511628211ull;
+	}
+	return Path::Normalize(folder + Path::sep + Utility::Sprintf("%016llx.pcm", (unsigned long long)hash));
+}
+void AudioCache::m_Insert(const String& key, const Ref<PCMSegment>& segment, Vector<Ref<PCMSegment>>& evicted)
+{
+	Entry* existing = m_entries.Find(key);
+	if(existing)
+	{
+		// Captured by multiple streams at the same time, keep the one that is already shared
+		m_lru.splice(m_lru.begin(), m_lru, existing->lruPosition);
+		return;
+	}
+
+	// Doesn't fit at all
+	size_t size = segment->GetMemoryUsage();
+	if(size > m_memoryBudget)
+	{
+		evicted.Add(segment);
+		return;
+	}
+
+	m_lru.AddFront(key);
+	Entry& entry = m_entries.Add(key, Entry());
+	entry.segment = segment;
+	entry.lruPosition = m_lru.begin();
+	m_memoryUsage += size;
+
+	while(m_memoryUsage > m_memoryBudget)
+	{
+		String last = m_lru.PopBack();
+		auto it = m_entries.find(last);
+		assert(it != m_entries.end());
+		m_memoryUsage -= it->second.segment->GetMemoryUsage();
+		evicted.Add(it->second.segment);
+		m_entries.erase(it);
+	}
+}
+bool AudioCache::m_OpenDiskFile(const String& diskPath, const String& path, File& file, PCMCacheHeader& header)
+{
+	if(!Path::FileExists(diskPath) || !Path::FileExists(path))
+		return false;
+
+	File source;
+	if(!source.OpenRead(path))
+		return false;
+	uint64 sourceSize = source.GetSize();
+	uint64 sourceWriteTime = source.GetLastWriteTime();
+	source.Close();
+
+	if(!file.OpenRead(diskPath))
+		return false;
+	if(file.Read(&header, sizeof(header)) != sizeof(header))
+		return false;
+	if(header.magic != pcmCacheMagic || header.version != pcmCacheVersion)
+		return false;
+	if(header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime)
+		return false;
+	return file.GetSize() == sizeof(header) + (size_t)header.numFrames * 2 * sizeof(int16);
+}
+Ref<PCMSegment> AudioCache::m_Load(const String& folder, const String& key, const String& path)
+{
+	File file;
+	PCMCacheHeader header;
+	if(!m_OpenDiskFile(m_GetDiskPath(folder, key), path, file, header))
+		return Ref<PCMSegment>();
+
+	size_t dataSize = (size_t)header.numFrames * 2 * sizeof(int16);
+	Ref<PCMSegment> segment = Ref<PCMSegment>(new PCMSegment());
+	segment->path = path;
+	segment->startTime = header.startTime;
+	segment->duration = header.duration;
+	segment->sampleRate = header.sampleRate;
+	segment->startSample = header.startSample;
+	segment->data.resize((size_t)header.numFrames * 2);
+	if(file.Read(segment->data.data(), dataSize) != dataSize)
+		return Ref<PCMSegment>();
+	return segment;
+}
+bool AudioCache::m_Save(const String& folder, const String& key, const PCMSegment& segment)
+{
+	File source;
+	if(!Path::FileExists(segment.path) || !source.OpenRead(segment.path))
+		return false;
+
+	PCMCacheHeader header = { 0 };
+	header.magic = pcmCacheMagic;
+	header.version = pcmCacheVersion;
+	header.sourceSize = source.GetSize();
+	header.sourceWriteTime = source.GetLastWriteTime();
+	header.startSample = segment.startSample;
+	header.sampleRate = segment.sampleRate;
+	header.numFrames = segment.GetNumFrames();
+	header.startTime = segment.startTime;
+	header.duration = segment.duration;
+	source.Close();
+
+	File file;
+	if(!file.OpenWrite(m_GetDiskPath(folder, key)))
+		return false;
+	file.Write(&header, sizeof(header));
+	file.Write(segment.data.data(), segment.GetMemoryUsage());
+	return true;
+}
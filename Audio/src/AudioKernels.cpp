@@ -0,0 +1,531 @@
+#include "stdafx.h"
+#include "AudioKernels.hpp"
+
+#if defined(__AVX2__)
+#define KERNELS_AVX2 1
+#define KERNELS_SSE2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KERNELS_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Same scale the decoders used to divide by
+static const float int16Scale = 1.0f / (float)0x7FFF;
+
+namespace AudioKernels
+{
+	const char* GetInstructionSet()
+	{
+#if KERNELS_AVX2
+		return "AVX2";
+#elif KERNELS_SSE2
+		return "SSE2";
+#elif KERNELS_NEON
+		return "NEON";
+#else
+		return "Scalar";
+#endif
+	}
+
+	void MixAdd(float* dst, const float* src, float gain, uint32 count)
+	{
+		uint32 i = 0;
+#if KERNELS_AVX2
+		__m256 g8 = _mm256_set1_ps(gain);
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256 d = _mm256_loadu_ps(dst + i);
+			__m256 s = _mm256_loadu_ps(src + i);
+			_mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(s, g8)));
+		}
+#endif
+#if KERNELS_SSE2
+		__m128 g4 = _mm_set1_ps(gain);
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128 d = _mm_loadu_ps(dst + i);
+			__m128 s = _mm_loadu_ps(src + i);
+			_mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g4)));
+		}
+#elif KERNELS_NEON
+		for(; i + 4 <= count; i += 4)
+		{
+			vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+		}
+#endif
+		for(; i < count; i++)
+		{
+			dst[i] += src[i] * gain;
+		}
+	}
+	void Scale(float* data, float gain, uint32 count)
+	{
+		uint32 i = 0;
+#if KERNELS_AVX2
+		__m256 g8 = _mm256_set1_ps(gain);
+		for(; i + 8 <= count; i += 8)
+		{
+			_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g8));
+		}
+#endif
+#if KERNELS_SSE2
+		__m128 g4 = _mm_set1_ps(gain);
+		for(; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g4));
+		}
+#elif KERNELS_NEON
+		for(; i + 4 <= count; i += 4)
+		{
+			vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), gain));
+		}
+#endif
+		for(; i < count; i++)
+		{
+			data[i] *= gain;
+		}
+	}
+
+	void ScaleRamp(float* data, float from, float to, uint32 numSamples)
+	{
+		if(numSamples == 0)
+			return;
+		float step = (to - from) / (float)numSamples;
+		uint32 i = 0;
+#if KERNELS_SSE2
+		// Two frames per vector, both channels of a frame get the same gain
+		__m128 g = _mm_setr_ps(from + step, from + step, from + step * 2.0f, from + step * 2.0f);
+		__m128 step4 = _mm_set1_ps(step * 2.0f);
+		for(; i + 2 <= numSamples; i += 2)
+		{
+			_mm_storeu_ps(data + i * 2, _mm_mul_ps(_mm_loadu_ps(data + i * 2), g));
+			g = _mm_add_ps(g, step4);
+		}
+#elif KERNELS_NEON
+		float initial[4] = { from + step, from + step, from + step * 2.0f, from + step * 2.0f };
+		float32x4_t g = vld1q_f32(initial);
+		float32x4_t step4 = vdupq_n_f32(step * 2.0f);
+		for(; i + 2 <= numSamples; i += 2)
+		{
+			vst1q_f32(data + i * 2, vmulq_f32(vld1q_f32(data + i * 2), g));
+			g = vaddq_f32(g, step4);
+		}
+#endif
+		for(; i < numSamples; i++)
+		{
+			float gain = (i + 1 == numSamples) ? to : from + step * (float)(i + 1);
+			data[i * 2] *= gain;
+			data[i * 2 + 1] *= gain;
+		}
+	}
+	float PeakAbs(const float* data, uint32 count)
+	{
+		uint32 i = 0;
+		float peak = 0.0f;
+#if KERNELS_SSE2
+		// Clearing the sign bit gives the absolute value
+		__m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		__m128 max4 = _mm_setzero_ps();
+#if KERNELS_AVX2
+		__m256 mask8 = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+		__m256 max8 = _mm256_setzero_ps();
+		for(; i + 8 <= count; i += 8)
+		{
+			max8 = _mm256_max_ps(max8, _mm256_and_ps(_mm256_loadu_ps(data + i), mask8));
+		}
+		max4 = _mm_max_ps(_mm256_castps256_ps128(max8), _mm256_extractf128_ps(max8, 1));
+#endif
+		for(; i + 4 <= count; i += 4)
+		{
+			max4 = _mm_max_ps(max4, _mm_and_ps(_mm_loadu_ps(data + i), mask));
+		}
+		max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+		max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, _MM_SHUFFLE(1, 1, 1, 1)));
+		peak = _mm_cvtss_f32(max4);
+#elif KERNELS_NEON
+		float32x4_t max4 = vdupq_n_f32(0.0f);
+		for(; i + 4 <= count; i += 4)
+		{
+			max4 = vmaxq_f32(max4, vabsq_f32(vld1q_f32(data + i)));
+		}
+		float32x2_t max2 = vpmax_f32(vget_low_f32(max4), vget_high_f32(max4));
+		peak = vget_lane_f32(vpmax_f32(max2, max2), 0);
+#endif
+		for(; i < count; i++)
+		{
+			peak = Math::Max(peak, fabsf(data[i]));
+		}
+		return peak;
+	}
+	float SumSquares(const float* data, uint32 count)
+	{
+		uint32 i = 0;
+		float sum = 0.0f;
+#if KERNELS_SSE2
+		__m128 acc = _mm_setzero_ps();
+#if KERNELS_AVX2
+		__m256 acc8 = _mm256_setzero_ps();
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256 v = _mm256_loadu_ps(data + i);
+			acc8 = _mm256_add_ps(acc8, _mm256_mul_ps(v, v));
+		}
+		acc = _mm_add_ps(_mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1));
+#endif
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(data + i);
+			acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+		}
+		acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+		acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+		sum = _mm_cvtss_f32(acc);
+#elif KERNELS_NEON
+		float32x4_t acc = vdupq_n_f32(0.0f);
+		for(; i + 4 <= count; i += 4)
+		{
+			float32x4_t v = vld1q_f32(data + i);
+			acc = vmlaq_f32(acc, v, v);
+		}
+		float32x2_t sum2 = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+		sum = vget_lane_f32(vpadd_f32(sum2, sum2), 0);
+#endif
+		for(; i < count; i++)
+		{
+			sum += data[i] * data[i];
+		}
+		return sum;
+	}
+
+	void Interleave(float* dst, const float* left, const float* right, uint32 numSamples)
+	{
+		uint32 i = 0;
+#if KERNELS_SSE2
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			__m128 l = _mm_loadu_ps(left + i);
+			__m128 r = _mm_loadu_ps(right + i);
+			_mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(l, r));
+		}
+#elif KERNELS_NEON
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			float32x4x2_t lr;
+			lr.val[0] = vld1q_f32(left + i);
+			lr.val[1] = vld1q_f32(right + i);
+			vst2q_f32(dst + i * 2, lr);
+		}
+#endif
+		for(; i < numSamples; i++)
+		{
+			dst[i * 2 + 0] = left[i];
+			dst[i * 2 + 1] = right[i];
+		}
+	}
+	void Deinterleave(float* left, float* right, const float* src, uint32 numSamples)
+	{
+		uint32 i = 0;
+#if KERNELS_SSE2
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			__m128 a = _mm_loadu_ps(src + i * 2);
+			__m128 b = _mm_loadu_ps(src + i * 2 + 4);
+			_mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#elif KERNELS_NEON
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			float32x4x2_t lr = vld2q_f32(src + i * 2);
+			vst1q_f32(left + i, lr.val[0]);
+			vst1q_f32(right + i, lr.val[1]);
+		}
+#endif
+		for(; i < numSamples; i++)
+		{
+			left[i] = src[i * 2 + 0];
+			right[i] = src[i * 2 + 1];
+		}
+	}
+	void CopyToChannels(float* dst, uint32 dstChannels, const float* src, uint32 numSamples)
+	{
+		if(dstChannels == 2)
+		{
+			memcpy(dst, src, sizeof(float) * 2 * numSamples);
+			return;
+		}
+
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			dst[i * dstChannels] = src[i * 2];
+			if(dstChannels > 1)
+				dst[i * dstChannels + 1] = src[i * 2 + 1];
+		}
+	}
+
+#if KERNELS_SSE2
+	// Sign extends the low and high 4 values of 8 int16's into 2 float vectors
+	static inline void m_Int16x8ToFloat(__m128i v, __m128& lo, __m128& hi)
+	{
+		__m128 scale = _mm_set1_ps(int16Scale);
+		lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), scale);
+		hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), scale);
+	}
+#endif
+
+	void Int16ToFloat(float* dst, const int16* src, uint32 count)
+	{
+		uint32 i = 0;
+#if KERNELS_AVX2
+		__m256 scale8 = _mm256_set1_ps(int16Scale);
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+			_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale8));
+		}
+#elif KERNELS_SSE2
+		for(; i + 8 <= count; i += 8)
+		{
+			__m128 lo, hi;
+			m_Int16x8ToFloat(_mm_loadu_si128((const __m128i*)(src + i)), lo, hi);
+			_mm_storeu_ps(dst + i, lo);
+			_mm_storeu_ps(dst + i + 4, hi);
+		}
+#elif KERNELS_NEON
+		for(; i + 8 <= count; i += 8)
+		{
+			int16x8_t v = vld1q_s16(src + i);
+			vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), int16Scale));
+			vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), int16Scale));
+		}
+#endif
+		for(; i < count; i++)
+		{
+			dst[i] = (float)src[i] * int16Scale;
+		}
+	}
+	void Int16MonoToStereo(float* dst, const int16* src, uint32 numSamples)
+	{
+		uint32 i = 0;
+#if KERNELS_SSE2
+		for(; i + 8 <= numSamples; i += 8)
+		{
+			__m128 lo, hi;
+			m_Int16x8ToFloat(_mm_loadu_si128((const __m128i*)(src + i)), lo, hi);
+			_mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(lo, lo));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(lo, lo));
+			_mm_storeu_ps(dst + i * 2 + 8, _mm_unpacklo_ps(hi, hi));
+			_mm_storeu_ps(dst + i * 2 + 12, _mm_unpackhi_ps(hi, hi));
+		}
+#elif KERNELS_NEON
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			float32x4x2_t lr;
+			lr.val[0] = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(src + i))), int16Scale);
+			lr.val[1] = lr.val[0];
+			vst2q_f32(dst + i * 2, lr);
+		}
+#endif
+		for(; i < numSamples; i++)
+		{
+			float v = (float)src[i] * int16Scale;
+			dst[i * 2 + 0] = v;
+			dst[i * 2 + 1] = v;
+		}
+	}
+	void Int16ToPlanar(float* left, float* right, const int16* src, uint32 numSamples)
+	{
+		uint32 i = 0;
+#if KERNELS_SSE2
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			__m128 a, b;
+			m_Int16x8ToFloat(_mm_loadu_si128((const __m128i*)(src + i * 2)), a, b);
+			_mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#elif KERNELS_NEON
+		for(; i + 4 <= numSamples; i += 4)
+		{
+			int16x4x2_t lr = vld2_s16(src + i * 2);
+			vst1q_f32(left + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(lr.val[0])), int16Scale));
+			vst1q_f32(right + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(lr.val[1])), int16Scale));
+		}
+#endif
+		for(; i < numSamples; i++)
+		{
+			left[i] = (float)src[i * 2 + 0] * int16Scale;
+			right[i] = (float)src[i * 2 + 1] * int16Scale;
+		}
+	}
+	void FloatToInt16(int16* dst, const float* src, uint32 count)
+	{
+		uint32 i = 0;
+#if KERNELS_SSE2
+		__m128 scale = _mm_set1_ps((float)0x7FFF);
+		__m128 minValue = _mm_set1_ps(-1.0f);
+		__m128 maxValue = _mm_set1_ps(1.0f);
+		for(; i + 8 <= count; i += 8)
+		{
+			// Rounds to nearest
+			__m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), minValue), maxValue);
+			__m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), minValue), maxValue);
+			__m128i lo = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+			__m128i hi = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+		}
+#elif KERNELS_NEON
+		for(; i + 8 <= count; i += 8)
+		{
+			float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(src + i), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f));
+			float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(src + i + 4), vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f));
+			int32x4_t lo = vcvtnq_s32_f32(vmulq_n_f32(a, (float)0x7FFF));
+			int32x4_t hi = vcvtnq_s32_f32(vmulq_n_f32(b, (float)0x7FFF));
+			vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+		}
+#endif
+		for(; i < count; i++)
+		{
+			float v = Math::Clamp(src[i], -1.0f, 1.0f) * (float)0x7FFF;
+			dst[i] = (int16)(v < 0.0f ? v - 0.5f : v + 0.5f);
+		}
+	}
+	void ConvolveStereo(float* dst, const float* src, const float* coefficients, uint32 numTaps)
+	{
+		// Even lanes accumulate the left channel and odd lanes the right channel
+		uint32 count = numTaps * 2;
+		uint32 i = 0;
+		float left = 0.0f, right = 0.0f;
+#if KERNELS_SSE2
+		__m128 acc = _mm_setzero_ps();
+#if KERNELS_AVX2
+		__m256 acc8 = _mm256_setzero_ps();
+		for(; i + 8 <= count; i += 8)
+		{
+			acc8 = _mm256_add_ps(acc8, _mm256_mul_ps(_mm256_loadu_ps(src + i), _mm256_loadu_ps(coefficients + i)));
+		}
+		acc = _mm_add_ps(_mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1));
+#endif
+		for(; i + 4 <= count; i += 4)
+		{
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(coefficients + i)));
+		}
+		acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+		float lr[4];
+		_mm_storeu_ps(lr, acc);
+		left = lr[0];
+		right = lr[1];
+#elif KERNELS_NEON
+		float32x4_t acc = vdupq_n_f32(0.0f);
+		for(; i + 4 <= count; i += 4)
+		{
+			acc = vmlaq_f32(acc, vld1q_f32(src + i), vld1q_f32(coefficients + i));
+		}
+		float32x2_t lr = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+		left = vget_lane_f32(lr, 0);
+		right = vget_lane_f32(lr, 1);
+#endif
+		for(; i < count; i += 2)
+		{
+			left += src[i] * coefficients[i];
+			right += src[i + 1] * coefficients[i + 1];
+		}
+		dst[0] = left;
+		dst[1] = right;
+	}
+	void BiquadStereo(float* data, uint32 numSamples, BiquadState& state, const BiquadCoefficients& from, const BiquadCoefficients& to)
+	{
+		if(numSamples == 0)
+			return;
+		float step = 1.0f / (float)numSamples;
+		float db0 = (to.b0 - from.b0) * step;
+		float db1 = (to.b1 - from.b1) * step;
+		float db2 = (to.b2 - from.b2) * step;
+		float da1 = (to.a1 - from.a1) * step;
+		float da2 = (to.a2 - from.a2) * step;
+
+#if KERNELS_SSE2
+		// Left and right in the lower 2 lanes
+		__m128 b0 = _mm_set1_ps(from.b0), b1 = _mm_set1_ps(from.b1), b2 = _mm_set1_ps(from.b2);
+		__m128 a1 = _mm_set1_ps(from.a1), a2 = _mm_set1_ps(from.a2);
+		__m128 vdb0 = _mm_set1_ps(db0), vdb1 = _mm_set1_ps(db1), vdb2 = _mm_set1_ps(db2);
+		__m128 vda1 = _mm_set1_ps(da1), vda2 = _mm_set1_ps(da2);
+		__m128 s1 = _mm_setr_ps(state.s1[0], state.s1[1], 0.0f, 0.0f);
+		__m128 s2 = _mm_setr_ps(state.s2[0], state.s2[1], 0.0f, 0.0f);
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			b0 = _mm_add_ps(b0, vdb0);
+			b1 = _mm_add_ps(b1, vdb1);
+			b2 = _mm_add_ps(b2, vdb2);
+			a1 = _mm_add_ps(a1, vda1);
+			a2 = _mm_add_ps(a2, vda2);
+
+			__m128 x = _mm_castpd_ps(_mm_load_sd((const double*)(data + i * 2)));
+			__m128 y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+			s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2);
+			s2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+			_mm_store_sd((double*)(data + i * 2), _mm_castps_pd(y));
+		}
+		float v1[4], v2[4];
+		_mm_storeu_ps(v1, s1);
+		_mm_storeu_ps(v2, s2);
+		for(uint32 c = 0; c < 2; c++)
+		{
+			state.s1[c] = v1[c];
+			state.s2[c] = v2[c];
+		}
+#elif KERNELS_NEON
+		float32x2_t b0 = vdup_n_f32(from.b0), b1 = vdup_n_f32(from.b1), b2 = vdup_n_f32(from.b2);
+		float32x2_t a1 = vdup_n_f32(from.a1), a2 = vdup_n_f32(from.a2);
+		float32x2_t s1 = vld1_f32(state.s1), s2 = vld1_f32(state.s2);
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			b0 = vadd_f32(b0, vdup_n_f32(db0));
+			b1 = vadd_f32(b1, vdup_n_f32(db1));
+			b2 = vadd_f32(b2, vdup_n_f32(db2));
+			a1 = vadd_f32(a1, vdup_n_f32(da1));
+			a2 = vadd_f32(a2, vdup_n_f32(da2));
+
+			float32x2_t x = vld1_f32(data + i * 2);
+			float32x2_t y = vmla_f32(s1, b0, x);
+			s1 = vadd_f32(vmls_f32(vmul_f32(b1, x), a1, y), s2);
+			s2 = vmls_f32(vmul_f32(b2, x), a2, y);
+			vst1_f32(data + i * 2, y);
+		}
+		vst1_f32(state.s1, s1);
+		vst1_f32(state.s2, s2);
+#else
+		float b0 = from.b0, b1 = from.b1, b2 = from.b2, a1 = from.a1, a2 = from.a2;
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			b0 += db0;
+			b1 += db1;
+			b2 += db2;
+			a1 += da1;
+			a2 += da2;
+			for(uint32 c = 0; c < 2; c++)
+			{
+				float x = data[i * 2 + c];
+				float y = b0 * x + state.s1[c];
+				state.s1[c] = b1 * x - a1 * y + state.s2[c];
+				state.s2[c] = b2 * x - a2 * y;
+				data[i * 2 + c] = y;
+			}
+		}
+#endif
+
+		// Flush denormals when the input went silent, they make the filter very slow
+		for(uint32 c = 0; c < 2; c++)
+		{
+			if(fabsf(state.s1[c]) < 1e-20f)
+				state.s1[c] = 0.0f;
+			if(fabsf(state.s2[c]) < 1e-20f)
+				state.s2[c] = 0.0f;
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#include "stdafx.h"
+#include "AudioOutput.hpp"
+
+OfflineAudioOutput::OfflineAudioOutput(uint32 bufferSize, uint32 sampleRate)
+{
+	m_bufferSize = bufferSize > 0 ? bufferSize : 512;
+	m_sampleRate = sampleRate > 0 ? sampleRate : 44100;
+}
+void OfflineAudioOutput::Start(IMixer* mixer)
+{
+	m_mixer = mixer;
+}
+void OfflineAudioOutput::Stop()
+{
+	m_mixer = nullptr;
+}
+uint32_t OfflineAudioOutput::GetNumChannels() const
+{
+	return 2;
+}
+uint32_t OfflineAudioOutput::GetSampleRate() const
+{
+	return m_sampleRate;
+}
+double OfflineAudioOutput::GetBufferLength() const
+{
+	return (double)m_bufferSize / (double)m_sampleRate;
+}
+double OfflineAudioOutput::GetLatency() const
+{
+	// Nothing is being played
+	return 0.0;
+}
+void OfflineAudioOutput::Render(float* out, uint32 numSamples)
+{
+	assert(m_mixer);
+	// Ask for the same block sizes a device would, so the result doesn't depend on how much is rendered at once
+	uint32 rendered = 0;
+	while(rendered < numSamples)
+	{
+		uint32 count = Math::Min(m_bufferSize, numSamples - rendered);
+		m_mixer->Mix(out + rendered * 2, count);
+		rendered += count;
+	}
+}
+
+#pragma pack(push, 1)
+struct WavFloatHeader
+{
+	char riff[4];
+	uint32 riffLength;
+	char wave[4];
+	char fmt[4];
+	uint32 fmtLength;
+	uint16 format;
+	uint16 channels;
+	uint32 sampleRate;
+	uint32 byteRate;
+	uint16 blockAlign;
+	uint16 bitsPerSample;
+	char data[4];
+	uint32 dataLength;
+};
+#pragma pack(pop)
+
+bool OfflineAudioOutput::WriteWav(const String& path, const float* data, uint32 numSamples, uint32 sampleRate)
+{
+	File file;
+	if(!file.OpenWrite(path))
+		return false;
+
+	uint32 dataLength = numSamples * 2 * sizeof(float);
+	WavFloatHeader header;
+	memcpy(header.riff, "RIFF", 4);
+	header.riffLength = sizeof(WavFloatHeader) - 8 + dataLength;
+	memcpy(header.wave, "WAVE", 4);
+	memcpy(header.fmt, "fmt ", 4);
+	header.fmtLength = 16;
+	header.format = 3; // IEEE float
+	header.channels = 2;
+	header.sampleRate = sampleRate;
+	header.byteRate = sampleRate * 2 * sizeof(float);
+	header.blockAlign = 2 * sizeof(float);
+	header.bitsPerSample = 32;
+	memcpy(header.data, "data", 4);
+	header.dataLength = dataLength;
+
+	if(file.Write(&header, sizeof(header)) != sizeof(header))
+		return false;
+	return file.Write(data, dataLength) == dataLength;
+}
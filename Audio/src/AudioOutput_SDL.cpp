@@ -42,6 +42,10 @@ public:
 	IMixer* m_mixer = nullptr;
 	volatile bool m_running = false;
 
+	// Requested device settings
+	uint32 m_desiredBufferSize = 1024;
+	uint32 m_desiredSampleRate = 44100;
+
 public:
 	AudioOutput_Impl()
 	{
@@ -69,10 +73,10 @@ public:
 		CloseDevice();
 
 		SDL_AudioSpec desiredSpec = { 0 };
-		desiredSpec.freq = 44100;
+		desiredSpec.freq = m_desiredSampleRate;
 		desiredSpec.format = AUDIO_F32;
 		desiredSpec.channels = 2;    /* 1 = mono, 2 = stereo */
-		desiredSpec.samples = 1024;  /* Good low-latency value for callback */
+		desiredSpec.samples = m_desiredBufferSize;
 		desiredSpec.callback = (SDL_AudioCallback)&AudioOutput_Impl::FillBuffer;
 		desiredSpec.userdata = this;
 
@@ -95,11 +99,18 @@ public:
 			return false;
         }
 
+		Logf("Opened audio device with %d samples at %d Hz (requested %d samples at %d Hz)", Logger::Info,
+			m_audioSpec.samples, m_audioSpec.freq, m_desiredBufferSize, m_desiredSampleRate);
+
 		SDL_PauseAudioDevice(m_deviceId, 0);
 		return true;
 	}
-	bool Init()
+	bool Init(uint32 bufferSize, uint32 sampleRate)
 	{
+		if(bufferSize > 0)
+			m_desiredBufferSize = bufferSize;
+		if(sampleRate > 0)
+			m_desiredSampleRate = sampleRate;
 		OpenDevice(nullptr);
 		return true;
 	}
@@ -119,9 +130,9 @@ AudioOutput::~AudioOutput()
 {
 	delete m_impl;
 }
-bool AudioOutput::Init()
+bool AudioOutput::Init(uint32 bufferSize, uint32 sampleRate)
 {
-	return m_impl->Init();
+	return m_impl->Init(bufferSize, sampleRate);
 }
 uint32_t AudioOutput::GetNumChannels() const
 {
@@ -133,7 +144,14 @@ uint32_t AudioOutput::GetSampleRate() const
 }
 double AudioOutput::GetBufferLength() const
 {
-	return 0;
+	if(m_impl->m_audioSpec.freq == 0)
+		return 0;
+	return (double)m_impl->m_audioSpec.samples / (double)m_impl->m_audioSpec.freq;
+}
+double AudioOutput::GetLatency() const
+{
+	// SDL doesn't expose the driver's internal latency, the callback buffer is the part we control
+	return GetBufferLength();
 }
 void AudioOutput::Start(IMixer* mixer)
 {
@@ -0,0 +1,126 @@
+#include "stdafx.h"
+#include "AudioStats.hpp"
+
+// Limit of the first histogram bucket, every next bucket doubles it
+static const uint32 firstBucketLimit = 64000;
+
+void AudioStats::AddCallback(const AudioCallbackTiming& timing, bool realtime)
+{
+	uint64 index = m_numCallbacks.load(std::memory_order_relaxed);
+	m_history[index % historySize].Store(timing);
+
+	if(timing.duration > timing.budget)
+		m_Increment(m_numOverruns);
+
+	// Devices buffer at least one callback ahead, a gap of two callbacks means the buffer ran dry
+	if(realtime && m_lastStart != 0 && timing.start - m_lastStart > (int64)m_lastBudget * 2)
+		m_Increment(m_numUnderruns);
+	m_lastStart = timing.start;
+	m_lastBudget = timing.budget;
+
+	uint32 bucket = 0;
+	while(bucket < numBuckets - 1 && timing.duration >= GetBucketLimit(bucket))
+		bucket++;
+	m_Increment(m_buckets[bucket]);
+
+	// Published last, so readers never see a count that includes a record that isn't written yet
+	m_numCallbacks.store(index + 1, std::memory_order_release);
+}
+void AudioStats::AddDroppedCallback()
+{
+	m_Increment(m_numDropped);
+	// The next callback follows a gap that wasn't caused by the device
+	m_lastStart = 0;
+}
+void AudioStats::AddBypassedBlock()
+{
+	m_Increment(m_numBypassed);
+}
+void AudioStats::AddDroppedItem()
+{
+	m_Increment(m_numDroppedItems);
+}
+uint64 AudioStats::GetNumCallbacks() const
+{
+	return m_numCallbacks.load(std::memory_order_acquire);
+}
+uint64 AudioStats::GetNumOverruns() const
+{
+	return m_numOverruns.load(std::memory_order_relaxed);
+}
+uint64 AudioStats::GetNumUnderruns() const
+{
+	return m_numUnderruns.load(std::memory_order_relaxed);
+}
+uint64 AudioStats::GetNumDroppedCallbacks() const
+{
+	return m_numDropped.load(std::memory_order_relaxed);
+}
+uint64 AudioStats::GetNumBypassedBlocks() const
+{
+	return m_numBypassed.load(std::memory_order_relaxed);
+}
+uint64 AudioStats::GetNumDroppedItems() const
+{
+	return m_numDroppedItems.load(std::memory_order_relaxed);
+}
+uint64 AudioStats::GetBucket(uint32 index) const
+{
+	assert(index < numBuckets);
+	return m_buckets[index].load(std::memory_order_relaxed);
+}
+uint32 AudioStats::GetBucketLimit(uint32 index)
+{
+	return firstBucketLimit << index;
+}
+uint32 AudioStats::GetRecentCallbacks(AudioCallbackTiming* out, uint32 maxCount) const
+{
+	// Records older than the history might be overwritten while they are copied, so stay a bit behind the writer
+	uint64 end = GetNumCallbacks();
+	uint64 available = Math::Min<uint64>(end, historySize - 8);
+	uint32 count = (uint32)Math::Min<uint64>(available, maxCount);
+	for(uint32 i = 0; i < count; i++)
+	{
+		out[i] = m_history[(end - count + i) % historySize].Load();
+	}
+	return count;
+}
+AudioStats::Summary AudioStats::Summarize(uint32 numCallbacks) const
+{
+	AudioCallbackTiming timings[historySize];
+	Summary summary;
+	summary.numCallbacks = GetRecentCallbacks(timings, Math::Min(numCallbacks, historySize));
+	if(summary.numCallbacks == 0)
+		return summary;
+
+	uint64 total = 0;
+	uint32 max = 0;
+	for(uint32 i = 0; i < summary.numCallbacks; i++)
+	{
+		total += timings[i].duration;
+		max = Math::Max(max, timings[i].duration);
+	}
+	summary.averageDuration = (double)total / (double)summary.numCallbacks * 1e-6;
+	summary.maxDuration = (double)max * 1e-6;
+	summary.budget = (double)timings[summary.numCallbacks - 1].budget * 1e-6;
+	return summary;
+}
+void AudioStats::Log() const
+{
+	Summary summary = Summarize(historySize);
+	Logf("Audio callbacks: %d, overruns: %d, underruns: %d, dropped: %d, bypassed blocks: %d, dropped items: %d", Logger::Info,
+		(uint32)GetNumCallbacks(), (uint32)GetNumOverruns(), (uint32)GetNumUnderruns(), (uint32)GetNumDroppedCallbacks(), (uint32)GetNumBypassedBlocks(),
+		(uint32)GetNumDroppedItems());
+	Logf("Audio callback time (last %d): %.3f ms average, %.3f ms max, %.3f ms budget", Logger::Info,
+		summary.numCallbacks, summary.averageDuration, summary.maxDuration, summary.budget);
+	for(uint32 i = 0; i < numBuckets; i++)
+	{
+		uint32 count = (uint32)GetBucket(i);
+		if(count == 0)
+			continue;
+		if(i < numBuckets - 1)
+			Logf("  < %.3f ms: %d", Logger::Info, (double)GetBucketLimit(i) * 1e-6, count);
+		else
+			Logf(" >= %.3f ms: %d", Logger::Info, (double)GetBucketLimit(i - 1) * 1e-6, count);
+	}
+}
@@ -2,10 +2,20 @@
 #include "AudioStream.hpp"
 #include "Audio.hpp"
 #include "Audio_Impl.hpp"
+#include "AudioStreamBase.hpp"
 
 class AudioStreamRes* CreateAudioStream_ogg(class Audio* audio, const String& path, bool preload);
 class AudioStreamRes* CreateAudioStream_mp3(class Audio* audio, const String& path, bool preload);
 class AudioStreamRes* CreateAudioStream_wav(class Audio* audio, const String& path, bool preload);
+class AudioStreamRes* CreateAudioStream_pcm(class Audio* audio, Ref<PCMSegment> segment);
+
+// Start decoding before the mixer can see the stream
+static AudioStream RegisterAudioStream(class Audio* audio, AudioStreamRes* impl)
+{
+	audio->GetImpl()->RegisterStream(static_cast<AudioStreamBase*>(impl));
+	audio->GetImpl()->Register(impl);
+	return AudioStream(impl);
+}
 
 Ref<AudioStreamRes> AudioStreamRes::Create(class Audio* audio, const String& path, bool preload)
 {
@@ -41,6 +51,20 @@ Ref<AudioStreamRes> AudioStreamRes::Create(class Audio* audio, const String& pat
 	if(!impl)
 		return AudioStream();
 
-	audio->GetImpl()->Register(impl);
-	return AudioStream(impl);
+	return RegisterAudioStream(audio, impl);
+}
+Ref<AudioStreamRes> AudioStreamRes::CreateCached(class Audio* audio, const String& path, int32 startTime, int32 duration)
+{
+	// Play directly from the cache without touching the original file
+	Ref<PCMSegment> segment = audio->GetImpl()->cache.Find(path, startTime, duration);
+	if(segment)
+	{
+		AudioStreamRes* impl = CreateAudioStream_pcm(audio, std::move(segment));
+		return RegisterAudioStream(audio, impl);
+	}
+
+	AudioStream stream = Create(audio, path, false);
+	if(stream)
+		static_cast<AudioStreamBase*>(stream.GetData())->CacheRange(startTime, duration);
+	return stream;
 }
\ No newline at end of file
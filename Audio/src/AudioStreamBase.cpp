@@ -1,16 +1,31 @@
 #include "stdafx.h"
 #include "AudioStreamBase.hpp"
-
-// Fixed point format for resampling
-const uint64 AudioStreamBase::fp_sampleStep = 1ull << 48;
+#include "AudioKernels.hpp"
 
 BinaryStream& AudioStreamBase::Reader()
 {
 	return m_preloaded ? (BinaryStream&)m_memoryReader : (BinaryStream&)m_fileReader;
 }
+// Number of frames decoded ahead of the mixer
+static const uint32 decodeAheadFrames = 32768;
+
+AudioStreamBase::~AudioStreamBase()
+{
+	if(m_readBuffer)
+	{
+		for(uint32 c = 0; c < m_numChannels; c++)
+		{
+			delete[] m_readBuffer[c];
+		}
+		delete[] m_readBuffer;
+	}
+	delete[] m_interleaveBuffer;
+	delete[] m_resampleBuffer;
+}
 bool AudioStreamBase::Init(Audio* audio, const String& path, bool preload)
 {
 	m_audio = audio;
+	m_path = path;
 
 	if(!m_file.OpenRead(path))
 		return false;
@@ -32,10 +47,9 @@ bool AudioStreamBase::Init(Audio* audio, const String& path, bool preload)
 }
 void AudioStreamBase::InitSampling(uint32 sampleRate)
 {
-	// Calculate the sample step if the rate is not the same as the output rate
-	double sampleStep = (double)sampleRate / (double)m_audio->GetSampleRate();
-	m_sampleStepIncrement = (uint64)(sampleStep * (double)fp_sampleStep);
-	double stepCheck = (double)m_sampleStepIncrement / (double)fp_sampleStep;
+	// Decoded data is converted to the output rate on the decode thread
+	m_resampler.Init(sampleRate, m_audio->GetSampleRate());
+	m_sampleStep = m_resampler.GetRatio();
 
 	m_numChannels = 2;
 	m_readBuffer = new float*[m_numChannels];
@@ -43,6 +57,34 @@ void AudioStreamBase::InitSampling(uint32 sampleRate)
 	{
 		m_readBuffer[c] = new float[m_bufferSize];
 	}
+	m_interleaveBuffer = new float[m_bufferSize * 2];
+	m_resampleBuffer = new float[m_bufferSize * 2];
+	m_decodedData.Init(decodeAheadFrames * 2);
+}
+void AudioStreamBase::CacheRange(int32 startTime, int32 duration)
+{
+	AudioCache& cache = m_audio->GetImpl()->cache;
+
+	m_lock.lock();
+	cache.Release(m_cachedSegment);
+	cache.Release(m_capture);
+	m_cachedSegment = cache.Find(m_path, startTime, duration);
+	if(!m_cachedSegment)
+	{
+		uint32 rate = (uint32)GetStreamRate_Internal();
+		m_capture = Ref<PCMSegment>(new PCMSegment());
+		m_capture->path = m_path;
+		m_capture->startTime = startTime;
+		m_capture->duration = duration;
+		m_capture->sampleRate = rate;
+		m_capture->startSample = (int64)((double)startTime / 1000.0 * (double)rate);
+		m_captureFrames = (uint32)((double)duration / 1000.0 * (double)rate);
+		// Allocate everything up front so the decode thread doesn't reallocate while capturing
+		m_capture->data.reserve(m_captureFrames * 2);
+	}
+	m_lock.unlock();
+
+	SetPosition(startTime);
 }
 
 void AudioStreamBase::Play()
@@ -54,22 +96,13 @@ void AudioStreamBase::Play()
 	if(m_paused)
 	{
 		m_paused = false;
-		RestartTiming();
+		m_positionGeneration++;
 	}
 }
 void AudioStreamBase::Pause()
 {
-	if(!m_paused)
-	{
-		// Store time the stream was paused
-		m_streamTimeOffset = m_streamTimer.SecondsAsDouble();
-		m_paused = true;
-	}
-	else
-	{
-		m_paused = false;
-		RestartTiming();
-	}
+	m_paused = !m_paused.load();
+	m_positionGeneration++;
 }
 bool AudioStreamBase::HasEnded() const
 {
@@ -83,131 +116,243 @@ double AudioStreamBase::SamplesToSeconds(int64 s) const
 {
 	return (double)s / (double)const_cast<AudioStreamBase*>(this)->GetStreamRate_Internal();
 }
-double AudioStreamBase::GetPositionSeconds(bool allowFreezeSkip /*= true*/) const
+double AudioStreamBase::GetPositionSeconds() const
 {
-	double samplePosTime = SamplesToSeconds(m_samplePos);
-	if(m_paused || m_samplePos < 0)
-		return samplePosTime;
-	else
-	{
-		double ret = m_streamTimeOffset + m_streamTimer.SecondsAsDouble() - m_offsetCorrection;
-		if(allowFreezeSkip && (ret - samplePosTime) > 0.2f) // Prevent time from running of when the application freezes
-			return samplePosTime;
-		return ret;
-	}
+	// The mixer didn't apply the last seek yet
+	if(m_seekRequest.load(std::memory_order_acquire) != m_seekAcknowledged.load(std::memory_order_acquire))
+		return SamplesToSeconds(m_seekPosition.load());
+
+	if(m_paused || !m_playing)
+		return SamplesToSeconds(m_samplePos);
+
+	// Nothing rendered since the last seek, the stream is still at the position that was set
+	PositionSnapshot snapshot = m_position.Load();
+	if(snapshot.generation != m_positionGeneration.load(std::memory_order_acquire))
+		return SamplesToSeconds(m_samplePos);
+
+	// Advance from the start of the last block to the sample that is being output right now
+	double outputPosition = m_audio->GetImpl()->GetOutputPosition();
+	double streamPosition = snapshot.streamPosition + (outputPosition - (double)snapshot.blockOutputPosition) * snapshot.sampleStep;
+	return streamPosition / (double)const_cast<AudioStreamBase*>(this)->GetStreamRate_Internal();
 }
 int32 AudioStreamBase::GetPosition() const
 {
-	return (int32)(GetPositionSeconds() * 1000.0);
+	double pos = GetPositionSeconds();
+	// Report the position that is being heard right now instead of the one being mixed
+	Audio_Impl* impl = m_audio->GetImpl();
+	if(impl->compensateLatency)
+		pos -= impl->outputLatency;
+	return (int32)(pos * 1000.0);
 }
 void AudioStreamBase::SetPosition(int32 pos)
 {
+	// Negative positions are allowed, the decoder starts at 0 and the mixer outputs silence until then
+	int64 samplePos = (int64)((double)pos / 1000.0 * (double)GetStreamRate_Internal());
+
 	m_lock.lock();
 	m_remainingBufferData = 0;
-	m_samplePos = SecondsToSamples((double)pos / 1000.0);
-	SetPosition_Internal((int32)m_samplePos);
+	// Decode a few frames before the position as well, so the resampler has something to filter the first frames with
+	int64 decodeStart = Math::Max<int64>(samplePos, 0);
+	uint32 history = (uint32)Math::Min<int64>(decodeStart, m_resampler.GetMaxHistory());
+	decodeStart -= history;
+	m_decodePosition = decodeStart;
+	if(m_cachedSegment && decodeStart >= m_cachedSegment->startSample && decodeStart < m_cachedSegment->GetEndSample())
+	{
+		// Played from the cached range, the decoder is moved to the end of the range once it's needed
+		m_decodeSkip = 0;
+	}
+	else
+	{
+		SetPosition_Internal((int32)decodeStart);
+		m_decodeSkip = Math::Max<int64>(0, decodeStart - GetStreamPosition_Internal());
+	}
+	m_resampler.Reset(history);
+	m_decodeEnded = false;
 	m_ended = false;
+	m_endLogged = false;
+	m_seekPosition = samplePos;
+	m_seekRequest++;
+	m_positionGeneration++;
 	m_lock.unlock();
 }
-void AudioStreamBase::RestartTiming()
-{
-	m_streamTimeOffset = SamplesToSeconds(m_samplePos); // Add audio latency to this offset
-	m_samplePos = 0;
-	m_streamTimer.Restart();
-	m_offsetCorrection = 0.0f;
-	m_deltaSum = 0;
-	m_deltaSamples = 0;
-}
-void AudioStreamBase::Process(float* out, uint32 numSamples)
+bool AudioStreamBase::DecodeAhead()
 {
-	if(!m_playing || m_paused)
-		return;
-
+	bool decoded = false;
 	m_lock.lock();
 
-	uint32 outCount = 0;
-	while(outCount < numSamples)
+	if(m_ended.load(std::memory_order_relaxed) && !m_endLogged)
+	{
+		Logf("Audio stream ended", Logger::Info);
+		m_endLogged = true;
+	}
+
+	// Don't write anything until the mixer has thrown away the data from before the last seek
+	bool seekPending = m_seekRequest.load(std::memory_order_acquire) != m_seekAcknowledged.load(std::memory_order_acquire);
+	if(m_readBuffer && !seekPending && !m_decodeEnded)
 	{
-		if(m_remainingBufferData > 0)
+		while(true)
 		{
-			uint32 idxStart = (m_currentBufferSize - m_remainingBufferData);
-			uint32 readOffset = 0; // Offset from the start to read from
-			for(uint32 i = 0; outCount < numSamples && readOffset < m_remainingBufferData; i++)
+			uint32 freeFrames = Math::Min((uint32)(m_decodedData.GetWriteAvailable() / 2), m_bufferSize);
+			if(freeFrames == 0)
+				break;
+
+			// Copy from the cached range instead of decoding
+			const PCMSegment* cached = m_cachedSegment ? m_cachedSegment.GetData() : nullptr;
+			if(cached && m_decodePosition >= cached->startSample && m_decodePosition < cached->GetEndSample())
 			{
-				if(m_samplePos < 0)
+				uint32 offset = (uint32)(m_decodePosition - cached->startSample);
+				uint32 count = Math::Min(m_bufferSize, cached->GetNumFrames() - offset);
+				AudioKernels::Int16ToFloat(m_interleaveBuffer, cached->data.data() + offset * 2, count * 2);
+
+				uint32 used = 0;
+				uint32 numOutput = m_resampler.Process(m_resampleBuffer, freeFrames, m_interleaveBuffer, count, used);
+				m_decodedData.Write(m_resampleBuffer, numOutput * 2);
+				m_decodePosition += used;
+				decoded = true;
+
+				// Continue decoding after the cached range
+				if(m_decodePosition == cached->GetEndSample())
 				{
-					out[outCount * 2] = 0.0f;
-					out[outCount * 2 + 1] = 0.0f;
+					m_remainingBufferData = 0;
+					SetPosition_Internal((int32)m_decodePosition);
+					m_decodeSkip = Math::Max<int64>(0, m_decodePosition - GetStreamPosition_Internal());
 				}
-				else
+				continue;
+			}
+
+			if(m_remainingBufferData == 0)
+			{
+				if(DecodeData_Internal() <= 0)
 				{
-					out[outCount * 2] = m_readBuffer[0][idxStart + readOffset];
-					out[outCount * 2 + 1] = m_readBuffer[1][idxStart + readOffset];
+					// Stream ended inside of the captured range
+					if(m_capture && m_capture->GetNumFrames() > 0 && m_capture->GetEndSample() == m_decodePosition)
+						m_FinishCapture();
+					m_decodeEnded.store(true, std::memory_order_release);
+					break;
 				}
-				outCount++;
+				decoded = true;
 
-				// Increment source sample with resampling
-				m_sampleStep += m_sampleStepIncrement;
-				while(m_sampleStep >= fp_sampleStep)
+				if(m_decodeSkip > 0)
 				{
-					m_sampleStep -= fp_sampleStep;
-					if(m_samplePos >= 0)
-						readOffset++;
-					m_samplePos++;
+					uint32 skipped = (uint32)Math::Min<int64>(m_decodeSkip, m_remainingBufferData);
+					m_remainingBufferData -= skipped;
+					m_decodeSkip -= skipped;
+					continue;
 				}
 			}
-			m_remainingBufferData -= readOffset;
-		}
 
-		if(outCount >= numSamples)
-			break;
+			// Whatever the resampler doesn't use stays in the read buffer for next time
+			uint32 idxStart = m_currentBufferSize - m_remainingBufferData;
+			uint32 count = Math::Min(m_remainingBufferData, m_bufferSize);
+			AudioKernels::Interleave(m_interleaveBuffer, m_readBuffer[0] + idxStart, m_readBuffer[1] + idxStart, count);
 
-		// Read more data
-		if(DecodeData_Internal() <= 0)
-		{
-			// Ended
-			Logf("Audio stream ended", Logger::Info);
-			m_ended = true;
-			m_playing = false;
-			break;
+			uint32 used = 0;
+			uint32 numOutput = m_resampler.Process(m_resampleBuffer, freeFrames, m_interleaveBuffer, count, used);
+			m_decodedData.Write(m_resampleBuffer, numOutput * 2);
+			m_CaptureFrames(m_interleaveBuffer, used);
+			m_decodePosition += used;
+			m_remainingBufferData -= used;
 		}
 	}
 
-	// Store timing info
-	if(m_samplePos > 0)
+	m_lock.unlock();
+	return decoded;
+}
+void AudioStreamBase::Deregister()
+{
+	// Make sure the decode thread is done with this stream before the implementation's decoder is destroyed
+	if(m_audio)
 	{
-		m_samplePos = GetStreamPosition_Internal() - m_remainingBufferData;
-		if(m_samplePos >= m_samplesTotal)
-		{
-			if(!m_ended)
-			{
-				// Ended
-				Logf("Audio stream ended", Logger::Info);
-				m_ended = true;
-			}
-		}
+		Audio_Impl* impl = m_audio->GetImpl();
+		impl->DeregisterStream(this);
+		impl->cache.Release(m_cachedSegment);
+		impl->cache.Release(m_capture);
+	}
+	AudioBase::Deregister();
+}
+void AudioStreamBase::m_CaptureFrames(const float* data, uint32 numFrames)
+{
+	if(!m_capture)
+		return;
 
-		double timingDelta = GetPositionSeconds(false) - SamplesToSeconds(m_samplePos);
-		m_deltaSum += timingDelta;
-		m_deltaSamples += 1;
+	int64 captureEnd = m_capture->startSample + m_captureFrames;
+	int64 first = Math::Max(m_decodePosition, m_capture->startSample);
+	int64 last = Math::Min(m_decodePosition + numFrames, captureEnd);
+	if(first >= last)
+		return;
 
-		double avgDelta = m_deltaSum / (double)m_deltaSamples;
-		if(abs(timingDelta - avgDelta) > 0.2)
-		{
-			Logf("Timing restart, delta = %f", Logger::Info, avgDelta);
-			RestartTiming();
-		}
-		else
+	// Only contiguous data can be captured, give up if the stream was moved somewhere else
+	if(first != m_capture->GetEndSample())
+	{
+		m_audio->GetImpl()->cache.Release(m_capture);
+		return;
+	}
+
+	size_t offset = m_capture->data.size();
+	uint32 count = (uint32)(last - first);
+	m_capture->data.resize(offset + count * 2);
+	AudioKernels::FloatToInt16(m_capture->data.data() + offset, data + (first - m_decodePosition) * 2, count * 2);
+
+	if(m_capture->GetEndSample() == captureEnd)
+		m_FinishCapture();
+}
+void AudioStreamBase::m_FinishCapture()
+{
+	AudioCache& cache = m_audio->GetImpl()->cache;
+	cache.Add(m_capture);
+	cache.Release(m_capture);
+}
+void AudioStreamBase::Process(float* out, uint32 numSamples)
+{
+	// Apply seeks from the game, everything decoded before the seek is thrown away
+	uint32 seekRequest = m_seekRequest.load(std::memory_order_acquire);
+	if(seekRequest != m_seekAcknowledged.load(std::memory_order_relaxed))
+	{
+		m_decodedData.Skip(m_decodedData.GetReadAvailable());
+		m_mixStart = m_seekPosition.load();
+		m_mixedFrames = 0;
+		m_samplePos.store(m_mixStart, std::memory_order_relaxed);
+		m_seekAcknowledged.store(seekRequest, std::memory_order_release);
+	}
+
+	if(!m_playing.load(std::memory_order_relaxed) || m_paused.load(std::memory_order_relaxed))
+		return;
+
+	// Publish where this block starts, the game interpolates from here using the output clock
+	PositionSnapshot snapshot;
+	snapshot.blockOutputPosition = m_audio->GetImpl()->GetBlockOutputPosition();
+	snapshot.streamPosition = (double)m_mixStart + (double)m_mixedFrames * m_sampleStep;
+	snapshot.sampleStep = m_sampleStep;
+	snapshot.generation = m_positionGeneration.load(std::memory_order_relaxed);
+	m_position.Store(snapshot);
+
+	// Output silence before the start of the stream
+	uint32 outCount = 0;
+	if(m_mixStart < 0)
+	{
+		int64 silentFrames = (int64)ceil((double)-m_mixStart / m_sampleStep);
+		if(m_mixedFrames < silentFrames)
+			outCount = (uint32)Math::Min<int64>(numSamples, silentFrames - m_mixedFrames);
+	}
+
+	// Decoded frames are already at the output rate
+	outCount += (uint32)(m_decodedData.Read(out + outCount * 2, (numSamples - outCount) * 2) / 2);
+	m_mixedFrames += outCount;
+	int64 samplePos = m_mixStart + (int64)((double)m_mixedFrames * m_sampleStep);
+	m_samplePos.store(samplePos, std::memory_order_relaxed);
+
+	// Ran out of decoded data, either the stream ended or the decoder is behind
+	if(outCount < numSamples)
+	{
+		bool decodeEnded = m_decodeEnded.load(std::memory_order_acquire);
+		if(decodeEnded && m_decodedData.GetReadAvailable() == 0)
 		{
-			if(fabs(avgDelta) > 0.001f)
-			{
-				// Fine tune timing
-				double step = abs(avgDelta) * 0.1f;
-				step = Math::Min(step, fabs(timingDelta)) * Math::Sign(timingDelta);
-				m_offsetCorrection += step;
-			}
+			m_ended = true;
+			m_playing = false;
 		}
 	}
-
-	m_lock.unlock();
+	if(samplePos >= m_samplesTotal)
+	{
+		m_ended = true;
+	}
 }
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 #include "AudioStreamBase.hpp"
+#include "AudioKernels.hpp"
+#include "SeekIndex.hpp"
 extern "C"
 {
 	#include "minimp3.h"
@@ -7,15 +9,15 @@ extern "C"
 
 class AudioStreamMP3_Impl : public AudioStreamBase
 {
-	mp3_decoder_t* m_decoder;
+	mp3_decoder_t* m_decoder = nullptr;
 	size_t m_mp3dataOffset = 0;
 	size_t m_mp3dataLength = 0;
 	int32 m_mp3samplePosition = 0;
 	int32 m_samplingRate = 0;
 	uint8* m_dataSource = 0;
 
-	Map<int32, size_t> m_frameIndices;
-	uint32 m_largetsFrameIndex;
+	// Sample positions of all frames in the file
+	SeekIndex m_seekIndex;
 
 	bool m_firstFrame = true;
 
@@ -42,34 +44,10 @@ class AudioStreamMP3_Impl : public AudioStreamBase
 
 	}
 
-public:
-	~AudioStreamMP3_Impl()
+	// Builds the seek index by walking over all frame headers in the file
+	bool m_ScanFrames(int32 tagSize)
 	{
-		Deregister();
-		mp3_done(m_decoder);
-	}
-	bool Init(Audio* audio, const String& path, bool preload)
-	{
-		if(!AudioStreamBase::Init(audio, path, true)) // Always preload for now
-			return false;
-
-		// Always use preloaded data
-		m_mp3dataLength = Reader().GetSize();
-		m_dataSource = m_data.data();
-
-		int32 tagSize = 0;
-
-		String tag = "tag";
-		for (size_t i = 0; i < 3; i++)
-		{
-			tag[i] = m_dataSource[i];
-		}
-		if (tag == "ID3")
-		{
-			/// TODO: Check if tag has footer and add another 10 to the size
-			tagSize = m_unsynchsafe(m_toLittleEndian(*(int32*)(m_dataSource + 6))) + 10;
-		}
-		// Scan MP3 frame offsets
+		m_seekIndex.Clear();
 		uint32 sampleOffset = 0;
 		for(size_t i = tagSize; i < m_mp3dataLength;)
 		{
@@ -110,16 +88,56 @@ public:
 					
 					i += frameLength;
 					uint32 frameSamples = (linearVersion == 0) ? 1152 : 576;
-					m_frameIndices.Add((int32)sampleOffset, i);
+					// Positions map to the end of the frame, so the first frame (usually the Xing/Info header) is never played
+					m_seekIndex.Add(sampleOffset, i);
 					sampleOffset += frameSamples;
 					continue; // Skip header
 				}
 			}
 			i++;
 		}
+		m_seekIndex.samplesTotal = sampleOffset;
+		return true;
+	}
+
+public:
+	~AudioStreamMP3_Impl()
+	{
+		Deregister();
+		if(m_decoder)
+			mp3_done(m_decoder);
+	}
+	bool Init(Audio* audio, const String& path, bool preload)
+	{
+		if(!AudioStreamBase::Init(audio, path, true)) // Always preload for now
+			return false;
+
+		// Always use preloaded data
+		m_mp3dataLength = Reader().GetSize();
+		m_dataSource = m_data.data();
+
+		int32 tagSize = 0;
+
+		String tag = "tag";
+		for (size_t i = 0; i < 3; i++)
+		{
+			tag[i] = m_dataSource[i];
+		}
+		if (tag == "ID3")
+		{
+			/// TODO: Check if tag has footer and add another 10 to the size
+			tagSize = m_unsynchsafe(m_toLittleEndian(*(int32*)(m_dataSource + 6))) + 10;
+		}
+		// Scan MP3 frame offsets, or use the cached result from a previous scan
+		if(!m_seekIndex.Load(path))
+		{
+			if(!m_ScanFrames(tagSize))
+				return false;
+			m_seekIndex.Save(path);
+		}
 
 		// No mp3 frames found
-		if(m_frameIndices.empty())
+		if(m_seekIndex.IsEmpty())
 		{
 			Logf("No valid mp3 frames found in file \"%s\"", Logger::Warning, path);
 			return false;
@@ -128,7 +146,7 @@ public:
 		SetPosition_Internal(0);
 
 		// Total sample
-		m_samplesTotal = sampleOffset;
+		m_samplesTotal = m_seekIndex.samplesTotal;
 
 		m_decoder = (mp3_decoder_t*)mp3_create();
 		int32 r = DecodeData_Internal();
@@ -139,16 +157,10 @@ public:
 	}
 	virtual void SetPosition_Internal(int32 pos)
 	{
-		auto it = m_frameIndices.lower_bound(pos);
-		if(it == m_frameIndices.end())
-		{
-			--it; // Take the last frame
-		}
-		if(it != m_frameIndices.end())
-		{
-			m_mp3samplePosition = it->first;
-			m_mp3dataOffset = it->second;
-		}
+		// Start at the frame containing pos
+		int32 index = Math::Max(m_seekIndex.Find(pos), 0);
+		m_mp3samplePosition = (int32)m_seekIndex[index].sample;
+		m_mp3dataOffset = (size_t)m_seekIndex[index].offset;
 	}
 	virtual int32 GetStreamPosition_Internal()
 	{
@@ -186,18 +198,14 @@ public:
 		}
 
 		// Copy data to read buffer
-		for(int32 i = 0; i < samplesGotten; i++)
+		if(info.channels == 1)
 		{
-			if(info.channels == 1)
-			{
-				m_readBuffer[0][i] = (float)buffer[i] / (float)0x7FFF;
-				m_readBuffer[1][i] = m_readBuffer[0][i];
-			}
-			else if(info.channels == 2)
-			{
-				m_readBuffer[0][i] = (float)buffer[i * 2 + 0] / (float)0x7FFF;
-				m_readBuffer[1][i] = (float)buffer[i * 2 + 1] / (float)0x7FFF;
-			}
+			AudioKernels::Int16ToFloat(m_readBuffer[0], buffer, samplesGotten);
+			memcpy(m_readBuffer[1], m_readBuffer[0], sizeof(float) * samplesGotten);
+		}
+		else if(info.channels == 2)
+		{
+			AudioKernels::Int16ToPlanar(m_readBuffer[0], m_readBuffer[1], buffer, samplesGotten);
 		}
 		m_currentBufferSize = samplesGotten;
 		m_remainingBufferData = samplesGotten;
@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "AudioStreamBase.hpp"
+#include "SeekIndex.hpp"
 #include <vorbis/vorbisfile.h>
 
 class AudioStreamOGG_Impl : public AudioStreamBase
@@ -15,6 +16,9 @@ class AudioStreamOGG_Impl : public AudioStreamBase
 
 	vorbis_info* m_info;
 
+	// Byte offsets of the ogg pages, indexed by the first sample on the page
+	SeekIndex m_seekIndex;
+
 public:
 	~AudioStreamOGG_Impl()
 	{
@@ -38,6 +42,13 @@ public:
 			return false;
 
 		m_samplesTotal = ov_pcm_total(&m_ovf, 0);
+
+		if(!m_seekIndex.Load(path))
+		{
+			m_ScanPages();
+			m_seekIndex.Save(path);
+		}
+
 		InitSampling(m_info->rate);
 
 		return true;
@@ -45,6 +56,15 @@ public:
 
 	virtual void SetPosition_Internal(int32 pos)
 	{
+		// Jump straight to a page before pos instead of letting vorbisfile bisect the file
+		//	the page before that is used because the first packet after a raw seek only primes the decoder
+		int32 index = m_seekIndex.Find(pos) - 1;
+		if(index >= 0 && ov_raw_seek(&m_ovf, (ogg_int64_t)m_seekIndex[index].offset) == 0)
+		{
+			ogg_int64_t current = ov_pcm_tell(&m_ovf);
+			if(current >= 0 && current <= pos)
+				return;
+		}
 		ov_pcm_seek(&m_ovf, pos);
 	}
 	virtual int32 GetStreamPosition_Internal()
@@ -61,24 +81,9 @@ public:
 		int32 r = ov_read_float(&m_ovf, &readBuffer, m_bufferSize, 0);
 		if(r > 0)
 		{
-			if(m_info->channels == 1)
-			{
-				// Copy mono to read buffer
-				for(int32 i = 0; i < r; i++)
-				{
-					m_readBuffer[0][i] = readBuffer[0][i];
-					m_readBuffer[1][i] = readBuffer[0][i];
-				}
-			}
-			else
-			{
-				// Copy data to read buffer
-				for(int32 i = 0; i < r; i++)
-				{
-					m_readBuffer[0][i] = readBuffer[0][i];
-					m_readBuffer[1][i] = readBuffer[1][i];
-				}
-			}
+			// Copy data to read buffer, mono is copied to both channels
+			memcpy(m_readBuffer[0], readBuffer[0], sizeof(float) * r);
+			memcpy(m_readBuffer[1], readBuffer[m_info->channels == 1 ? 0 : 1], sizeof(float) * r);
 			m_currentBufferSize = r;
 			m_remainingBufferData = r;
 			return r;
@@ -86,19 +91,58 @@ public:
 		else if(r == 0)
 		{
 			// EOF
-			m_playing = false;
 			return -1;
 		}
 		else
 		{
 			// Error
-			m_playing = false;
 			Logf("Ogg Stream error %d", Logger::Warning, r);
 			return -1;
 		}
 	}
 
 private:
+	// Builds the seek index from the ogg page headers
+	void m_ScanPages()
+	{
+		m_seekIndex.Clear();
+		m_seekIndex.samplesTotal = m_samplesTotal;
+
+		size_t readerPos = Reader().Tell();
+		size_t fileSize = Reader().GetSize();
+		size_t offset = 0;
+		int64 pageStart = 0;
+		while(offset + 27 <= fileSize)
+		{
+			uint8 header[27 + 255];
+			Reader().Seek(offset);
+			if(Reader().Serialize(header, 27) != 27 || memcmp(header, "OggS", 4) != 0)
+				break;
+			uint32 numSegments = header[26];
+			if(Reader().Serialize(header + 27, numSegments) != numSegments)
+				break;
+
+			uint32 bodySize = 0;
+			for(uint32 i = 0; i < numSegments; i++)
+			{
+				bodySize += header[27 + i];
+			}
+
+			// Granule position of the last sample that ends on this page, -1 if no packet ends here
+			int64 granule;
+			memcpy(&granule, header + 6, sizeof(granule));
+			if(granule > pageStart)
+			{
+				m_seekIndex.Add(pageStart, offset);
+				pageStart = granule;
+			}
+
+			offset += 27 + numSegments + bodySize;
+		}
+
+		Reader().Seek(readerPos);
+	}
+
 	static size_t m_Read(void* ptr, size_t size, size_t nmemb, AudioStreamOGG_Impl* self)
 	{
 		return self->Reader().Serialize(ptr, nmemb*size);
@@ -0,0 +1,60 @@
+#include "stdafx.h"
+#include "AudioStreamBase.hpp"
+
+/*
+	Stream that plays a segment from the audio cache, without opening or decoding the original file
+	Positions are the same as in the original stream, the segment's range is the only part that contains audio
+*/
+class AudioStreamPCM_Impl : public AudioStreamBase
+{
+private:
+	int32 m_streamPosition = 0;
+
+public:
+	~AudioStreamPCM_Impl()
+	{
+		Deregister();
+	}
+	bool Init(Audio* audio, Ref<PCMSegment> segment)
+	{
+		m_audio = audio;
+		m_path = segment->path;
+		m_samplesTotal = segment->GetEndSample();
+		m_cachedSegment = std::move(segment);
+		InitSampling(m_cachedSegment->sampleRate);
+
+		// Start at the beginning of the segment, so the decode thread can fill the buffer before the first seek
+		m_decodePosition = m_cachedSegment->startSample;
+		m_samplePos = m_cachedSegment->startSample;
+		m_mixStart = m_cachedSegment->startSample;
+		return true;
+	}
+	virtual int32 GetStreamPosition_Internal()
+	{
+		return m_streamPosition;
+	}
+	virtual int32 GetStreamRate_Internal()
+	{
+		return m_cachedSegment->sampleRate;
+	}
+	virtual void SetPosition_Internal(int32 pos)
+	{
+		m_streamPosition = pos;
+	}
+	// Anything outside of the segment is the end of the stream
+	virtual int32 DecodeData_Internal()
+	{
+		return -1;
+	}
+};
+
+class AudioStreamRes* CreateAudioStream_pcm(class Audio* audio, Ref<PCMSegment> segment)
+{
+	AudioStreamPCM_Impl* impl = new AudioStreamPCM_Impl();
+	if(!impl->Init(audio, std::move(segment)))
+	{
+		delete impl;
+		impl = nullptr;
+	}
+	return impl;
+}
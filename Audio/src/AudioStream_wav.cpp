@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "AudioStreamBase.hpp"
+#include "AudioKernels.hpp"
 
 struct WavHeader
 {
@@ -34,7 +35,16 @@ private:
 	WavFormat m_format = { 0 };
 
 
+	// Position in the data, in 16-bit samples for PCM and in bytes for ADPCM
 	uint64 m_playbackPointer = 0;
+	// Size of the encoded ADPCM data
+	uint64 m_dataLength = 0;
+
+	// Number of stereo frames in a single ADPCM block
+	uint32 m_GetFramesPerBlock() const
+	{
+		return 2 + (m_format.nBlockAlign - 14);
+	}
 
 	uint32 m_decode_ms_adpcm(const Buffer& encoded, Buffer* decoded, uint64 pos)
 	{
@@ -176,14 +186,15 @@ public:
 				// Read data
 				if (m_format.nFormat == 1)
 				{
-					m_samplesTotal = chunkHdr.nLength / sizeof(short);
+					m_samplesTotal = chunkHdr.nLength / (sizeof(short) * m_format.nChannels);
 					m_Internaldata.resize(chunkHdr.nLength);
 					m_memoryReader.Serialize(m_Internaldata.data(), chunkHdr.nLength);
 				}
 				else if (m_format.nFormat == 2)
 				{
-					m_samplesTotal = chunkHdr.nLength;
-					m_Internaldata.resize(m_samplesTotal * m_format.nChannels * sizeof(short));
+					m_dataLength = chunkHdr.nLength;
+					m_samplesTotal = (chunkHdr.nLength / m_format.nBlockAlign) * m_GetFramesPerBlock();
+					m_Internaldata.resize(chunkHdr.nLength * m_format.nChannels * sizeof(short));
 					m_memoryReader.Serialize(m_Internaldata.data(), chunkHdr.nLength);
 				}
 			}
@@ -197,85 +208,66 @@ public:
 		m_playbackPointer = 0;
 		return true;
 	}
+	// Positions are in sample frames, ADPCM can only seek to the start of a block
 	virtual int32 GetStreamPosition_Internal()
 	{
-		return m_playbackPointer;
+		if (m_format.nFormat == 2)
+			return (int32)(m_playbackPointer / m_format.nBlockAlign * m_GetFramesPerBlock());
+		else
+			return (int32)(m_playbackPointer / m_format.nChannels);
 	}
 	virtual int32 GetStreamRate_Internal()
 	{
-		if (m_format.nFormat == 2)
-			return m_format.nByteRate;
-		else
-			return m_format.nSampleRate * m_format.nChannels;
+		return m_format.nSampleRate;
 	}
 	virtual void SetPosition_Internal(int32 pos)
 	{
-		if(pos > 0)
-			m_playbackPointer = pos;
+		uint64 frame = (uint64)Math::Min<int64>(Math::Max(pos, 0), m_samplesTotal);
+		if (m_format.nFormat == 2)
+			m_playbackPointer = (frame / m_GetFramesPerBlock()) * m_format.nBlockAlign;
 		else
-			m_playbackPointer = 0;
+			m_playbackPointer = frame * m_format.nChannels;
 	}
 
 	virtual int32 DecodeData_Internal()
 	{
 		if (m_format.nFormat == 1)
 		{
-			uint32 samplesPerRead = 128;
+			uint32 samplesPerRead = m_bufferSize;
+
+			// Clamp to the remaining data
+			uint64 totalSamples = (uint64)m_samplesTotal * m_format.nChannels;
+			uint64 remaining = (m_playbackPointer < totalSamples) ? (totalSamples - m_playbackPointer) / m_format.nChannels : 0;
+			uint32 count = (uint32)Math::Min((uint64)samplesPerRead, remaining);
 
+			int16* src = ((int16*)m_Internaldata.data()) + m_playbackPointer;
 			if (m_format.nChannels == 2)
 			{
-				for (uint32 i = 0; i < samplesPerRead; i++)
-				{
-					if (m_playbackPointer >= m_samplesTotal)
-					{
-						m_currentBufferSize = samplesPerRead;
-						m_remainingBufferData = samplesPerRead;
-						return i;
-					}
-
-					int16* src = ((int16*)m_Internaldata.data()) + m_playbackPointer;
-					m_readBuffer[0][i] = (float)src[0] / (float)0x7FFF;
-					m_readBuffer[1][i] = (float)src[1] / (float)0x7FFF;
-					m_playbackPointer+=2;
-
-				}
+				AudioKernels::Int16ToPlanar(m_readBuffer[0], m_readBuffer[1], src, count);
 			}
 			else
 			{
 				// Mix mono sample
-				for (uint32 i = 0; i < samplesPerRead; i++)
-				{
-					if (m_playbackPointer >= m_samplesTotal)
-					{
-						m_currentBufferSize = samplesPerRead;
-						m_remainingBufferData = samplesPerRead;
-						return i;
-					}
-
-					int16* src = ((int16*)m_Internaldata.data()) + m_playbackPointer;
-					m_readBuffer[0][i] = (float)src[0] / (float)0x7FFF;
-					m_readBuffer[1][i] = (float)src[0] / (float)0x7FFF;
-					m_playbackPointer++;
-				}
+				AudioKernels::Int16ToFloat(m_readBuffer[0], src, count);
+				memcpy(m_readBuffer[1], m_readBuffer[0], sizeof(float) * count);
 			}
-			m_currentBufferSize = samplesPerRead;
-			m_remainingBufferData = samplesPerRead;
-			return samplesPerRead;
+			m_playbackPointer += count * m_format.nChannels;
+
+			m_currentBufferSize = count;
+			m_remainingBufferData = count;
+			return count;
 		}
 		else if (m_format.nFormat == 2)
 		{
 			Buffer decoded;
 			m_playbackPointer -= m_playbackPointer % m_format.nBlockAlign;
+			if (m_playbackPointer + m_format.nBlockAlign > m_dataLength)
+				return -1;
 			decoded.resize(m_format.nBlockAlign * m_format.nChannels * sizeof(short));
 			uint32 decodedCount = m_decode_ms_adpcm(m_Internaldata, &decoded, m_playbackPointer);
 			uint32 samplesInserted = 0;
 			uint64 bufferOffset = 0;
-			for (uint32 i = 0; i < decodedCount; i++)
-			{
-				int16* src = ((int16*)decoded.data()) + (i * 2);
-				m_readBuffer[0][i] = (float)src[0] / (float)0x7FFF;
-				m_readBuffer[1][i] = (float)src[1] / (float)0x7FFF;
-			}
+			AudioKernels::Int16ToPlanar(m_readBuffer[0], m_readBuffer[1], (int16*)decoded.data(), decodedCount);
 			
 			m_playbackPointer += m_format.nBlockAlign;
 
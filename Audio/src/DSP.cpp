@@ -2,8 +2,39 @@
 #include "DSP.hpp"
 #include "AudioOutput.hpp"
 #include "Audio_Impl.hpp"
+#include "AudioKernels.hpp"
 #include <Shared/Interpolation.hpp>
 
+void DelayLine::Init(uint32 maxDelay)
+{
+	// Room for the current frame and <maxDelay> frames before it
+	uint32 size = 1;
+	while(size < maxDelay + 1)
+		size <<= 1;
+	if(m_data.size() < size * 2)
+	{
+		m_data.clear();
+		m_data.resize(size * 2);
+	}
+	else
+	{
+		Clear();
+	}
+	m_mask = size - 1;
+	m_position = 0;
+	m_written = 0;
+}
+void DelayLine::Clear()
+{
+	// Only the written frames can contain anything
+	uint32 first = (m_position - m_written) & m_mask;
+	uint32 count = Math::Min(m_written, m_mask + 1 - first);
+	memset(m_data.data() + first * 2, 0, sizeof(float) * 2 * count);
+	memset(m_data.data(), 0, sizeof(float) * 2 * (m_written - count));
+	m_position = 0;
+	m_written = 0;
+}
+
 void PanDSP::Process(float* out, uint32 numSamples)
 {
 	for(uint32 i = 0; i < numSamples; i++)
@@ -15,50 +46,152 @@ void PanDSP::Process(float* out, uint32 numSamples)
 	}
 }
 
-void BQFDSP::Process(float* out, uint32 numSamples)
+// Quantized biquad parameters
+struct BiquadKey
 {
-	for(uint32 c = 0; c < 2; c++)
+	enum Type : uint32
 	{
-		for(uint32 i = 0; i < numSamples; i++)
+		LowPass = 1,
+		HighPass,
+		Peaking,
+	};
+	uint32 type;
+	uint32 freq;
+	uint32 q;
+	int32 gain;
+	uint32 sampleRate;
+
+	bool operator==(const BiquadKey& other) const
+	{
+		return type == other.type && freq == other.freq && q == other.q && gain == other.gain && sampleRate == other.sampleRate;
+	}
+};
+
+// Keeps the exponent and the 6 highest mantissa bits, which puts 64 steps in every octave
+static uint32 QuantizeLog(float value)
+{
+	uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits >> 17;
+}
+// Value in the middle of a quantization step
+static float DequantizeLog(uint32 key)
+{
+	uint32 bits = (key << 17) | (1u << 16);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+/*
+	Direct mapped table of recently calculated coefficients
+	One per thread, filters are set from the game thread and from DSP's running on the mixer and mix worker threads
+*/
+class BiquadCache
+{
+public:
+	const AudioKernels::BiquadCoefficients& Get(uint32 type, float q, float freq, float gain, float sampleRate)
+	{
+		BiquadKey key;
+		key.type = type;
+		key.freq = QuantizeLog(freq);
+		// Limit q
+		key.q = QuantizeLog(Math::Max(q, 0.01f));
+		// Steps of 0.1 dB
+		key.gain = (type == BiquadKey::Peaking) ? (int32)floorf(gain * 10.0f + 0.5f) : 0;
+		key.sampleRate = (uint32)sampleRate;
+
+		uint32 hash = key.type * 0x9E3779B1u ^ key.freq * 0x85EBCA77u ^ key.q * 0xC2B2AE3Du ^ (uint32)key.gain * 0x27D4EB2Fu ^ key.sampleRate;
+		Entry& entry = m_entries[(hash ^ (hash >> 16)) % numEntries];
+		if(!(entry.key == key))
 		{
-			float& sample = out[i * 2 + c];
-			float src = sample;
+			entry.key = key;
+			m_Calculate(entry.coefficients, key);
+		}
+		return entry.coefficients;
+	}
 
-			float filtered = 
-				(b0 / a0) * src + 
-				(b1 / a0) * zb[c][0] + 
-				(b2 / a0) * zb[c][1] - 
-				(a1 / a0) * za[c][0] - 
-				(a2 / a0) * za[c][1];
+private:
+	static void m_Calculate(AudioKernels::BiquadCoefficients& c, const BiquadKey& key)
+	{
+		double q = DequantizeLog(key.q);
+		double freq = DequantizeLog(key.freq);
+		double w0 = (2 * Math::pi * freq) / (double)key.sampleRate;
+		double cw0 = cos(w0);
+		double alpha = sin(w0) / (2 * q);
+
+		double b0, b1, b2, a0, a1, a2;
+		if(key.type == BiquadKey::LowPass)
+		{
+			b0 = (1 - cw0) / 2;
+			b1 = 1 - cw0;
+			b2 = (1 - cw0) / 2;
+			a0 = 1 + alpha;
+			a1 = -2 * cw0;
+			a2 = 1 - alpha;
+		}
+		else if(key.type == BiquadKey::HighPass)
+		{
+			b0 = (1 + cw0) / 2;
+			b1 = -(1 + cw0);
+			b2 = (1 + cw0) / 2;
+			a0 = 1 + alpha;
+			a1 = -2 * cw0;
+			a2 = 1 - alpha;
+		}
+		else
+		{
+			double A = pow(10, ((double)key.gain / 10.0 / 40));
+			b0 = 1 + alpha * A;
+			b1 = -2 * cw0;
+			b2 = 1 - alpha * A;
+			a0 = 1 + alpha / A;
+			a1 = -2 * cw0;
+			a2 = 1 - alpha / A;
+		}
 
-			// Shift delay buffers
-			zb[c][1] = zb[c][0];
-			zb[c][0] = src;
+		// Normalize so the filter doesn't have to divide by a0
+		c.b0 = (float)(b0 / a0);
+		c.b1 = (float)(b1 / a0);
+		c.b2 = (float)(b2 / a0);
+		c.a1 = (float)(a1 / a0);
+		c.a2 = (float)(a2 / a0);
+	}
 
-			// Feedback the calculated value into the IIR delay buffers
-			za[c][1] = za[c][0];
-			za[c][0] = filtered;
+	static const uint32 numEntries = 512;
+	struct Entry
+	{
+		BiquadKey key = { 0 };
+		AudioKernels::BiquadCoefficients coefficients;
+	};
+	Entry m_entries[numEntries];
+};
+static thread_local BiquadCache biquadCache;
 
-			sample = filtered;
-		}
+void BQFDSP::Process(float* out, uint32 numSamples)
+{
+	AudioKernels::BiquadCoefficients target = m_target.Load();
+	// Don't sweep from the default coefficients when the filter starts
+	if(!m_started)
+	{
+		m_current = target;
+		m_started = true;
 	}
+	AudioKernels::BiquadStereo(out, numSamples, m_state, m_current, target);
+	m_current = target;
+}
+void BQFDSP::Reset()
+{
+	m_state = {};
+	m_started = false;
+}
+AudioKernels::BiquadCoefficients BQFDSP::GetCoefficients() const
+{
+	return m_target.Load();
 }
 void BQFDSP::SetLowPass(float q, float freq, float sampleRate)
 {
-	// Limit q
-	q = Math::Max(q, 0.01f);
-
-	// Sampling frequency
-	double w0 = (2 * Math::pi * freq) / sampleRate;
-	double cw0 = cos(w0);
-	float alpha = (float)(sin(w0) / (2 * q));
-
-	b0 = (float)((1 - cw0) / 2);
-	b1 = (float)(1 - cw0);
-	b2 = (float)((1 - cw0) / 2);
-	a0 = 1 + alpha;
-	a1 = (float)(-2 * cw0);
-	a2 = 1 - alpha;
+	m_target.Store(biquadCache.Get(BiquadKey::LowPass, q, freq, 0.0f, sampleRate));
 }
 void BQFDSP::SetLowPass(float q, float freq)
 {
@@ -66,20 +199,8 @@ void BQFDSP::SetLowPass(float q, float freq)
 }
 void BQFDSP::SetHighPass(float q, float freq, float sampleRate)
 {
-	// Limit q
-	q = Math::Max(q, 0.01f);
-
 	assert(freq < sampleRate);
-	double w0 = (2 * Math::pi * freq) / sampleRate;
-	double cw0 = cos(w0);
-	float alpha = (float)(sin(w0) / (2 * q));
-
-	b0 = (float)((1 + cw0) / 2);
-	b1 = (float)-(1 + cw0);
-	b2 = float((1 + cw0) / 2);
-	a0 = 1 + alpha;
-	a1 = (float)(-2 * cw0);
-	a2 = 1 - alpha;
+	m_target.Store(biquadCache.Get(BiquadKey::HighPass, q, freq, 0.0f, sampleRate));
 }
 void BQFDSP::SetHighPass(float q, float freq)
 {
@@ -87,20 +208,7 @@ void BQFDSP::SetHighPass(float q, float freq)
 }
 void BQFDSP::SetPeaking(float q, float freq, float gain, float sampleRate)
 {
-	// Limit q
-	q = Math::Max(q, 0.01f);
-
-	double w0 = (2 * Math::pi * freq) / sampleRate;
-	double cw0 = cos(w0);
-	float alpha = (float)(sin(w0) / (2 * q));
-	double A = pow(10, (gain / 40));
-
-	b0 = 1 + (float)(alpha * A);
-	b1 = -2 * (float)cw0;
-	b2 = 1 - (float)(alpha*A);
-	a0 = 1 + (float)(alpha / A);
-	a1 = -2 * (float)cw0;
-	a2 = 1 - (float)(alpha / A);
+	m_target.Store(biquadCache.Get(BiquadKey::Peaking, q, freq, gain, sampleRate));
 }
 void BQFDSP::SetPeaking(float q, float freq, float gain)
 {
@@ -109,31 +217,64 @@ void BQFDSP::SetPeaking(float q, float freq, float gain)
 
 void LimiterDSP::Process(float* out, uint32 numSamples)
 {
-	float secondsPerSample = (float)audio->GetSecondsPerSample();
-	for(uint32 i = 0; i < numSamples; i++)
+	// Gain recovered per sub block
+	float blockTime = (float)blockFrames / (float)audio->GetSampleRate();
+	m_releaseCoefficient = (releaseTime > 0.0f) ? expf(-blockTime / releaseTime) : 0.0f;
+
+	for(uint32 i = 0; i < numSamples;)
 	{
-		float currentGain = 1.0f;
-		if(m_currentReleaseTimer < releaseTime)
+		// The block being played is the one after the block being written
+		uint32 count = Math::Min(numSamples - i, blockFrames - m_position);
+		float* write = m_blocks[m_writeBlock] + m_position * 2;
+		const float* play = m_blocks[(m_writeBlock + 1) % 3] + m_position * 2;
+		memcpy(write, out + i * 2, sizeof(float) * 2 * count);
+		memcpy(out + i * 2, play, sizeof(float) * 2 * count);
+
+		m_position += count;
+		i += count;
+		if(m_position == blockFrames)
 		{
-			float t = (1.0f - m_currentReleaseTimer / releaseTime);
-			currentGain = (1.0f / m_currentMaxVolume) * t + (1.0f - t);
-		}
-	
-		float maxVolume = Math::Max(abs(out[i*2]), abs(out[i * 2 + 1]));
-		out[i * 2] *= currentGain * 0.9f;
-		out[i * 2 + 1] *= currentGain * 0.9f;
-	
-		float currentMax = 1.0f / currentGain;
-		if(maxVolume > currentMax)
-		{
-			m_currentMaxVolume = maxVolume;
-			m_currentReleaseTimer = 0.0f;
-		}
-		else
-		{
-			m_currentReleaseTimer += secondsPerSample;
+			m_FinishBlock();
+			m_position = 0;
+			m_writeBlock = (m_writeBlock + 1) % 3;
 		}
 	}
+
+	AudioMeter meter;
+	meter.peak = AudioKernels::PeakAbs(out, numSamples * 2);
+	meter.rms = sqrtf(AudioKernels::SumSquares(out, numSamples * 2) / (float)Math::Max(numSamples * 2, 1u));
+	meter.gain = m_gain;
+	m_meter.Store(meter);
+}
+void LimiterDSP::m_FinishBlock()
+{
+	float peak = AudioKernels::PeakAbs(m_blocks[m_writeBlock], blockFrames * 2);
+	float nextGain = (peak > ceiling) ? ceiling / peak : 1.0f;
+
+	// The ramp ends below what both the waiting block and the block after it need, since the gain is linear the waiting block never goes over the ceiling
+	float target = 1.0f - (1.0f - m_gain) * m_releaseCoefficient;
+	target = Math::Min(target, Math::Min(m_waitingGain, nextGain));
+	AudioKernels::ScaleRamp(m_blocks[(m_writeBlock + 2) % 3], m_gain, target, blockFrames);
+
+	m_gain = target;
+	m_waitingGain = nextGain;
+}
+void LimiterDSP::Reset()
+{
+	memset(m_blocks, 0, sizeof(m_blocks));
+	m_writeBlock = 0;
+	m_position = 0;
+	m_waitingGain = 1.0f;
+	m_gain = 1.0f;
+	m_meter.Store(AudioMeter());
+}
+uint32 LimiterDSP::GetLatency() const
+{
+	return lookahead;
+}
+AudioMeter LimiterDSP::GetMeter() const
+{
+	return m_meter.Load();
 }
 
 void BitCrusherDSP::SetPeriod(float period /*= 0*/)
@@ -161,6 +302,13 @@ void BitCrusherDSP::Process(float* out, uint32 numSamples)
 	}
 }
 
+void BitCrusherDSP::Reset()
+{
+	m_currentDuration = 0;
+	m_sampleBuffer[0] = 0.0f;
+	m_sampleBuffer[1] = 0.0f;
+}
+
 void GateDSP::SetLength(uint32 length)
 {
 	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
@@ -213,21 +361,37 @@ void GateDSP::Process(float* out, uint32 numSamples)
 	}
 }
 
+void GateDSP::Reset()
+{
+	m_currentSample = 0;
+}
+
 void TapeStopDSP::SetLength(uint32 length)
 {
 	assert(audio);
 
-	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
+	float flength = (float)Math::Min(length, maxLength) / 1000.0f * (float)audio->GetSampleRate();
 	m_length = (uint32)flength;
-	m_sampleBuffer.clear();
-	m_sampleBuffer.reserve(length);
+}
+void TapeStopDSP::Prepare(uint32 sampleRate)
+{
+	m_delay.Init((uint32)((uint64)maxLength * sampleRate / 2000) + 1);
+}
+void TapeStopDSP::Reset()
+{
+	m_delay.Clear();
+	m_sampleIdx = 0.0f;
+	m_currentSample = 0;
 }
 void TapeStopDSP::Process(float* out, uint32 numSamples)
 {
+	if(m_length == 0)
+		return;
+
 	for(uint32 i = 0; i < numSamples; i++)
 	{
 		float sampleRate = 1.0f - (float)m_currentSample / (float)m_length;
-		if(sampleRate == 0.0f)
+		if(sampleRate <= 0.0f)
 		{
 			// Mute
 			out[i * 2] = 0.0f;
@@ -236,13 +400,13 @@ void TapeStopDSP::Process(float* out, uint32 numSamples)
 		}
 
 		// Store samples for later
-		m_sampleBuffer.Add(out[i*2]);
-		m_sampleBuffer.Add(out[i*2+1]);
+		m_delay.Write(out[i * 2], out[i * 2 + 1]);
 
-		// The sample index into the buffer
-		uint32 i2 = (uint32)floor(m_sampleIdx);
-		out[i * 2] = m_sampleBuffer[i2 * 2] * mix + out[i * 2] * (1 - mix);
-		out[i * 2 + 1] = m_sampleBuffer[i2 * 2 + 1] * mix + out[i * 2+1] * (1 - mix);
+		// Distance between the sample that was just stored and the one being played
+		uint32 delay = m_currentSample - (uint32)floor(m_sampleIdx);
+		const float* sample = m_delay.Read(delay);
+		out[i * 2] = sample[0] * mix + out[i * 2] * (1 - mix);
+		out[i * 2 + 1] = sample[1] * mix + out[i * 2+1] * (1 - mix);
 
 		// Increase index
 		m_sampleIdx += sampleRate;
@@ -252,14 +416,9 @@ void TapeStopDSP::Process(float* out, uint32 numSamples)
 
 void RetriggerDSP::SetLength(uint32 length)
 {
-	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
-	m_length = (uint32)flength;
+	float flength = (float)Math::Min(length, maxLength) / 1000.0f * (float)audio->GetSampleRate();
+	m_length = Math::Min((uint32)flength, (uint32)(m_sampleBuffer.size() / 2));
 	SetGating(m_gating);
-	if (!m_bufferReserved)
-	{
-		m_sampleBuffer.reserve(m_length + 100);
-		m_bufferReserved = true;
-	}
 }
 void RetriggerDSP::SetResetDuration(uint32 resetDuration)
 {
@@ -271,17 +430,23 @@ void RetriggerDSP::SetGating(float gating)
 	m_gating = gating;
 	m_gateLength = (uint32)((float)m_length * gating);
 }
-void RetriggerDSP::SetMaxLength(uint32 length)
+void RetriggerDSP::Prepare(uint32 sampleRate)
 {
-	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
-	if (!m_bufferReserved)
-	{
-		m_sampleBuffer.reserve((uint32_t)flength + 100);
-		m_bufferReserved = true;
-	}
+	size_t size = ((size_t)maxLength * sampleRate / 1000 + 1) * 2;
+	if(m_sampleBuffer.size() < size)
+		m_sampleBuffer.resize(size);
+}
+void RetriggerDSP::Reset()
+{
+	m_recorded = 0;
+	m_loops = 0;
+	m_currentSample = 0;
 }
 void RetriggerDSP::Process(float* out, uint32 numSamples)
 {
+	if(m_length == 0)
+		return;
+
 	for(uint32 i = 0; i < numSamples; i++)
 	{
 		if(m_loops == 0)
@@ -289,34 +454,34 @@ void RetriggerDSP::Process(float* out, uint32 numSamples)
 			// Store samples for later
 			if(m_currentSample > m_gateLength) // Additional gating
 			{
-				m_sampleBuffer.Add(0.0f);
-				m_sampleBuffer.Add(0.0f);
+				m_sampleBuffer[m_currentSample * 2] = 0.0f;
+				m_sampleBuffer[m_currentSample * 2 + 1] = 0.0f;
 			}
 			else
 			{
-				m_sampleBuffer.Add(out[i * 2]);
-				m_sampleBuffer.Add(out[i * 2 + 1]);
+				m_sampleBuffer[m_currentSample * 2] = out[i * 2];
+				m_sampleBuffer[m_currentSample * 2 + 1] = out[i * 2 + 1];
 			}
+			m_recorded = Math::Max(m_recorded, m_currentSample + 1);
 		}
 
 		// Sample from buffer
 		out[i * 2] = m_sampleBuffer[m_currentSample*2] * mix + out[i * 2] * (1 - mix);
 		out[i * 2 + 1] = m_sampleBuffer[m_currentSample*2+1] * mix + out[i * 2+1] * (1 - mix);
-		
-		// Increase index
+
+		// Increase index, the length can change while looping so don't play past what was recorded
 		m_currentSample++;
-		if(m_currentSample > m_length)
+		uint32 loopLength = (m_loops == 0) ? m_length : Math::Min(m_length, m_recorded);
+		if(m_currentSample >= loopLength)
 		{
-			m_currentSample -= m_length;
+			m_currentSample = 0;
 			m_loops++;
 			if((m_loops * m_length) > m_resetDuration && m_resetDuration != 0)
 			{
 				m_loops = 0;
-				m_currentSample = 0;
-				m_sampleBuffer.resize(0);
+				m_recorded = 0;
 			}
 		}
-		m_currentSample = Math::Clamp(m_currentSample, (uint32_t)0, (uint32_t)m_sampleBuffer.size());
 	}
 }
 
@@ -328,27 +493,36 @@ void WobbleDSP::SetLength(uint32 length)
 void WobbleDSP::Process(float* out, uint32 numSamples)
 {
 	static Interpolation::CubicBezier easing(Interpolation::EaseInExpo);
-	for(uint32 i = 0; i < numSamples; i++)
+	// The frequency is updated every few samples, the filter interpolates between the updates
+	const uint32 blockSize = 32;
+	float dry[blockSize * 2];
+	for(uint32 i = 0; i < numSamples; i += blockSize)
 	{
+		uint32 count = Math::Min(blockSize, numSamples - i);
+		m_currentSample = (m_currentSample + count) % m_length;
+
 		float f = abs(2.0f * ((float)m_currentSample / (float)m_length) - 1.0f);
 		f = easing.Sample(f);
 		float freq = fmin + (fmax - fmin) * f;
 		SetLowPass(q, freq);
 
-		float s[2] = { out[i * 2], out[i * 2 + 1] };
-
-		BQFDSP::Process(&out[i * 2], 1);
+		float* block = out + i * 2;
+		memcpy(dry, block, sizeof(float) * 2 * count);
+		BQFDSP::Process(block, count);
 
 		// Apply slight mixing
 		float mix = 0.5f;
-		out[i * 2 + 0] = out[i * 2 + 0] * mix + s[0] * (1.0f - mix);
-		out[i * 2 + 1] = out[i * 2 + 1] * mix + s[1] * (1.0f - mix);
-
-		m_currentSample++;
-		m_currentSample %= m_length;
+		AudioKernels::Scale(block, mix, count * 2);
+		AudioKernels::MixAdd(block, dry, 1.0f - mix, count * 2);
 	}
 }
 
+void WobbleDSP::Reset()
+{
+	BQFDSP::Reset();
+	m_currentSample = 0;
+}
+
 void PhaserDSP::SetLength(uint32 length)
 {
 	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
@@ -400,6 +574,17 @@ float PhaserDSP::APF::Update(float in)
 	return y;
 }
 
+void PhaserDSP::Reset()
+{
+	time = 0;
+	for(uint32 c = 0; c < 2; c++)
+	{
+		for(uint32 i = 0; i < 6; i++)
+			filters[c][i].za = 0.0f;
+		za[c] = 0.0f;
+	}
+}
+
 void FlangerDSP::SetLength(uint32 length)
 {
 	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
@@ -410,16 +595,21 @@ void FlangerDSP::SetDelayRange(uint32 min, uint32 max)
 	assert(max > min);
 	// Assuming 44100hz is the base sample rate
 	float mult = (float)audio->GetSampleRate() / 44100.f;
-	m_min = min * mult;
-	m_max = max * mult;
-	m_bufferLength = m_max * 2;
-	m_sampleBuffer.resize(m_bufferLength);
+	m_max = Math::Min((uint32)(Math::Min(max, maxDelay) * mult), m_delay.GetMaxDelay());
+	m_min = Math::Min((uint32)(min * mult), m_max - 1);
+}
+void FlangerDSP::Prepare(uint32 sampleRate)
+{
+	m_delay.Init((uint32)((uint64)maxDelay * sampleRate / 44100) + 1);
+}
+void FlangerDSP::Reset()
+{
+	m_delay.Clear();
+	m_time = 0;
 }
 void FlangerDSP::Process(float* out, uint32 numSamples)
 {
-	float* data = m_sampleBuffer.data();
-
-	if(m_bufferLength <= 0)
+	if(m_max == 0 || m_length == 0)
 		return;
 
 	for(uint32 i = 0; i < numSamples; i++)
@@ -429,64 +619,58 @@ void FlangerDSP::Process(float* out, uint32 numSamples)
 		f = fabsf(f * 2 - 1);
 		uint32 d = (uint32)(m_min + ((m_max - 1) - m_min) * (f));
 
-		// TODO: clean up?
-		int32 samplePos = ((int)m_bufferOffset - (int)d * 2) % (int)m_bufferLength;
-		if (samplePos < 0)
-			samplePos = m_bufferLength + samplePos;
-
 		// Inject new sample
-		data[m_bufferOffset + 0] = out[i*2];
-		data[m_bufferOffset + 1] = out[i*2+1];
+		m_delay.Write(out[i * 2], out[i * 2 + 1]);
+		const float* delayed = m_delay.Read(d);
 
 		// Apply delay
-		out[i * 2] = (data[samplePos] + out[i*2]) * 0.5f * mix +
+		out[i * 2] = (delayed[0] + out[i*2]) * 0.5f * mix +
 			out[i * 2] * (1 - mix);
-		out[i * 2 + 1] = (data[samplePos+1] + out[i*2+1]) * 0.5f * mix +
+		out[i * 2 + 1] = (delayed[1] + out[i*2+1]) * 0.5f * mix +
 			out[i * 2+1] * (1 - mix);
 
-		m_bufferOffset += 2;
-		if(m_bufferOffset >= m_bufferLength)
-			m_bufferOffset = 0;
 		m_time++;
 	}
 }
 
 void EchoDSP::SetLength(uint32 length)
 {
-	float flength = (float)length / 1000.0f * (float)audio->GetSampleRate();
-	m_sampleBuffer.clear();
-	m_bufferLength = (uint32)flength * 2;
-	m_sampleBuffer.resize(m_bufferLength);
-	memset(m_sampleBuffer.data(), 0, sizeof(float) * m_bufferLength);
+	float flength = (float)Math::Min(length, maxLength) / 1000.0f * (float)audio->GetSampleRate();
+	m_length = Math::Min((uint32)flength, m_delay.GetMaxDelay() + 1);
+	m_position = 0;
+	m_numLoops = 0;
+}
+void EchoDSP::Prepare(uint32 sampleRate)
+{
+	m_delay.Init((uint32)((uint64)maxLength * sampleRate / 1000));
+}
+void EchoDSP::Reset()
+{
+	m_delay.Clear();
+	m_position = 0;
 	m_numLoops = 0;
 }
 void EchoDSP::Process(float* out, uint32 numSamples)
 {
-	float* data = m_sampleBuffer.data();
+	if(m_length == 0)
+		return;
 
 	for(uint32 i = 0; i < numSamples; i++)
 	{
-		// Insert new samples before current position
-		size_t insertPos = (m_bufferOffset - 2) % m_bufferLength;
-
-		float l0 = data[m_bufferOffset + 0];
-		float l1 = data[m_bufferOffset + 1];
-
 		if(m_numLoops > 0)
 		{
 			// Send echo to output
-			out[i * 2] = l0 * mix;
-			out[i * 2 + 1] = l1 * mix;
+			const float* echo = m_delay.Read(m_length - 1);
+			out[i * 2] = echo[0] * mix;
+			out[i * 2 + 1] = echo[1] * mix;
 		}
 
 		// Inject new sample
-		data[insertPos + 0] = out[i * 2] * feedback;
-		data[insertPos + 1] = out[i * 2 + 1] * feedback;
+		m_delay.Write(out[i * 2] * feedback, out[i * 2 + 1] * feedback);
 
-		m_bufferOffset += 2;
-		if(m_bufferOffset >= m_bufferLength)
+		if(++m_position >= m_length)
 		{
-			m_bufferOffset = 0;
+			m_position = 0;
 			m_numLoops++;
 		}
 	}
@@ -521,6 +705,11 @@ void SidechainDSP::Process(float* out, uint32 numSamples)
 	}
 }
 
+void SidechainDSP::Reset()
+{
+	m_time = 0;
+}
+
 void CombinedFilterDSP::SetLowPass(float q, float freq, float peakQ, float peakGain)
 {
 	float sr = (float)audio->GetSampleRate();
@@ -540,61 +729,101 @@ void CombinedFilterDSP::Process(float* out, uint32 numSamples)
 	a.Process(out, numSamples);
 	peak.Process(out, numSamples);
 }
-
-#include "SoundTouch.h"
-using namespace soundtouch;
-
-class PitchShiftDSP_Impl
+void CombinedFilterDSP::Reset()
 {
-public:
-	float pitch = 0.0f;
-	bool init = false;
-
-private:
-	SoundTouch m_soundtouch;
-	Vector<float> m_receiveBuffer;
+	a.Reset();
+	peak.Reset();
+}
 
-public:
-	PitchShiftDSP_Impl()
-	{
-	}
-	~PitchShiftDSP_Impl()
-	{
-	}
-	void Init(Audio_Impl* audio)
-	{
-		m_soundtouch.setChannels(2);
-		m_soundtouch.setSampleRate(audio->GetSampleRate());
-		m_soundtouch.setSetting(SETTING_USE_AA_FILTER, 0);
-		m_soundtouch.setSetting(SETTING_SEQUENCE_MS, 5);
-		//m_soundtouch.setSetting(SETTING_SEEKWINDOW_MS, 10);
-		//m_soundtouch.setSetting(SETTING_OVERLAP_MS, 10);
-	}
-	void Process(float* out, uint32 numSamples)
+// Number of steps in the crossfade of the pitch shifter's read positions
+static const uint32 grainWindowSize = 256;
+// sin^2 over a window, the read positions are half a window apart so their gains are x and 1-x
+static const float* GetGrainWindow()
+{
+	struct Table
 	{
-		m_receiveBuffer.resize(numSamples*2);
-		m_soundtouch.setPitchSemiTones(pitch);
-		m_soundtouch.putSamples(out, numSamples);
-		uint32 receivedSamples = m_soundtouch.receiveSamples(m_receiveBuffer.data(), numSamples);
-		if(receivedSamples > 0)
+		float values[grainWindowSize + 1];
+		Table()
 		{
-			memcpy(out, m_receiveBuffer.data(), receivedSamples * sizeof(float) * 2);
+			for(uint32 i = 0; i <= grainWindowSize; i++)
+			{
+				float s = sinf(Math::pi * (float)i / (float)grainWindowSize);
+				values[i] = s * s;
+			}
 		}
-	}
-};
+	};
+	static Table table;
+	return table.values;
+}
 
-PitchShiftDSP::PitchShiftDSP()
+void PitchShiftDSP::Prepare(uint32 sampleRate)
 {
-	m_impl = new PitchShiftDSP_Impl();
+	m_window = Math::Max(windowLength * sampleRate / 1000, 2u);
+	// Room for the frame after the longest delay, used for interpolation
+	m_delay.Init(m_window + 1);
+	m_phase = 0.0f;
 }
-PitchShiftDSP::~PitchShiftDSP()
+void PitchShiftDSP::Reset()
 {
-	delete m_impl;
+	m_delay.Clear();
+	m_phase = 0.0f;
+}
+uint32 PitchShiftDSP::GetLatency() const
+{
+	return m_window / 2;
 }
 void PitchShiftDSP::Process(float* out, uint32 numSamples)
 {
-	m_impl->pitch = amount;
-	if(!m_impl->init)
-		m_impl->Init(audio);
-	m_impl->Process(out, numSamples);
+	if(m_window == 0)
+		return;
+
+	// The read positions move through the window by the difference between the playback speed and the input speed
+	float ratio = powf(2.0f, amount / 12.0f);
+	float step = (1.0f - ratio) / (float)m_window;
+	float window = (float)m_window;
+	const float* grainWindow = GetGrainWindow();
+
+	const uint32 blockSize = 64;
+	float wet[blockSize * 2];
+	for(uint32 i = 0; i < numSamples; i += blockSize)
+	{
+		uint32 count = Math::Min(blockSize, numSamples - i);
+		float* block = out + i * 2;
+		for(uint32 j = 0; j < count; j++)
+		{
+			m_delay.Write(block[j * 2], block[j * 2 + 1]);
+
+			float phaseB = m_phase + 0.5f;
+			if(phaseB >= 1.0f)
+				phaseB -= 1.0f;
+			float gainA = grainWindow[(uint32)(m_phase * (float)grainWindowSize)];
+
+			// Linear interpolation between the two frames around each read position
+			float delayA = m_phase * window;
+			float delayB = phaseB * window;
+			uint32 indexA = (uint32)delayA;
+			uint32 indexB = (uint32)delayB;
+			float fracA = delayA - (float)indexA;
+			float fracB = delayB - (float)indexB;
+			const float* a0 = m_delay.Read(indexA);
+			const float* a1 = m_delay.Read(indexA + 1);
+			const float* b0 = m_delay.Read(indexB);
+			const float* b1 = m_delay.Read(indexB + 1);
+			for(uint32 c = 0; c < 2; c++)
+			{
+				float a = a0[c] + (a1[c] - a0[c]) * fracA;
+				float b = b0[c] + (b1[c] - b0[c]) * fracB;
+				wet[j * 2 + c] = b + (a - b) * gainA;
+			}
+
+			m_phase += step;
+			if(m_phase < 0.0f)
+				m_phase += 1.0f;
+			else if(m_phase >= 1.0f)
+				m_phase -= 1.0f;
+		}
+
+		AudioKernels::Scale(block, 1.0f - mix, count * 2);
+		AudioKernels::MixAdd(block, wet, mix, count * 2);
+	}
 }
@@ -0,0 +1,19 @@
+#include "stdafx.h"
+#include "DSPPool.hpp"
+
+DSPPool::~DSPPool()
+{
+	for(auto& free : m_free)
+	{
+		for(DSP* dsp : free.second)
+			delete dsp;
+	}
+}
+void DSPPool::Release(DSP* dsp)
+{
+	assert(dsp->audioBase == nullptr);
+	// Clear state from the last use, settings are applied again by whoever acquires it next
+	dsp->Reset();
+	dsp->mix = 1.0f;
+	m_free[std::type_index(typeid(*dsp))].Add(dsp);
+}
@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "Resampler.hpp"
+#include "AudioKernels.hpp"
+
+// Number of input frames that can be buffered on top of the filter length
+static const uint32 inputBufferFrames = 1024;
+// Fraction of the lowest nyquist frequency that is passed through
+static const double passband = 0.95;
+// Shape of the kaiser window, higher values trade transition width for stopband attenuation
+static const double kaiserBeta = 8.0;
+
+// Zeroth order modified bessel function of the first kind
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for(uint32 k = 1; k < 32; k++)
+	{
+		double t = x / (2.0 * k);
+		term *= t * t;
+		sum += term;
+		if(term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+void Resampler::Init(uint32 inputRate, uint32 outputRate)
+{
+	assert(inputRate > 0 && outputRate > 0);
+	m_inputRate = inputRate;
+	m_outputRate = outputRate;
+
+	// Reduce the ratio so positions can be tracked exactly
+	uint32 a = inputRate, b = outputRate;
+	while(b != 0)
+	{
+		uint32 t = a % b;
+		a = b;
+		b = t;
+	}
+	m_step = inputRate / a;
+	m_denominator = outputRate / a;
+	m_numPhases = Math::Min(m_denominator, maxPhases);
+
+	m_BuildFilters();
+	m_input.resize((numTaps + inputBufferFrames) * 2);
+	Reset();
+}
+void Resampler::Reset(uint32 historyFrames)
+{
+	// Start with silence before the first frame, so the first output frame lines up with the first input frame after the history
+	assert(historyFrames <= GetMaxHistory());
+	m_inputFrames = GetMaxHistory() - historyFrames;
+	memset(m_input.data(), 0, sizeof(float) * 2 * m_inputFrames);
+	m_index = 0;
+	m_fraction = 0;
+}
+uint32 Resampler::Process(float* out, uint32 maxOutputFrames, const float* in, uint32 numInputFrames, uint32& inputUsed)
+{
+	if(IsPassthrough())
+	{
+		uint32 count = Math::Min(maxOutputFrames, numInputFrames);
+		memcpy(out, in, sizeof(float) * 2 * count);
+		inputUsed = count;
+		return count;
+	}
+
+	uint32 capacity = (uint32)(m_input.size() / 2);
+	uint32 outCount = 0;
+	inputUsed = 0;
+	while(outCount < maxOutputFrames)
+	{
+		if(m_index + numTaps > m_inputFrames)
+		{
+			if(inputUsed == numInputFrames)
+				break;
+
+			// Drop frames that are no longer needed and add new input
+			uint32 drop = Math::Min(m_index, m_inputFrames);
+			memmove(m_input.data(), m_input.data() + drop * 2, sizeof(float) * 2 * (m_inputFrames - drop));
+			m_inputFrames -= drop;
+			m_index -= drop;
+
+			uint32 count = Math::Min(numInputFrames - inputUsed, capacity - m_inputFrames);
+			memcpy(m_input.data() + m_inputFrames * 2, in + inputUsed * 2, sizeof(float) * 2 * count);
+			m_inputFrames += count;
+			inputUsed += count;
+			continue;
+		}
+
+		uint32 phase = m_fraction;
+		if(m_numPhases != m_denominator)
+			phase = (uint32)((uint64)m_fraction * m_numPhases / m_denominator);
+		AudioKernels::ConvolveStereo(out + outCount * 2, m_input.data() + m_index * 2, m_filters.data() + phase * numTaps * 2, numTaps);
+		outCount++;
+
+		m_fraction += m_step;
+		m_index += m_fraction / m_denominator;
+		m_fraction %= m_denominator;
+	}
+	return outCount;
+}
+void Resampler::m_BuildFilters()
+{
+	// Cut off below the nyquist frequency of the lowest rate to prevent aliasing when downsampling
+	double cutoff = passband * Math::Min(1.0, (double)m_outputRate / (double)m_inputRate);
+	const double center = (double)(numTaps / 2 - 1);
+	const double halfWidth = (double)(numTaps / 2);
+	const double windowScale = 1.0 / BesselI0(kaiserBeta);
+
+	m_filters.resize(m_numPhases * numTaps * 2);
+	for(uint32 p = 0; p < m_numPhases; p++)
+	{
+		double offset = (double)p / (double)m_numPhases;
+		float* filter = m_filters.data() + p * numTaps * 2;
+
+		double sum = 0.0;
+		double coefficients[numTaps];
+		for(uint32 k = 0; k < numTaps; k++)
+		{
+			// Distance from the output position in input frames
+			double t = (double)k - center - offset;
+			double x = t * cutoff * Math::pi;
+			double sinc = (fabs(x) < 1e-9) ? 1.0 : sin(x) / x;
+			double w = t / halfWidth;
+			double window = (fabs(w) >= 1.0) ? 0.0 : BesselI0(kaiserBeta * sqrt(1.0 - w * w)) * windowScale;
+			coefficients[k] = sinc * window;
+			sum += coefficients[k];
+		}
+
+		// Normalize so every phase has unity gain
+		for(uint32 k = 0; k < numTaps; k++)
+		{
+			float c = (float)(coefficients[k] / sum);
+			filter[k * 2] = c;
+			filter[k * 2 + 1] = c;
+		}
+	}
+}
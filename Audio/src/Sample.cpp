@@ -2,9 +2,8 @@
 #include "Sample.hpp"
 #include "Audio_Impl.hpp"
 #include "Audio.hpp"
-
-// Fixed point format for resampling
-static uint64 fp_sampleStep = 1ull << 48;
+#include "AudioKernels.hpp"
+#include "Resampler.hpp"
 
 struct WavHeader
 {
@@ -47,30 +46,23 @@ class Sample_Impl : public SampleRes
 {
 public:
 	Audio* m_audio;
-	Buffer m_pcm;
 	WavFormat m_format = { 0 };
-
-	mutex m_lock;
-
-	// Resampling values
-	uint64 m_sampleStep = 0;
-	uint64 m_sampleStepIncrement = 0;
-
-	uint64 m_playbackPointer = 0;
-	uint64 m_length = 0;
-	bool m_playing = false;
+	// Stereo at the output rate
+	Vector<int16> m_pcm;
 
 public:
 	~Sample_Impl()
 	{
+		// Also stops the voices that play this sample
 		Deregister();
 	}
 	virtual void Play() override
 	{
-		m_lock.lock();
-		m_playing = true;
-		m_playbackPointer = 0;
-		m_lock.unlock();
+		audio->PlaySample(this);
+	}
+	virtual void Stop() override
+	{
+		audio->StopSample(this);
 	}
 	bool Init(const String& path)
 	{
@@ -89,6 +81,7 @@ public:
 		if(strncmp(riffType, "WAVE", 4) != 0)
 			return false;
 
+		Buffer pcm;
 		while(stream.Tell() < stream.GetSize())
 		{
 			WavHeader chunkHdr;
@@ -115,9 +108,8 @@ public:
 					return false;
 
 				// Read data
-				m_length = chunkHdr.nLength / sizeof(short);
-				m_pcm.resize(chunkHdr.nLength);
-				stream.Serialize(m_pcm.data(), chunkHdr.nLength);
+				pcm.resize(chunkHdr.nLength);
+				stream.Serialize(pcm.data(), chunkHdr.nLength);
 			}
 			else
 			{
@@ -125,71 +117,58 @@ public:
 			}
 		}
 
-		// Calculate the sample step if the rate is not the same as the output rate
-		double sampleStep = (double)m_format.nSampleRate / (double)m_audio->GetSampleRate();
-		m_sampleStepIncrement = (uint64)(sampleStep * (double)fp_sampleStep);
-
-		return true;
-	}
-	virtual void Process(float* out, uint32 numSamples) override
-	{
-		if(!m_playing)
-			return;
-
-		m_lock.lock();
-		if(m_format.nChannels == 2)
+		// Convert to stereo at the output rate once, so voices only have to copy
+		uint32 numFrames = (uint32)(pcm.size() / sizeof(int16) / m_format.nChannels);
+		if(m_format.nSampleRate != m_audio->GetSampleRate())
 		{
-			// Mix stereo sample
-			for(uint32 i = 0; i < numSamples; i++)
-			{
-				if(m_playbackPointer >= m_length)
-				{
-					// Playback ended
-					m_playing = false;
-					break;
-				}
-
-				int16* src = ((int16*)m_pcm.data()) + m_playbackPointer;
-				out[i * 2] = (float)src[0] / (float)0x7FFF;
-				out[i * 2 + 1] = (float)src[1] / (float)0x7FFF;
-
-				// Increment source sample with resampling
-				m_sampleStep += m_sampleStepIncrement;
-				while(m_sampleStep >= fp_sampleStep)
-				{
-					m_playbackPointer += 2;
-					m_sampleStep -= fp_sampleStep;
-				}
-			}
+			m_Resample((const int16*)pcm.data(), numFrames, m_audio->GetSampleRate());
 		}
-		else 
+		else if(m_format.nChannels == 1)
 		{
-			// Mix mono sample
-			for(uint32 i = 0; i < numSamples; i++)
+			const int16* src = (const int16*)pcm.data();
+			m_pcm.resize(numFrames * 2);
+			for(uint32 i = 0; i < numFrames; i++)
 			{
-				if(m_playbackPointer >= m_length)
-				{
-					// Playback ended
-					m_playing = false;
-					break;
-				}
-
-				int16* src = ((int16*)m_pcm.data()) + m_playbackPointer;
-				out[i * 2] = (float)src[0] / (float)0x7FFF;
-				out[i * 2 + 1] = (float)src[0] / (float)0x7FFF;
-
-				// Increment source sample with resampling
-				m_sampleStep += m_sampleStepIncrement;
-				while(m_sampleStep >= fp_sampleStep)
-				{
-					m_playbackPointer += 1;
-					m_sampleStep -= fp_sampleStep;
-				}
+				m_pcm[i * 2] = src[i];
+				m_pcm[i * 2 + 1] = src[i];
 			}
 		}
-		m_lock.unlock();
+		else
+		{
+			m_pcm.resize(numFrames * 2);
+			memcpy(m_pcm.data(), pcm.data(), numFrames * 2 * sizeof(int16));
+		}
+		m_format.nChannels = 2;
+		m_format.nSampleRate = m_audio->GetSampleRate();
+		m_format.nByteRate = m_format.nSampleRate * 2 * sizeof(int16);
+		m_format.nBlockAlign = 2 * sizeof(int16);
+
+		return true;
+	}
+	// Converts the sample data to stereo at the given rate
+	void m_Resample(const int16* src, uint32 numFrames, uint32 outputRate)
+	{
+		Vector<float> input;
+		input.resize((numFrames + Resampler::numTaps) * 2);
+		if(m_format.nChannels == 2)
+			AudioKernels::Int16ToFloat(input.data(), src, numFrames * 2);
+		else
+			AudioKernels::Int16MonoToStereo(input.data(), src, numFrames);
+		// Padding at the end to get the filter's tail out
+		memset(input.data() + numFrames * 2, 0, sizeof(float) * 2 * Resampler::numTaps);
+
+		Resampler resampler;
+		resampler.Init(m_format.nSampleRate, outputRate);
+		uint32 numOutput = (uint32)((uint64)numFrames * outputRate / m_format.nSampleRate);
+		Vector<float> output;
+		output.resize(numOutput * 2);
+		uint32 used = 0;
+		numOutput = resampler.Process(output.data(), numOutput, input.data(), numFrames + Resampler::numTaps, used);
+
+		m_pcm.resize(numOutput * 2);
+		AudioKernels::FloatToInt16(m_pcm.data(), output.data(), numOutput * 2);
 	}
-	const Buffer& GetData() const
+	const Vector<int16>& GetData() const
 	{
 		return m_pcm;
 	}
@@ -215,7 +194,8 @@ Sample SampleRes::Create(Audio* audio, const String& path)
 		return Sample();
 	}
 
-	audio->GetImpl()->Register(res);
+	// Not registered for rendering, only linked so DSP's can be added and voices are stopped when the sample is destroyed
+	res->audio = audio->GetImpl();
 
 	return Sample(res);
 }
\ No newline at end of file
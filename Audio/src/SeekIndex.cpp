@@ -0,0 +1,116 @@
+#include "stdafx.h"
+#include "SeekIndex.hpp"
+#include <algorithm>
+
+String SeekIndex::cacheFolder = "seekindex";
+
+// Increment when the file layout or the way indices are built changes
+static const uint32 seekIndexMagic = 0x58494B53; // "SKIX"
+static const uint32 seekIndexVersion = 1;
+
+struct SeekIndexHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint64 sourceSize;
+	uint64 sourceWriteTime;
+	int64 samplesTotal;
+	uint32 numEntries;
+	uint32 reserved;
+};
+
+void SeekIndex::Clear()
+{
+	m_entries.clear();
+	samplesTotal = 0;
+}
+void SeekIndex::Add(int64 sample, uint64 offset)
+{
+	assert(m_entries.empty() || m_entries.back().sample <= sample);
+	m_entries.Add({ sample, offset });
+}
+int32 SeekIndex::Find(int64 sample) const
+{
+	auto it = std::upper_bound(m_entries.begin(), m_entries.end(), sample, [](int64 s, const Entry& e)
+	{
+		return s < e.sample;
+	});
+	if(it == m_entries.begin())
+		return -1;
+	return (int32)(it - m_entries.begin()) - 1;
+}
+
+bool SeekIndex::Load(const String& sourcePath)
+{
+	File source;
+	if(!source.OpenRead(sourcePath))
+		return false;
+	uint64 sourceSize = source.GetSize();
+	uint64 sourceWriteTime = source.GetLastWriteTime();
+	source.Close();
+
+	String cachePath = m_GetCachePath(sourcePath);
+	if(!Path::FileExists(cachePath))
+		return false;
+	File file;
+	if(!file.OpenRead(cachePath))
+		return false;
+
+	SeekIndexHeader header;
+	if(file.Read(&header, sizeof(header)) != sizeof(header))
+		return false;
+	if(header.magic != seekIndexMagic || header.version != seekIndexVersion)
+		return false;
+	if(header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime)
+		return false;
+
+	size_t dataSize = (size_t)header.numEntries * sizeof(Entry);
+	if(file.GetSize() != sizeof(header) + dataSize)
+		return false;
+
+	m_entries.resize(header.numEntries);
+	if(file.Read(m_entries.data(), dataSize) != dataSize)
+	{
+		Clear();
+		return false;
+	}
+	samplesTotal = header.samplesTotal;
+	return true;
+}
+bool SeekIndex::Save(const String& sourcePath) const
+{
+	File source;
+	if(!source.OpenRead(sourcePath))
+		return false;
+
+	SeekIndexHeader header = { 0 };
+	header.magic = seekIndexMagic;
+	header.version = seekIndexVersion;
+	header.sourceSize = source.GetSize();
+	header.sourceWriteTime = source.GetLastWriteTime();
+	header.samplesTotal = samplesTotal;
+	header.numEntries = (uint32)m_entries.size();
+	source.Close();
+
+	if(!Path::IsDirectory(cacheFolder))
+		Path::CreateDir(cacheFolder);
+
+	File file;
+	if(!file.OpenWrite(m_GetCachePath(sourcePath)))
+		return false;
+	file.Write(&header, sizeof(header));
+	file.Write(m_entries.data(), m_entries.size() * sizeof(Entry));
+	return true;
+}
+String SeekIndex::m_GetCachePath(const String& sourcePath)
+{
+	// FNV-1a hash of the full path
+	String fullPath = Path::Normalize(Path::Absolute(sourcePath));
+	uint64 hash = 14695981039346656037ull;
+	for(char c : fullPath)
+	{
+		hash ^= (uint8)c;
+		hash *= 1099511628211ull;
+	}
+	return Path::Normalize(cacheFolder + Path::sep + Utility::Sprintf("%016llx.idx", (unsigned long long)hash));
+}
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "VoicePool.hpp"
+#include "Sample.hpp"
+#include "AudioKernels.hpp"
+
+void VoicePool::Play(SampleRes* sample)
+{
+	const Vector<int16>& data = sample->GetData();
+	if(data.empty())
+		return;
+
+	// Find a voice to use, oldest voice of the same sample first
+	uint32 target = m_numActive;
+	uint32 sampleVoices = 0;
+	uint32 oldest = 0;
+	for(uint32 i = 0; i < m_numActive; i++)
+	{
+		if(m_voices[i].sample != sample)
+			continue;
+		if(sampleVoices == 0 || m_voices[i].startIndex < m_voices[oldest].startIndex)
+			oldest = i;
+		sampleVoices++;
+	}
+	if(sampleVoices >= maxVoicesPerSample)
+	{
+		target = oldest;
+	}
+	else if(m_numActive == maxVoices)
+	{
+		// Take the voice with the least left to play
+		target = 0;
+		for(uint32 i = 1; i < m_numActive; i++)
+		{
+			const Voice& a = m_voices[i];
+			const Voice& b = m_voices[target];
+			if(a.numFrames - a.position < b.numFrames - b.position)
+				target = i;
+		}
+	}
+	else
+	{
+		m_numActive++;
+	}
+
+	Voice& voice = m_voices[target];
+	voice.sample = sample;
+	voice.pcm = data.data();
+	voice.numFrames = (uint32)(data.size() / 2);
+	voice.position = 0;
+	voice.startIndex = m_nextStartIndex++;
+}
+void VoicePool::Stop(const AudioBase* sample)
+{
+	for(uint32 i = 0; i < m_numActive;)
+	{
+		if(m_voices[i].sample == sample)
+			m_Remove(i);
+		else
+			i++;
+	}
+}
+void VoicePool::StopAll()
+{
+	m_numActive = 0;
+}
+void VoicePool::Mix(float* out, float* scratch, float* voiceBuffer, uint32 numSamples)
+{
+	for(uint32 i = 0; i < m_numActive; i++)
+	{
+		// All voices of a sample are summed the first time the sample is found
+		SampleRes* sample = m_voices[i].sample;
+		bool mixed = false;
+		for(uint32 j = 0; j < i && !mixed; j++)
+			mixed = m_voices[j].sample == sample;
+		if(mixed)
+			continue;
+
+		memset(scratch, 0, sizeof(float) * 2 * numSamples);
+		for(uint32 j = i; j < m_numActive; j++)
+		{
+			Voice& voice = m_voices[j];
+			if(voice.sample != sample)
+				continue;
+			uint32 count = Math::Min(numSamples, voice.numFrames - voice.position);
+			AudioKernels::Int16ToFloat(voiceBuffer, voice.pcm + voice.position * 2, count * 2);
+			AudioKernels::MixAdd(scratch, voiceBuffer, 1.0f, count * 2);
+			voice.position += count;
+		}
+
+		// The sample's DSP's keep their state between blocks, so they run once per block no matter how many voices play
+		sample->ProcessDSPs(scratch, numSamples);
+		AudioKernels::MixAdd(out, scratch, sample->GetVolume(), numSamples * 2);
+	}
+
+	// Removed afterwards, removing moves voices around
+	for(uint32 i = 0; i < m_numActive;)
+	{
+		if(m_voices[i].position >= m_voices[i].numFrames)
+			m_Remove(i);
+		else
+			i++;
+	}
+}
+uint32 VoicePool::GetNumActive(const AudioBase* sample) const
+{
+	uint32 count = 0;
+	for(uint32 i = 0; i < m_numActive; i++)
+	{
+		if(m_voices[i].sample == sample)
+			count++;
+	}
+	return count;
+}
+void VoicePool::m_Remove(uint32 index)
+{
+	// Order doesn't matter, move the last active voice into the gap
+	assert(index < m_numActive);
+	m_numActive--;
+	m_voices[index] = m_voices[m_numActive];
+}
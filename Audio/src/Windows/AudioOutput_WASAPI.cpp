@@ -20,8 +20,8 @@
 static const uint32_t freq = 44100;
 static const uint32_t channels = 2;
 static const uint32_t numBuffers = 2;
+// Default buffer length in milliseconds
 static const uint32_t bufferLength = 10;
-static const REFERENCE_TIME bufferDuration = (REFERENCE_TIME)(bufferLength * REFTIMES_PER_MILLISEC);
 
 // Object that handles the addition/removal of audio devices
 class NotificationClient : public IMMNotificationClient
@@ -64,7 +64,14 @@ public:
 	// Object that receives device change notifications
 	NotificationClient m_notificationClient;
 
-	double m_bufferLength;
+	double m_bufferLength = 0.0;
+	// Stream latency reported by the driver, in seconds
+	double m_streamLatency = 0.0;
+
+	// Requested buffer duration
+	REFERENCE_TIME m_bufferDuration = (REFERENCE_TIME)(bufferLength * REFTIMES_PER_MILLISEC);
+	// Requested buffer size in samples, converted to a duration once the device rate is known
+	uint32 m_desiredBufferSize = 0;
 
 	// Dummy audio output
 	static const uint32 m_dummyChannelCount = 2;
@@ -121,8 +128,11 @@ public:
 			m_audioThread.join();
 	}
 
-	bool Init()
+	bool Init(uint32 bufferSize, uint32 sampleRate)
 	{
+		// The shared mode mixer always runs at the device rate, so only the buffer size can be configured
+		m_desiredBufferSize = bufferSize;
+
 		// Initialize the WASAPI device enumerator
 		HRESULT res;
 		const CLSID CLSID_MMDeviceEnumerator = __uuidof(MMDeviceEnumerator);
@@ -188,9 +198,17 @@ public:
 		WAVEFORMATEX* mixFormat = nullptr;
 		res = m_audioClient->GetMixFormat(&mixFormat);
 
+		if(m_desiredBufferSize > 0)
+			m_bufferDuration = (REFERENCE_TIME)((double)m_desiredBufferSize * (double)REFTIMES_PER_SEC / (double)mixFormat->nSamplesPerSec);
+
+		// Clamp to the smallest period the device supports
+		REFERENCE_TIME minimumPeriod = 0;
+		if(m_audioClient->GetDevicePeriod(nullptr, &minimumPeriod) == S_OK)
+			m_bufferDuration = Math::Max(m_bufferDuration, minimumPeriod);
+
 		// Init client
 		res = m_audioClient->Initialize(AUDCLNT_SHAREMODE_SHARED, 0,
-			bufferDuration, 0, mixFormat, nullptr);
+			m_bufferDuration, 0, mixFormat, nullptr);
 
 		// Store selected format
 		m_format = *mixFormat;
@@ -220,6 +238,13 @@ public:
 
 		m_bufferLength = (double)m_numBufferFrames / (double)m_format.nSamplesPerSec;
 
+		REFERENCE_TIME streamLatency = 0;
+		m_audioClient->GetStreamLatency(&streamLatency);
+		m_streamLatency = (double)streamLatency / (double)REFTIMES_PER_SEC;
+
+		Logf("Opened audio device with %d samples at %d Hz (%.2f ms stream latency)", Logger::Info,
+			m_numBufferFrames, m_format.nSamplesPerSec, m_streamLatency * 1000.0);
+
 		res = m_audioClient->Start();
 		return true;
 	}
@@ -227,6 +252,8 @@ public:
 	{
 		m_format.nSamplesPerSec = freq;
 		m_format.nChannels = 2;
+		m_bufferLength = 0.0;
+		m_streamLatency = 0.0;
 		m_dummyTimer.Restart();
 		m_dummyTimerPos = 0;
 		return true;
@@ -352,9 +379,9 @@ AudioOutput::~AudioOutput()
 {
 	delete m_impl;
 }
-bool AudioOutput::Init()
+bool AudioOutput::Init(uint32 bufferSize, uint32 sampleRate)
 {
-	return m_impl->Init();
+	return m_impl->Init(bufferSize, sampleRate);
 }
 void AudioOutput::Start(IMixer* mixer)
 {
@@ -378,4 +405,8 @@ double AudioOutput::GetBufferLength() const
 {
 	return m_impl->m_bufferLength;
 }
+double AudioOutput::GetLatency() const
+{
+	return m_impl->m_bufferLength + m_impl->m_streamLatency;
+}
 #endif
\ No newline at end of file
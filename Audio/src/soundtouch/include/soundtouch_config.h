@@ -1,5 +0,0 @@
-/* Use Float as Sample type */
-//#undef SOUNDTOUCH_FLOAT_SAMPLES
-
-/* Use Integer as Sample type */
-#undef SOUNDTOUCH_INTEGER_SAMPLES
@@ -58,7 +58,11 @@ public:
 	Beatmap& operator=(Beatmap&& other);
 
 	bool Load(BinaryStream& input, bool metadataOnly = false);
+	// Reads only the settings of a map, without creating anything else
+	//	for ksh maps this only reads the header, the rest of the map is never read from the stream
+	static bool LoadSettings(BinaryStream& input, BeatmapSettings& settings);
 	// Saves the map as it's own format
+	//	the format stores the objects as they are in memory, so it can only be loaded on the same platform
 	bool Save(BinaryStream& output) const;
 
 	// Returns the settings of the map, contains metadata + song/image paths.
@@ -92,7 +96,11 @@ public:
 
 private:
 	bool m_ProcessKShootMap(BinaryStream& input, bool metadataOnly);
+	static bool m_ProcessKShootHeader(BinaryStream& input, BeatmapSettings& settings);
 	bool m_Serialize(BinaryStream& stream, bool metadataOnly);
+	// Moves the objects and points that were allocated one by one while parsing into the flat storage
+	void m_Compact();
+	void m_Clear();
 
 	Map<EffectType, AudioEffect> m_customEffects;
 	Map<EffectType, AudioEffect> m_customFilters;
@@ -104,5 +112,15 @@ private:
 	Vector<ZoomControlPoint*> m_zoomControlPoints;
 	Vector<String> m_samplePaths;
 	BeatmapSettings m_settings;
-	
+
+	// Flat storage of everything in the map, the vectors of pointers above point into these
+	//	every object takes the size of a MultiObjectState and objects are in the same order as m_objectStates
+	Buffer m_objectData;
+	Vector<TimingPoint> m_timingPointData;
+	Vector<ChartStop> m_chartStopData;
+	Vector<LaneHideTogglePoint> m_laneTogglePointData;
+	Vector<ZoomControlPoint> m_zoomControlPointData;
+
+	// Loads the binary format directly
+	friend class ChartCache;
 };
\ No newline at end of file
@@ -54,6 +54,47 @@ TrackRollBehaviour operator&(const TrackRollBehaviour& l, const TrackRollBehavio
 // Sensitive data layout since union structure is used to access buttons/holds/... object states
 #pragma pack(push, 1)
 
+/*
+	Link to another object of the same map, used like a pointer
+	Stored as an offset from the link itself, a map keeps all it's objects in one block so the links stay valid when the whole block is copied or read from a file
+*/
+template<typename T>
+class ObjectLink
+{
+public:
+	ObjectLink() = default;
+	ObjectLink(T* target)
+	{
+		*this = target;
+	}
+	// Copies link to the same object
+	ObjectLink(const ObjectLink& other)
+	{
+		*this = (T*)other;
+	}
+	ObjectLink& operator=(const ObjectLink& other)
+	{
+		return *this = (T*)other;
+	}
+	ObjectLink& operator=(T* target)
+	{
+		m_offset = target ? (int64)((uint8*)target - (uint8*)this) : 0;
+		return *this;
+	}
+
+	operator T*() const
+	{
+		return m_offset ? (T*)((uint8*)this + m_offset) : nullptr;
+	}
+	T* operator->() const
+	{
+		return *this;
+	}
+
+private:
+	int64 m_offset = 0;
+};
+
 // Common data for all object types
 struct ObjectTypeData_Base
 {
@@ -123,8 +164,8 @@ struct ObjectTypeData_Hold : public ObjectTypeData_Button
 	int16 effectParams[2] = { 0 };
 
 	// Set for hold notes that are a continuation of the previous one, but with a different effect
-	TObjectState<ObjectTypeData_Hold>* next = nullptr;
-	TObjectState<ObjectTypeData_Hold>* prev = nullptr;
+	ObjectLink<TObjectState<ObjectTypeData_Hold>> next;
+	ObjectLink<TObjectState<ObjectTypeData_Hold>> prev;
 
 	static const ObjectType staticType = ObjectType::Hold;
 };
@@ -167,8 +208,8 @@ struct ObjectTypeData_Laser
 	// Position of the laser on the track
 	float points[2];
 	// Set the to the object state that connects to this laser, if any, otherwise null
-	TObjectState<ObjectTypeData_Laser>* next = nullptr;
-	TObjectState<ObjectTypeData_Laser>* prev = nullptr;
+	ObjectLink<TObjectState<ObjectTypeData_Laser>> next;
+	ObjectLink<TObjectState<ObjectTypeData_Laser>> prev;
 
 	SpinStruct spin;
 
@@ -224,8 +265,6 @@ struct ObjectTypeData_Event
 // Object state with union data member
 struct MultiObjectState
 {
-	static bool StaticSerialize(BinaryStream& stream, MultiObjectState*& out);
-
 	// Position in ms when this object appears
 	MapTime time;
 	// Type of this object, determines the size of this struct and which type its data is
@@ -255,8 +294,6 @@ typedef TObjectState<ObjectTypeData_Event> EventObjectState;
 // Map timing point
 struct TimingPoint
 {
-	static bool StaticSerialize(BinaryStream& stream, TimingPoint*& out);
-
 	double GetWholeNoteLength() const { return beatDuration * 4; }
 	double GetBarDuration() const { return GetWholeNoteLength() * ((double)numerator / (double)denominator); }
 	double GetBPM() const { return 60000.0 / beatDuration; }
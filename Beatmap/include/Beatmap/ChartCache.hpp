@@ -0,0 +1,29 @@
+#pragma once
+#include "Beatmap.hpp"
+
+/*
+	Cache of maps in the binary map format, so the text of a chart only needs to be parsed once
+	Cached maps are validated against the size and write time of the chart file and a checksum of their data
+*/
+class ChartCache
+{
+public:
+	// Loads the cached map for a chart file, fails if there is none, it is damaged or the chart changed since it was saved
+	static bool Load(const String& sourcePath, Beatmap& map, bool metadataOnly = false);
+	// Writes to a temporary file first, so a cached map is never left half written
+	static bool Save(const String& sourcePath, const Beatmap& map);
+	// Removes the cached maps of all chart files that are not in <sourcePaths>
+	static void Prune(const Vector<String>& sourcePaths);
+
+	// Loads a chart from the cache, or parses the chart and adds it to the cache
+	//	returns null if the chart could not be loaded
+	static Beatmap* LoadMap(const String& sourcePath);
+
+	// Folder the compiled maps are stored in, relative to the working directory (next to the map database)
+	static String cacheFolder;
+
+private:
+	static String m_GetCachePath(const String& sourcePath);
+
+	static const char* c_tempExtension;
+};
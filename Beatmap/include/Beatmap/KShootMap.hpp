@@ -2,35 +2,51 @@
 
 using Utility::Sprintf;
 
+/*
+	Piece of text inside a loaded map file, without copying it out of the file
+*/
+struct KShootString
+{
+	KShootString() = default;
+	KShootString(const char* data, size_t length);
+
+	bool empty() const;
+	char operator[](size_t i) const;
+	bool operator==(const char* other) const;
+	bool operator!=(const char* other) const;
+	// Splits at the first occurence of <delim>, returns false if it was not found
+	bool Split(char delim, KShootString* l, KShootString* r) const;
+	// Position of the first occurence of <str>, or -1 if it was not found
+	size_t Find(const char* str) const;
+	// Parse a number like atol/atof do, without allocating
+	int32 ToInt() const;
+	double ToDouble() const;
+	String ToString() const;
+
+	const char* data = nullptr;
+	size_t length = 0;
+};
+
 struct KShootTickSetting
 {
-	String first;
-	String second;
+	KShootString first;
+	KShootString second;
 };
 
 /*
-	Any division inside a KShootBlock
+	Any division inside a bar
+	Only valid as long as the map it was read from
 */
 class KShootTick
 {
 public:
-	String ToString() const;
-	void Clear();
-
+	// Settings that changed since the previous tick
 	Vector<KShootTickSetting> settings;
 
 	// Original data for this tick
-	String buttons, fx, laser, add;
+	KShootString buttons, fx, laser, add;
 };
 
-/* 
-	A single bar in the map file 
-*/
-class KShootBlock
-{
-public:
-	Vector<KShootTick> ticks;
-};
 class KShootTime
 {
 public:
@@ -49,8 +65,9 @@ struct KShootEffectDefinition
 	Map<String, String> parameters;
 };
 
-/* 
-	Map class for that splits up maps in the ksh format into Ticks and Blocks
+/*
+	Map class for maps in the ksh format
+	The map file is kept in memory as a whole, ticks are read from it by a TickIterator one at a time
 */
 class KShootMap
 {
@@ -58,34 +75,53 @@ public:
 	class TickIterator
 	{
 	public:
-		TickIterator(KShootMap& map, KShootTime start = KShootTime(0, 0));
+		TickIterator(const KShootMap& map);
 		TickIterator& operator++();
 		operator bool() const;
-		KShootTick& operator*();
-		KShootTick* operator->();
+		const KShootTick& operator*() const;
+		const KShootTick* operator->() const;
 		const KShootTime& GetTime() const;
-		const KShootBlock& GetCurrentBlock() const;
+		// Number of ticks in the current bar
+		uint32 GetBlockSize() const;
+		bool IsLastTick() const;
 	private:
-		KShootMap& m_map;
-		KShootBlock* m_currentBlock;
+		bool m_HasBlock() const;
+		// Reads up to and including the next tick line
+		bool m_ReadTick();
+
+		const KShootMap& m_map;
+		const char* m_position;
+		KShootTick m_tick;
 		KShootTime m_time;
+		bool m_valid;
 	};
 
 public:
 	KShootMap();
 	~KShootMap();
+	// Reads the map file, the header and effect definitions
+	//	the ticks in the body are only validated, they are read by a TickIterator
+	//	with <metadataOnly> set nothing after the header is read from <input>
 	bool Init(BinaryStream& input, bool metadataOnly);
-	bool GetBlock(const KShootTime& time, KShootBlock*& tickOut);
-	bool GetTick(const KShootTime& time, KShootTick*& tickOut);
-	float TimeToFloat(const KShootTime& time) const;
 	float TranslateLaserChar(char c) const;
 
 	Map<String, String> settings;
-	Vector<KShootBlock> blocks;
+	// Number of ticks in every bar of the map
+	Vector<uint32> blockSizes;
 	Map<String, KShootEffectDefinition> filterDefines;
 	Map<String, KShootEffectDefinition> fxDefines;
 
 private:
+	// Reads lines up to the first bar separator into m_data and parses them
+	bool m_ReadHeader(BinaryStream& input, uint32& lineNumber);
+	// Splits a line with a tick into it's parts, returns false if it is not a valid tick
+	static bool m_ParseTick(const KShootString& line, KShootTick& tick, uint32 lineNumber);
+	void m_ParseDefine(const KShootString& line, uint32 lineNumber);
+
 	static const char* c_sep;
 
-};
\ No newline at end of file
+	// Contents of the map file
+	Buffer m_data;
+	// Offset to the first line after the header
+	size_t m_bodyStart = 0;
+};
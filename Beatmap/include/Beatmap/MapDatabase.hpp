@@ -70,6 +70,8 @@ public:
 	Map<int32, MapIndex*> FindMapsByFolder(const String& folder);
 	MapIndex* GetMap(int32 idx);
 
+	// Maps found by the search are loaded on the job threads of <sheduler>, instead of one by one on the search thread
+	void SetJobSheduler(class JobSheduler* sheduler);
 	void AddSearchPath(const String& path);
 	void AddScore(const DifficultyIndex& diff, int score, int crit, int almost, int miss, float gauge, uint32 gameflags);
 	void RemoveSearchPath(const String& path);
@@ -2,58 +2,70 @@
 #include "Beatmap.hpp"
 #include "Shared/Profiling.hpp"
 
-static const uint32 c_mapVersion = 1;
+static const uint32 c_mapVersion = 3;
 
 Beatmap::~Beatmap()
 {
-	// Perform cleanup
-	for(auto tp : m_timingPoints)
-		delete tp;
-	for(auto obj : m_objectStates)
-		delete obj;
-	for (auto z : m_zoomControlPoints)
-		delete z;
-	for (auto z : m_laneTogglePoints)
-		delete z;
+	// Everything is in the flat storage
 }
 Beatmap::Beatmap(Beatmap&& other)
 {
-	m_timingPoints = std::move(other.m_timingPoints);
-	m_objectStates = std::move(other.m_objectStates);
-	m_zoomControlPoints = std::move(other.m_zoomControlPoints);
-	m_laneTogglePoints = std::move(other.m_laneTogglePoints);
-	m_settings = std::move(other.m_settings);
+	*this = std::move(other);
 }
 Beatmap& Beatmap::operator=(Beatmap&& other)
 {
-	// Perform cleanup
-	for(auto tp : m_timingPoints)
-		delete tp;
-	for(auto obj : m_objectStates)
-		delete obj;
-	for(auto z : m_zoomControlPoints)
-		delete z;
+	// The pointers stay valid, the storage moves along with them
+	m_customEffects = std::move(other.m_customEffects);
+	m_customFilters = std::move(other.m_customFilters);
 	m_timingPoints = std::move(other.m_timingPoints);
+	m_chartStops = std::move(other.m_chartStops);
+	m_laneTogglePoints = std::move(other.m_laneTogglePoints);
 	m_objectStates = std::move(other.m_objectStates);
 	m_zoomControlPoints = std::move(other.m_zoomControlPoints);
-	m_laneTogglePoints = std::move(other.m_laneTogglePoints);
+	m_samplePaths = std::move(other.m_samplePaths);
 	m_settings = std::move(other.m_settings);
+	m_objectData = std::move(other.m_objectData);
+	m_timingPointData = std::move(other.m_timingPointData);
+	m_chartStopData = std::move(other.m_chartStopData);
+	m_laneTogglePointData = std::move(other.m_laneTogglePointData);
+	m_zoomControlPointData = std::move(other.m_zoomControlPointData);
 	return *this;
 }
 bool Beatmap::Load(BinaryStream& input, bool metadataOnly)
 {
 	ProfilerScope $("Load Beatmap");
 
-	if(!m_ProcessKShootMap(input, metadataOnly)) // Load KSH format first
+	bool loaded = m_ProcessKShootMap(input, metadataOnly); // Load KSH format first
+	// Also when parsing failed, so nothing that was allocated leaks
+	m_Compact();
+	if(!loaded)
 	{
 		// Load binary map format
+		m_Clear();
 		input.Seek(0);
 		if(!m_Serialize(input, metadataOnly))
+		{
+			m_Clear();
 			return false;
+		}
 	}
 
 	return true;
 }
+bool Beatmap::LoadSettings(BinaryStream& input, BeatmapSettings& settings)
+{
+	settings = BeatmapSettings();
+	if(m_ProcessKShootHeader(input, settings))
+		return true;
+
+	// Load binary map format
+	Beatmap map;
+	input.Seek(0);
+	if(!map.m_Serialize(input, true))
+		return false;
+	settings = map.m_settings;
+	return true;
+}
 bool Beatmap::Save(BinaryStream& output) const
 {
 	ProfilerScope $("Save Beatmap");
@@ -112,73 +124,113 @@ AudioEffect Beatmap::GetFilter(EffectType type) const
 	}
 	return AudioEffect::GetDefault(type);
 }
-bool MultiObjectState::StaticSerialize(BinaryStream& stream, MultiObjectState*& obj)
+// Size of the object type an object was allocated as
+static size_t GetObjectSize(ObjectType type)
 {
-	uint8 type = 0;
-	if(stream.IsReading())
+	switch(type)
 	{
-		// Read type and create appropriate object
-		stream << type;
-		switch((ObjectType)type)
-		{
-		case ObjectType::Single:
-			obj = (MultiObjectState*)new ButtonObjectState();
-			break;
-		case ObjectType::Hold:
-			obj = (MultiObjectState*)new HoldObjectState();
-			break;
-		case ObjectType::Laser:
-			obj = (MultiObjectState*)new LaserObjectState();
-			break;
-		case ObjectType::Event:
-			obj = (MultiObjectState*)new EventObjectState();
-			break;
-		}
-	}
-	else
-	{
-		// Write type
-		type = (uint8)obj->type;
-		stream << type;
+	case ObjectType::Single:
+		return sizeof(ButtonObjectState);
+	case ObjectType::Hold:
+		return sizeof(HoldObjectState);
+	case ObjectType::Laser:
+		return sizeof(LaserObjectState);
+	case ObjectType::Event:
+		return sizeof(EventObjectState);
+	default:
+		return sizeof(ObjectState);
 	}
-
-	// Pointer is always initialized here, serialize data
-	stream << obj->time; // Time always set
+}
+// Deletes an object as the type it was allocated as
+static void DeleteObject(ObjectState* obj)
+{
 	switch(obj->type)
 	{
 	case ObjectType::Single:
-		stream << obj->button.index;
+		delete (ButtonObjectState*)obj;
 		break;
 	case ObjectType::Hold:
-		stream << obj->hold.index;
-		stream << obj->hold.duration;
-		stream << (uint16&)obj->hold.effectType;
-		stream << (int16&)obj->hold.effectParams[0];
-		stream << (int16&)obj->hold.effectParams[1];
+		delete (HoldObjectState*)obj;
 		break;
 	case ObjectType::Laser:
-		stream << obj->laser.index;
-		stream << obj->laser.duration;
-		stream << obj->laser.points[0];
-		stream << obj->laser.points[1];
-		stream << obj->laser.flags;
+		delete (LaserObjectState*)obj;
 		break;
 	case ObjectType::Event:
-		stream << (uint8&)obj->event.key;
-		stream << *&obj->event.data;
+		delete (EventObjectState*)obj;
 		break;
+	default:
+		delete obj;
+		break;
+	}
+}
+// Moves points into a single block
+template<typename T>
+static void CompactPoints(Vector<T*>& points, Vector<T>& storage)
+{
+	storage.resize(points.size());
+	for(size_t i = 0; i < points.size(); i++)
+	{
+		storage[i] = *points[i];
+		delete points[i];
+		points[i] = &storage[i];
 	}
+}
+void Beatmap::m_Compact()
+{
+	CompactPoints(m_timingPoints, m_timingPointData);
+	CompactPoints(m_chartStops, m_chartStopData);
+	CompactPoints(m_laneTogglePoints, m_laneTogglePointData);
+	CompactPoints(m_zoomControlPoints, m_zoomControlPointData);
 
-	return true;
+	Map<const void*, uint32> indices;
+	for(uint32 i = 0; i < m_objectStates.size(); i++)
+		indices.Add(m_objectStates[i], i);
+	auto Relocate = [&](const void* obj) -> MultiObjectState*
+	{
+		const uint32* index = obj ? indices.Find(obj) : nullptr;
+		return index ? (MultiObjectState*)(m_objectData.data() + *index * sizeof(MultiObjectState)) : nullptr;
+	};
+
+	m_objectData.assign(m_objectStates.size() * sizeof(MultiObjectState), 0);
+	for(uint32 i = 0; i < m_objectStates.size(); i++)
+	{
+		MultiObjectState* src = *m_objectStates[i];
+		MultiObjectState* dst = (MultiObjectState*)(m_objectData.data() + i * sizeof(MultiObjectState));
+		memcpy(dst, src, GetObjectSize(src->type));
+
+		// Links are relative to their location, set them again
+		if(src->type == ObjectType::Hold)
+		{
+			dst->hold.next = (HoldObjectState*)Relocate((HoldObjectState*)src->hold.next);
+			dst->hold.prev = (HoldObjectState*)Relocate((HoldObjectState*)src->hold.prev);
+		}
+		else if(src->type == ObjectType::Laser)
+		{
+			dst->laser.next = (LaserObjectState*)Relocate((LaserObjectState*)src->laser.next);
+			dst->laser.prev = (LaserObjectState*)Relocate((LaserObjectState*)src->laser.prev);
+		}
+	}
+	for(uint32 i = 0; i < m_objectStates.size(); i++)
+	{
+		DeleteObject(m_objectStates[i]);
+		m_objectStates[i] = (ObjectState*)(m_objectData.data() + i * sizeof(MultiObjectState));
+	}
 }
-bool TimingPoint::StaticSerialize(BinaryStream& stream, TimingPoint*& out)
+void Beatmap::m_Clear()
 {
-	if(stream.IsReading())
-		out = new TimingPoint();
-	stream << out->time;
-	stream << out->beatDuration;
-	stream << out->numerator;
-	return true;
+	m_customEffects.clear();
+	m_customFilters.clear();
+	m_timingPoints.clear();
+	m_chartStops.clear();
+	m_laneTogglePoints.clear();
+	m_objectStates.clear();
+	m_zoomControlPoints.clear();
+	m_samplePaths.clear();
+	m_objectData.clear();
+	m_timingPointData.clear();
+	m_chartStopData.clear();
+	m_laneTogglePointData.clear();
+	m_zoomControlPointData.clear();
 }
 
 BinaryStream& operator<<(BinaryStream& stream, BeatmapSettings& settings)
@@ -196,9 +248,12 @@ BinaryStream& operator<<(BinaryStream& stream, BeatmapSettings& settings)
 	stream << settings.audioFX;
 
 	stream << settings.jacketPath;
+	stream << settings.backgroundPath;
+	stream << settings.foregroundPath;
 
 	stream << settings.level;
 	stream << settings.difficulty;
+	stream << settings.total;
 
 	stream << settings.previewOffset;
 	stream << settings.previewDuration;
@@ -208,6 +263,36 @@ BinaryStream& operator<<(BinaryStream& stream, BeatmapSettings& settings)
 	stream << (uint8&)settings.laserEffectType;
 	return stream;
 }
+// Reads or writes a block of points and the pointers to them
+template<typename T>
+static bool SerializePoints(BinaryStream& stream, Vector<T*>& points, Vector<T>& storage)
+{
+	uint32 count = (uint32)storage.size();
+	stream << count;
+	if(stream.IsReading())
+		storage.resize(count);
+	size_t size = sizeof(T) * count;
+	if(stream.Serialize(storage.data(), size) != size)
+		return false;
+	if(stream.IsReading())
+	{
+		points.resize(count);
+		for(uint32 i = 0; i < count; i++)
+			points[i] = &storage[i];
+	}
+	return true;
+}
+// Checks that a link points to an object of the same type in the block
+template<typename T>
+static bool IsValidLink(T* target, const Buffer& objects, ObjectType type)
+{
+	if(!target)
+		return true;
+	size_t offset = (size_t)((const uint8*)target - objects.data());
+	if(offset >= objects.size() || offset % sizeof(MultiObjectState) != 0)
+		return false;
+	return target->type == type;
+}
 bool Beatmap::m_Serialize(BinaryStream& stream, bool metadataOnly)
 {
 	static const uint32 c_magic = *(uint32*)"FXMM";
@@ -232,27 +317,56 @@ bool Beatmap::m_Serialize(BinaryStream& stream, bool metadataOnly)
 	}
 
 	stream << m_settings;
-	stream << m_timingPoints;
-	stream << reinterpret_cast<Vector<MultiObjectState*>&>(m_objectStates);
+	if(metadataOnly)
+		return true;
+
+	stream << m_samplePaths;
+	stream << m_customEffects;
+	stream << m_customFilters;
+	bool ok = true;
+	ok = ok && SerializePoints(stream, m_timingPoints, m_timingPointData);
+	ok = ok && SerializePoints(stream, m_chartStops, m_chartStopData);
+	ok = ok && SerializePoints(stream, m_laneTogglePoints, m_laneTogglePointData);
+	ok = ok && SerializePoints(stream, m_zoomControlPoints, m_zoomControlPointData);
+	if(!ok)
+		return false;
+
+	// Objects are stored as they are in memory, links between them are relative so they need no fixups
+	uint32 numObjects = (uint32)m_objectStates.size();
+	stream << numObjects;
+	if(stream.IsReading())
+		m_objectData.resize(numObjects * sizeof(MultiObjectState));
+	assert(m_objectData.size() == numObjects * sizeof(MultiObjectState));
+	if(stream.Serialize(m_objectData.data(), m_objectData.size()) != m_objectData.size())
+		return false;
 
-	// Manually fix up laser next-prev pointers
-	LaserObjectState* prevLasers[2] = { 0 };
 	if(stream.IsReading())
 	{
-		for(ObjectState* obj : m_objectStates)
+		m_objectStates.resize(numObjects);
+		MultiObjectState* objects = (MultiObjectState*)m_objectData.data();
+		for(uint32 i = 0; i < numObjects; i++)
 		{
-			if(obj->type == ObjectType::Laser)
+			MultiObjectState* obj = objects + i;
+			if(obj->type == ObjectType::Hold)
 			{
-				LaserObjectState* laser = (LaserObjectState*)obj;
-				LaserObjectState*& prev = prevLasers[laser->index];
-				if(prev && (prev->time + prev->duration) == laser->time)
-				{
-					prev->next = laser;
-					laser->prev = prev;
-				}
-
-				prev = laser;
+				ok = ok && IsValidLink((HoldObjectState*)obj->hold.next, m_objectData, ObjectType::Hold);
+				ok = ok && IsValidLink((HoldObjectState*)obj->hold.prev, m_objectData, ObjectType::Hold);
+			}
+			else if(obj->type == ObjectType::Laser)
+			{
+				ok = ok && IsValidLink((LaserObjectState*)obj->laser.next, m_objectData, ObjectType::Laser);
+				ok = ok && IsValidLink((LaserObjectState*)obj->laser.prev, m_objectData, ObjectType::Laser);
+			}
+			else if(obj->type != ObjectType::Single && obj->type != ObjectType::Event)
+			{
+				ok = false;
 			}
+			m_objectStates[i] = *obj;
+		}
+		if(!ok)
+		{
+			Log("Invalid objects in map", Logger::Warning);
+			return false;
 		}
 	}
 
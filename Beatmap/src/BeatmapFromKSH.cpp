@@ -302,95 +302,58 @@ AudioEffect ParseCustomEffect(const KShootEffectDefinition& def)
 	return effect;
 };
 
-bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
+static EffectType ParseFilterType(const String& str, const EffectTypeMap& filterTypeMap)
 {
-	KShootMap kshootMap;
-	if (!kshootMap.Init(input, metadataOnly))
-		return false;
-
-	EffectTypeMap effectTypeMap;
-	EffectTypeMap filterTypeMap;
-	Map<EffectType, int16> defaultEffectParams;
-
-	// Set defaults
+	EffectType type = EffectType::None;
+	if (str == "hpf1")
 	{
-		defaultEffectParams[EffectType::Bitcrush] = 4;
-		defaultEffectParams[EffectType::Gate] = 8;
-		defaultEffectParams[EffectType::Retrigger] = 8;
-		defaultEffectParams[EffectType::Phaser] = 2000;
-		defaultEffectParams[EffectType::Flanger] = 2000;
-		defaultEffectParams[EffectType::Wobble] = 12;
-		defaultEffectParams[EffectType::SideChain] = 8;
-		defaultEffectParams[EffectType::TapeStop] = 50;
+		type = EffectType::HighPassFilter;
 	}
-
-	// Add all the custom effect types
-	for (auto it = kshootMap.fxDefines.begin(); it != kshootMap.fxDefines.end(); it++)
+	else if (str == "lpf1")
 	{
-		EffectType type = effectTypeMap.FindOrAddEffectType(it->first);
-		if (m_customEffects.Contains(type))
-			continue;
-		m_customEffects.Add(type, ParseCustomEffect(it->second));
+		type = EffectType::LowPassFilter;
 	}
-	for (auto it = kshootMap.filterDefines.begin(); it != kshootMap.filterDefines.end(); it++)
+	else if (str == "fx;bitc" || str == "bitc")
 	{
-		EffectType type = filterTypeMap.FindOrAddEffectType(it->first);
-		if (m_customFilters.Contains(type))
-			continue;
-		m_customFilters.Add(type, ParseCustomEffect(it->second));
+		type = EffectType::Bitcrush;
 	}
-
-	auto ParseFilterType = [&](const String& str)
+	else if (str == "peak")
 	{
-		EffectType type = EffectType::None;
-		if (str == "hpf1")
-		{
-			type = EffectType::HighPassFilter;
-		}
-		else if (str == "lpf1")
-		{
-			type = EffectType::LowPassFilter;
-		}
-		else if (str == "fx;bitc" || str == "bitc")
-		{
-			type = EffectType::Bitcrush;
-		}
-		else if (str == "peak")
-		{
-			type = EffectType::PeakingFilter;
-		}
+		type = EffectType::PeakingFilter;
+	}
+	else
+	{
+		const EffectType* foundType = filterTypeMap.FindEffectType(str);
+		if (foundType)
+			type = *foundType;
 		else
-		{
-			const EffectType* foundType = filterTypeMap.FindEffectType(str);
-			if (foundType)
-				type = *foundType;
-			else
-				Logf("[KSH]Unknown filter type: %s", Logger::Warning, str);
-		}
-		return type;
-	};
-
-	// Process map settings
-	m_settings.previewOffset = 0;
-	m_settings.previewDuration = 0;
-	for (auto& s : kshootMap.settings)
+			Logf("[KSH]Unknown filter type: %s", Logger::Warning, str);
+	}
+	return type;
+}
+// Reads the settings in the header of a ksh map
+static void ProcessKShootSettings(const Map<String, String>& header, const EffectTypeMap& filterTypeMap, BeatmapSettings& settings)
+{
+	settings.previewOffset = 0;
+	settings.previewDuration = 0;
+	for (auto& s : header)
 	{
 		if (s.first == "title")
-			m_settings.title = s.second;
+			settings.title = s.second;
 		else if (s.first == "artist")
-			m_settings.artist = s.second;
+			settings.artist = s.second;
 		else if (s.first == "effect")
-			m_settings.effector = s.second;
+			settings.effector = s.second;
 		else if (s.first == "illustrator")
-			m_settings.illustrator = s.second;
+			settings.illustrator = s.second;
 		else if (s.first == "t")
-			m_settings.bpm = s.second;
+			settings.bpm = s.second;
 		else if (s.first == "jacket")
-			m_settings.jacketPath = s.second;
+			settings.jacketPath = s.second;
 		else if (s.first == "bg")
-			m_settings.backgroundPath = s.second;
+			settings.backgroundPath = s.second;
 		else if (s.first == "layer")
-			m_settings.foregroundPath = s.second;
+			settings.foregroundPath = s.second;
 		else if (s.first == "m")
 		{
 			if (s.second.find(';') != -1)
@@ -400,65 +363,107 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				size_t splitMore = audioFX.find(';');
 				if (splitMore != -1)
 					audioFX = audioFX.substr(0, splitMore);
-				m_settings.audioFX = audioFX;
-				m_settings.audioNoFX = audioNoFX;
+				settings.audioFX = audioFX;
+				settings.audioNoFX = audioNoFX;
 			}
 			else
 			{
-				m_settings.audioNoFX = s.second;
+				settings.audioNoFX = s.second;
 			}
 		}
 		else if (s.first == "o")
 		{
-			m_settings.offset = atol(*s.second);
+			settings.offset = atol(*s.second);
 		}
 		// TODO: Move initial laser effect settings to an event instead
 		else if (s.first == "filtertype")
 		{
-			m_settings.laserEffectType = ParseFilterType(s.second);
+			settings.laserEffectType = ParseFilterType(s.second, filterTypeMap);
 		}
 		else if (s.first == "pfiltergain")
 		{
-			m_settings.laserEffectMix = (float)atol(*s.second) / 100.0f;
+			settings.laserEffectMix = (float)atol(*s.second) / 100.0f;
 		}
 		else if (s.first == "chokkakuvol")
 		{
-			m_settings.slamVolume = (float)atol(*s.second) / 100.0f;
+			settings.slamVolume = (float)atol(*s.second) / 100.0f;
 		}
 		// end TODO
 		else if (s.first == "level")
 		{
-			m_settings.level = atoi(*s.second);
+			settings.level = atoi(*s.second);
 		}
 		else if (s.first == "difficulty")
 		{
-			m_settings.difficulty = 0;
+			settings.difficulty = 0;
 			if (s.second == "challenge")
 			{
-				m_settings.difficulty = 1;
+				settings.difficulty = 1;
 			}
 			else if (s.second == "extended")
 			{
-				m_settings.difficulty = 2;
+				settings.difficulty = 2;
 			}
 			else if (s.second == "infinite")
 			{
-				m_settings.difficulty = 3;
+				settings.difficulty = 3;
 			}
 		}
 		else if (s.first == "po")
 		{
-			m_settings.previewOffset = atoi(*s.second);
+			settings.previewOffset = atoi(*s.second);
 		}
 		else if (s.first == "plength")
 		{
-			m_settings.previewDuration = atoi(*s.second);
+			settings.previewDuration = atoi(*s.second);
 		}
 		else if (s.first == "total")
 		{
-			m_settings.total = atoi(*s.second);
+			settings.total = atoi(*s.second);
 		}
 	}
+}
+
+bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
+{
+	KShootMap kshootMap;
+	if (!kshootMap.Init(input, metadataOnly))
+		return false;
+
+	EffectTypeMap effectTypeMap;
+	EffectTypeMap filterTypeMap;
+	Map<EffectType, int16> defaultEffectParams;
+
+	// Set defaults
+	{
+		defaultEffectParams[EffectType::Bitcrush] = 4;
+		defaultEffectParams[EffectType::Gate] = 8;
+		defaultEffectParams[EffectType::Retrigger] = 8;
+		defaultEffectParams[EffectType::Phaser] = 2000;
+		defaultEffectParams[EffectType::Flanger] = 2000;
+		defaultEffectParams[EffectType::Wobble] = 12;
+		defaultEffectParams[EffectType::SideChain] = 8;
+		defaultEffectParams[EffectType::TapeStop] = 50;
+	}
+
+	// Add all the custom effect types
+	for (auto it = kshootMap.fxDefines.begin(); it != kshootMap.fxDefines.end(); it++)
+	{
+		EffectType type = effectTypeMap.FindOrAddEffectType(it->first);
+		if (m_customEffects.Contains(type))
+			continue;
+		m_customEffects.Add(type, ParseCustomEffect(it->second));
+	}
+	for (auto it = kshootMap.filterDefines.begin(); it != kshootMap.filterDefines.end(); it++)
+	{
+		EffectType type = filterTypeMap.FindOrAddEffectType(it->first);
+		if (m_customFilters.Contains(type))
+			continue;
+		m_customFilters.Add(type, ParseCustomEffect(it->second));
+	}
+
+	// Process map settings
+	ProcessKShootSettings(kshootMap.settings, filterTypeMap, m_settings);
 
 	// Temporary map for timing points
 	Map<MapTime, TimingPoint*> timingPointMap;
@@ -507,9 +512,9 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 
 	for (KShootMap::TickIterator it(kshootMap); it; ++it)
 	{
-		const KShootBlock& block = it.GetCurrentBlock();
 		KShootTime time = it.GetTime();
 		const KShootTick& tick = *it;
+		uint32 blockSize = it.GetBlockSize();
 
 		// Calculate MapTime from current tick
 		double blockDuration = lastTimingPoint->GetBarDuration();
@@ -534,12 +539,11 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 		}
 
 		// Sub-Block offset by adding ticks together
-		double blockPercent = (double)tickFromStartOfTimingPoint / (double)block.ticks.size();
+		double blockPercent = (double)tickFromStartOfTimingPoint / (double)blockSize;
 		double tickOffset = blockPercent * blockDuration;
 		MapTime mapTime = lastTimingPoint->time + MapTime(blockDurationOffset + tickOffset);
 
-		bool lastTick = &block == &kshootMap.blocks.back() &&
-			&tick == &block.ticks.back();
+		bool lastTick = it.IsLastTick();
 
 		// flag set when a new effect parameter is set and a new hold notes should be created
 		bool splitupHoldNotes = false;
@@ -547,6 +551,8 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 		// Process settings
 		for (auto& p : tick.settings)
 		{
+			const KShootString& value = p.second;
+
 			// Functions that adds a new timing point at current location if it's not yet there
 			auto AddTimingPoint = [&](double newDuration, uint32 newNum, uint32 newDenom)
 			{
@@ -569,19 +575,18 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				blockDuration = lastTimingPoint->GetBarDuration();
 
 				// Set new first block duration based on remaining ticks
-				timingFirstBlockDuration = (double)(block.ticks.size() - time.tick) / (double)block.ticks.size() * blockDuration;
+				timingFirstBlockDuration = (double)(blockSize - time.tick) / (double)blockSize * blockDuration;
 			};
 
 			// Parser the effect and parameters of an FX button (1.60)
-			auto ParseFXAndParameters = [&](String in, int16* paramsOut)
+			auto ParseFXAndParameters = [&](const KShootString& in, int16* paramsOut)
 			{
 				// Clear parameters
 				memset(paramsOut, -1, sizeof(uint16) * maxEffectParamsPerButtons);
 
-				String effectName = in;
-				size_t paramSplit = in.find_first_of(';');
-				if (paramSplit != -1)
-					effectName = effectName.substr(0, paramSplit);
+				KShootString name = in, effectParams;
+				bool hasParams = in.Split(';', &name, &effectParams);
+				String effectName = name.ToString();
 				effectName.Trim();
 
 				// Clear effect instead?
@@ -595,35 +600,34 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 					return EffectType::None;
 				}
 
-				if (paramSplit != -1)
+				if (hasParams)
 				{
-					String paramA, paramB;
-					String effectParams = p.second.substr(paramSplit + 1);
-					if (effectParams.Split(";", &paramA, &paramB))
+					KShootString paramA, paramB;
+					if (effectParams.Split(';', &paramA, &paramB))
 					{
-						paramsOut[0] = atoi(*paramA);
-						paramsOut[1] = atoi(*paramB);
+						paramsOut[0] = paramA.ToInt();
+						paramsOut[1] = paramB.ToInt();
 					}
 					else
-						paramsOut[0] = atoi(*effectParams);
+						paramsOut[0] = effectParams.ToInt();
 				}
 				return *type;
 			};
 
 			if (p.first == "beat")
 			{
-				String n, d;
-				if (!p.second.Split("/", &n, &d))
+				KShootString n, d;
+				if (!value.Split('/', &n, &d))
 					assert(false);
-				uint32 num = atol(*n);
-				uint32 denom = atol(*d);
+				uint32 num = n.ToInt();
+				uint32 denom = d.ToInt();
 				//assert(denom % 4 == 0);
 
 				AddTimingPoint(lastTimingPoint->beatDuration, num, denom);
 			}
 			else if (p.first == "t")
 			{
-				double bpm = atof(*p.second);
+				double bpm = value.ToDouble();
 				AddTimingPoint(60000.0 / bpm, lastTimingPoint->numerator, lastTimingPoint->denominator);
 			}
 			else if (p.first == "laserrange_l")
@@ -636,22 +640,22 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 			}
 			else if (p.first == "fx-l") // KSH 1.6
 			{
-				currentButtonEffectTypes[0] = ParseFXAndParameters(p.second, currentButtonEffectParams);
+				currentButtonEffectTypes[0] = ParseFXAndParameters(value, currentButtonEffectParams);
 				splitupHoldNotes = true;
 			}
 			else if (p.first == "fx-r") // KSH 1.6
 			{
-				currentButtonEffectTypes[1] = ParseFXAndParameters(p.second, currentButtonEffectParams + maxEffectParamsPerButtons);
+				currentButtonEffectTypes[1] = ParseFXAndParameters(value, currentButtonEffectParams + maxEffectParamsPerButtons);
 				splitupHoldNotes = true;
 			}
 			else if (p.first == "fx-l_param1")
 			{
-				currentButtonEffectParams[0] = atoi(*p.second);
+				currentButtonEffectParams[0] = value.ToInt();
 				splitupHoldNotes = true;
 			}
 			else if (p.first == "fx-r_param1")
 			{
-				currentButtonEffectParams[maxEffectParamsPerButtons] = atoi(*p.second);
+				currentButtonEffectParams[maxEffectParamsPerButtons] = value.ToInt();
 				splitupHoldNotes = true;
 			}
 			else if (p.first == "filtertype")
@@ -660,13 +664,13 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				EventObjectState* evt = new EventObjectState();
 				evt->time = mapTime;
 				evt->key = EventKey::LaserEffectType;
-				evt->data.effectVal = ParseFilterType(p.second);
+				evt->data.effectVal = ParseFilterType(value.ToString(), filterTypeMap);
 				m_objectStates.Add(*evt);
 			}
 			else if (p.first == "pfiltergain")
 			{
 				// Inser filter type change event
-				float gain = (float)atol(*p.second) / 100.0f;
+				float gain = (float)value.ToInt() / 100.0f;
 				EventObjectState* evt = new EventObjectState();
 				evt->time = mapTime;
 				evt->key = EventKey::LaserEffectMix;
@@ -675,7 +679,7 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 			}
 			else if (p.first == "chokkakuvol")
 			{
-				float vol = (float)atol(*p.second) / 100.0f;
+				float vol = (float)value.ToInt() / 100.0f;
 				EventObjectState* evt = new EventObjectState();
 				evt->time = mapTime;
 				evt->key = EventKey::LaserEffectMix;
@@ -687,7 +691,7 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				ZoomControlPoint* point = new ZoomControlPoint();
 				point->time = mapTime;
 				point->index = 0;
-				point->zoom = (float)atol(*p.second) / 100.0f;
+				point->zoom = (float)value.ToInt() / 100.0f;
 				m_zoomControlPoints.Add(point);
 			}
 			else if (p.first == "zoom_top")
@@ -695,14 +699,14 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				ZoomControlPoint* point = new ZoomControlPoint();
 				point->time = mapTime;
 				point->index = 1;
-				point->zoom = (float)atol(*p.second) / 100.0f;
+				point->zoom = (float)value.ToInt() / 100.0f;
 				m_zoomControlPoints.Add(point);
 			}
 			else if (p.first == "lane_toggle")
 			{
 				LaneHideTogglePoint* point = new LaneHideTogglePoint();
 				point->time = mapTime;
-				point->duration = atol(*p.second);
+				point->duration = value.ToInt();
 				m_laneTogglePoints.Add(point);
 			}
 			else if (p.first == "tilt")
@@ -711,12 +715,12 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				evt->time = mapTime;
 				evt->key = EventKey::TrackRollBehaviour;
 				evt->data.rollVal = TrackRollBehaviour::Zero;
-				String v = p.second;
-				size_t f = v.find("keep_");
+				KShootString v = value;
+				size_t f = v.Find("keep_");
 				if (f != -1)
 				{
 					evt->data.rollVal = TrackRollBehaviour::Keep;
-					v = v.substr(f + 5);
+					v = KShootString(v.data + f + 5, v.length - f - 5);
 				}
 
 				if (v == "normal")
@@ -736,11 +740,12 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 			}
 			else if (p.first == "fx_sample")
 			{
-				auto it = std::find(m_samplePaths.begin(), m_samplePaths.end(), p.second);
+				String path = value.ToString();
+				auto it = std::find(m_samplePaths.begin(), m_samplePaths.end(), path);
 				if (it == m_samplePaths.end())
 				{
 					sampleIndex = m_samplePaths.size();
-					m_samplePaths.Add(p.second);
+					m_samplePaths.Add(path);
 				}
 				else
 				{
@@ -751,12 +756,12 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 			{
 				ChartStop* cs = new ChartStop();
 				cs->time = mapTime;
-				cs->duration = (atol(*p.second) / 192.0f) * (lastTimingPoint->beatDuration) * 4;
+				cs->duration = (value.ToInt() / 192.0f) * (lastTimingPoint->beatDuration) * 4;
 				m_chartStops.Add(cs);
 			}
 			else
 			{
-				Logf("[KSH]Unkown map parameter at %d:%d: %s", Logger::Warning, it.GetTime().block, it.GetTime().tick, p.first);
+				Logf("[KSH]Unkown map parameter at %d:%d: %s", Logger::Warning, it.GetTime().block, it.GetTime().tick, p.first.ToString());
 			}
 		}
 
@@ -826,7 +831,6 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 			{
 				// Create new hold state
 				state = new TempButtonState(mapTime);
-				uint32 div = (uint32)block.ticks.size();
 
 				if (lastHoldObject)
 					state->lastHoldObject = lastHoldObject;
@@ -923,7 +927,6 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 
 					// Create new hold state
 					state = new TempButtonState(mapTime);
-					uint32 div = (uint32)block.ticks.size();
 
 					if (i < 4)
 					{
@@ -1087,10 +1090,11 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 				//Speed is number of 192nd notes
 				if (!tick.add.empty() && tick.add[0] == '@')
 				{
-					state->spinType = tick.add[1];
-					state->spinDuration = std::stoi(tick.add.substr(2));
+					String add = tick.add.ToString();
+					state->spinType = add[1];
+					state->spinDuration = std::stoi(add.substr(2));
 					if(state->spinType == '(' || state->spinType == ')')
-						state->spinDuration = (3 * std::stoi(tick.add.substr(2))) / 4;
+						state->spinDuration = (3 * std::stoi(add.substr(2))) / 4;
 				}
 
 			}
@@ -1142,4 +1146,15 @@ bool Beatmap::m_ProcessKShootMap(BinaryStream& input, bool metadataOnly)
 	ObjectState::SortArray(m_objectStates);
 
 	return true;
-}
\ No newline at end of file
+}
+bool Beatmap::m_ProcessKShootHeader(BinaryStream& input, BeatmapSettings& settings)
+{
+	KShootMap kshootMap;
+	if (!kshootMap.Init(input, true))
+		return false;
+
+	// Custom filters are defined in the body, so the initial filter type can only be one of the default ones here
+	EffectTypeMap filterTypeMap;
+	ProcessKShootSettings(kshootMap.settings, filterTypeMap, settings);
+	return true;
+}
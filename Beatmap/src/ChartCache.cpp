@@ -0,0 +1,173 @@
+#include "stdafx.h"
+#include "ChartCache.hpp"
+#include "Shared/MemoryStream.hpp"
+#include "Shared/FileStream.hpp"
+#include "Shared/Files.hpp"
+#include "Shared/Profiling.hpp"
+
+String ChartCache::cacheFolder = "chartcache";
+const char* ChartCache::c_tempExtension = ".tmp";
+
+// Increment when the file layout changes, changes to the map format itself are checked by the map version
+static const uint32 chartCacheMagic = 0x43505843; // "CXPC"
+static const uint32 chartCacheVersion = 1;
+
+struct ChartCacheHeader
+{
+	uint32 magic;
+	uint32 version;
+	uint64 sourceSize;
+	uint64 sourceWriteTime;
+	uint64 dataSize;
+	uint64 checksum;
+};
+
+// FNV-1a hash
+static uint64 Hash(const uint8* data, size_t size)
+{
+	uint64 hash = 14695981039346656037ull;
+	for(size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool ChartCache::Load(const String& sourcePath, Beatmap& map, bool metadataOnly)
+{
+	File source;
+	if(!source.OpenRead(sourcePath))
+		return false;
+	uint64 sourceSize = source.GetSize();
+	uint64 sourceWriteTime = source.GetLastWriteTime();
+	source.Close();
+
+	String cachePath = m_GetCachePath(sourcePath);
+	if(!Path::FileExists(cachePath))
+		return false;
+	File file;
+	if(!file.OpenRead(cachePath))
+		return false;
+
+	ChartCacheHeader header;
+	if(file.Read(&header, sizeof(header)) != sizeof(header))
+		return false;
+	if(header.magic != chartCacheMagic || header.version != chartCacheVersion)
+		return false;
+	if(header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime)
+		return false;
+	if(file.GetSize() != sizeof(header) + header.dataSize)
+		return false;
+
+	Buffer data;
+	data.resize((size_t)header.dataSize);
+	if(file.Read(data.data(), data.size()) != data.size())
+		return false;
+	if(Hash(data.data(), data.size()) != header.checksum)
+	{
+		Logf("Damaged chart cache for %s", Logger::Warning, sourcePath);
+		return false;
+	}
+
+	MemoryReader reader(data);
+	return map.m_Serialize(reader, metadataOnly);
+}
+bool ChartCache::Save(const String& sourcePath, const Beatmap& map)
+{
+	File source;
+	if(!source.OpenRead(sourcePath))
+		return false;
+
+	Buffer data;
+	MemoryWriter writer(data);
+	if(!map.Save(writer))
+		return false;
+
+	ChartCacheHeader header = { 0 };
+	header.magic = chartCacheMagic;
+	header.version = chartCacheVersion;
+	header.sourceSize = source.GetSize();
+	header.sourceWriteTime = source.GetLastWriteTime();
+	header.dataSize = data.size();
+	header.checksum = Hash(data.data(), data.size());
+	source.Close();
+
+	if(!Path::IsDirectory(cacheFolder))
+		Path::CreateDir(cacheFolder);
+
+	// Readers only ever see the previous file or the complete new one
+	String cachePath = m_GetCachePath(sourcePath);
+	String tempPath = cachePath + c_tempExtension;
+	File file;
+	if(!file.OpenWrite(tempPath))
+		return false;
+	bool written = file.Write(&header, sizeof(header)) == sizeof(header) && file.Write(data.data(), data.size()) == data.size();
+	file.Close();
+	if(!written || !Path::Rename(tempPath, cachePath, true))
+	{
+		Path::Delete(tempPath);
+		return false;
+	}
+	return true;
+}
+void ChartCache::Prune(const Vector<String>& sourcePaths)
+{
+	if(!Path::IsDirectory(cacheFolder))
+		return;
+
+	Set<String> keep;
+	for(const String& sourcePath : sourcePaths)
+	{
+		keep.Add(m_GetCachePath(sourcePath));
+	}
+
+	// Temporary files left behind by a crash are removed along with their cached map
+	for(FileInfo& fi : Files::ScanFiles(cacheFolder))
+	{
+		if(fi.type != FileType::Regular)
+			continue;
+		String path = Path::Normalize(fi.fullPath);
+		String cachePath = path;
+		size_t tempLength = strlen(c_tempExtension);
+		if(path.size() > tempLength && path.compare(path.size() - tempLength, tempLength, c_tempExtension) == 0)
+			cachePath.resize(path.size() - tempLength);
+		if(!keep.Contains(cachePath))
+			Path::Delete(path);
+	}
+}
+Beatmap* ChartCache::LoadMap(const String& sourcePath)
+{
+	ProfilerScope $("Load Chart");
+
+	Beatmap* map = new Beatmap();
+	if(Load(sourcePath, *map))
+		return map;
+
+	// Parse the chart and keep the result for the next time
+	delete map;
+	map = new Beatmap();
+	File mapFile;
+	if(!mapFile.OpenRead(sourcePath))
+	{
+		delete map;
+		return nullptr;
+	}
+	FileReader reader(mapFile);
+	if(!map->Load(reader))
+	{
+		delete map;
+		return nullptr;
+	}
+	mapFile.Close();
+
+	if(!Save(sourcePath, *map))
+		Logf("Failed to save chart cache for %s", Logger::Warning, sourcePath);
+	return map;
+}
+String ChartCache::m_GetCachePath(const String& sourcePath)
+{
+	String fullPath = Path::Normalize(Path::Absolute(sourcePath));
+	uint64 hash = Hash((const uint8*)fullPath.data(), fullPath.size());
+	return Path::Normalize(cacheFolder + Path::sep + Utility::Sprintf("%016llx.chart", (unsigned long long)hash));
+}
@@ -2,15 +2,80 @@
 #include "KShootMap.hpp"
 #include "Shared/Profiling.hpp"
 
-String KShootTick::ToString() const
+// Reads a line ending in either "\r\n" or "\n" and moves <position> to the start of the next line
+static KShootString ReadLine(const char*& position, const char* end)
 {
-	return Sprintf("%s|%s|%s", *buttons, *fx, *laser);
+	const char* lineEnd = (const char*)memchr(position, '\n', end - position);
+	const char* next = lineEnd ? lineEnd + 1 : end;
+	if(!lineEnd)
+		lineEnd = end;
+	if(lineEnd > position && lineEnd[-1] == '\r')
+		lineEnd--;
+	KShootString line(position, lineEnd - position);
+	position = next;
+	return line;
 }
-void KShootTick::Clear()
+
+KShootString::KShootString(const char* data, size_t length) : data(data), length(length)
+{
+}
+bool KShootString::empty() const
+{
+	return length == 0;
+}
+char KShootString::operator[](size_t i) const
+{
+	assert(i < length);
+	return data[i];
+}
+bool KShootString::operator==(const char* other) const
+{
+	return strlen(other) == length && memcmp(data, other, length) == 0;
+}
+bool KShootString::operator!=(const char* other) const
+{
+	return !(*this == other);
+}
+bool KShootString::Split(char delim, KShootString* l, KShootString* r) const
+{
+	const char* f = (const char*)memchr(data, delim, length);
+	if(!f)
+		return false;
+	// Either output can be this string itself
+	KShootString left(data, f - data);
+	KShootString right(f + 1, length - left.length - 1);
+	if(l)
+		*l = left;
+	if(r)
+		*r = right;
+	return true;
+}
+size_t KShootString::Find(const char* str) const
+{
+	const char* end = data + length;
+	const char* f = std::search(data, end, str, str + strlen(str));
+	return f == end ? -1 : f - data;
+}
+int32 KShootString::ToInt() const
+{
+	// The text is not null terminated, numbers are short enough to be copied to the stack
+	char buffer[32];
+	size_t count = Math::Min(length, sizeof(buffer) - 1);
+	memcpy(buffer, data, count);
+	buffer[count] = 0;
+	return (int32)atol(buffer);
+}
+double KShootString::ToDouble() const
+{
+	char buffer[32];
+	size_t count = Math::Min(length, sizeof(buffer) - 1);
+	memcpy(buffer, data, count);
+	buffer[count] = 0;
+	return atof(buffer);
+}
+String KShootString::ToString() const
 {
-	buttons = "0000";
-	fx = "00";
-	laser = "--";
+	return String(data, length);
 }
 
 KShootTime::KShootTime() : block(-1), tick(-1)
@@ -20,46 +85,83 @@ KShootTime::KShootTime(uint32_t block, uint32_t tick) : block(block), tick(tick)
 {
 }
 KShootTime::operator bool() const
-{ 
-	return block != -1; 
+{
+	return block != -1;
 }
 
-KShootMap::TickIterator::TickIterator(KShootMap& map, KShootTime start /*= KShootTime(0, 0)*/) : m_time(start), m_map(map)
+KShootMap::TickIterator::TickIterator(const KShootMap& map) : m_map(map), m_time(0, 0)
 {
-	if(!m_map.GetBlock(m_time, m_currentBlock))
-		m_currentBlock = nullptr;
+	m_position = (const char*)m_map.m_data.data() + m_map.m_bodyStart;
+	m_valid = m_HasBlock() && m_ReadTick();
 }
 KShootMap::TickIterator& KShootMap::TickIterator::operator++()
 {
 	m_time.tick++;
-	if(m_time.tick >= m_currentBlock->ticks.size())
-	{
-		m_time.tick = 0;
-		m_time.block++;
-		if(!m_map.GetBlock(m_time, m_currentBlock))
-			m_currentBlock = nullptr;
-	}
+	m_valid = m_ReadTick();
 	return *this;
 }
 KShootMap::TickIterator::operator bool() const
 {
-	return m_currentBlock != nullptr;
+	return m_valid;
 }
-KShootTick& KShootMap::TickIterator::operator*()
+const KShootTick& KShootMap::TickIterator::operator*() const
 {
-	return m_currentBlock->ticks[m_time.tick];
+	return m_tick;
 }
-KShootTick* KShootMap::TickIterator::operator->()
+const KShootTick* KShootMap::TickIterator::operator->() const
 {
-	return &m_currentBlock->ticks[m_time.tick];
+	return &m_tick;
 }
 const KShootTime& KShootMap::TickIterator::GetTime() const
 {
 	return m_time;
 }
-const KShootBlock& KShootMap::TickIterator::GetCurrentBlock() const
+uint32 KShootMap::TickIterator::GetBlockSize() const
+{
+	return m_map.blockSizes[m_time.block];
+}
+bool KShootMap::TickIterator::IsLastTick() const
+{
+	return m_time.block == m_map.blockSizes.size() - 1 && m_time.tick == m_map.blockSizes.back() - 1;
+}
+bool KShootMap::TickIterator::m_HasBlock() const
+{
+	// Stops at the first empty bar or at the end of the last bar that was closed with a separator
+	return m_time.block < m_map.blockSizes.size() && m_map.blockSizes[m_time.block] > 0;
+}
+bool KShootMap::TickIterator::m_ReadTick()
 {
-	return *m_currentBlock;
+	// Settings of the previous tick are dropped, the vector keeps it's storage so this does not allocate
+	m_tick.settings.clear();
+
+	const char* end = (const char*)m_map.m_data.data() + m_map.m_data.size();
+	while(m_position < end)
+	{
+		KShootString line = ReadLine(m_position, end);
+		if(line.empty() || line[0] == '#')
+			continue;
+
+		if(line == c_sep)
+		{
+			m_time.block++;
+			m_time.tick = 0;
+			if(!m_HasBlock())
+				return false;
+			continue;
+		}
+
+		KShootTickSetting setting;
+		if(line.Split('=', &setting.first, &setting.second))
+		{
+			m_tick.settings.Add(setting);
+			continue;
+		}
+
+		// Already validated when the map was loaded
+		m_ParseTick(line, m_tick, 0);
+		return true;
+	}
+	return false;
 }
 
 KShootMap::KShootMap()
@@ -82,173 +184,169 @@ bool KShootMap::Init(BinaryStream& input, bool metadataOnly)
 		input.Seek(0);
 	}
 
-	uint32_t lineNumber = 0;
-	String line;
-	static const String lineEnding = "\r\n";
-
-	// Parse Header
-	while(TextStream::ReadLine(input, line, lineEnding))
-	{
-		line.Trim();
-		lineNumber++;
-		if(line == c_sep)
-		{
-			break;
-		}
-		String k, v;
-		if(line.empty())
-			continue;
-		if(!line.Split("=", &k, &v))
-			return false;
-		WString str = Utility::ConvertToWString(v);
-		settings.FindOrAdd(k) = v;
-	}
+	uint32 lineNumber = 0;
+	if(!m_ReadHeader(input, lineNumber))
+		return false;
 
 	if(metadataOnly)
 		return true;
 
-	// Line by line parser
-	KShootBlock block;
+	// Read the rest of the map
+	size_t offset = m_data.size();
+	m_data.resize(offset + (input.GetSize() - input.Tell()));
+	if(m_data.size() > offset && input.Serialize(m_data.data() + offset, m_data.size() - offset) != m_data.size() - offset)
+		return false;
+	const char* position = (const char*)m_data.data() + m_bodyStart;
+	const char* end = (const char*)m_data.data() + m_data.size();
+
+	// Count the ticks in every bar and read the effect definitions, which can be anywhere in the map
+	// the ticks themselves are read again by the TickIterator when the map is processed
+	uint32 numTicks = 0;
 	KShootTick tick;
-	KShootTime time = KShootTime(0, 0);
-	while(TextStream::ReadLine(input, line, lineEnding))
+	while(position < end)
 	{
+		KShootString line = ReadLine(position, end);
+		lineNumber++;
 		if(line.empty())
-		{
 			continue;
-		}
 
-		lineNumber++;
 		if(line == c_sep)
 		{
 			// End this block
-			blocks.push_back(block);
-			block = KShootBlock(); // Reset block
-			time.block++;
-			time.tick = 0;
+			blockSizes.Add(numTicks);
+			numTicks = 0;
 		}
-		else
+		else if(line[0] == '#')
 		{
-			if(line.empty())
-				continue;
-
-			String k, v;
-			if(line[0] == '#')
-			{
-				Vector<String> strings = line.Explode(" ");
-				String type = strings[0];
-				if(strings.size() != 3)
-				{
-					Logf("Invalid define found in ksh map @%d: %s", Logger::Warning, lineNumber, line);
-					continue;
-				}
-
-				KShootEffectDefinition def;
-				def.typeName = strings[1];
+			m_ParseDefine(line, lineNumber);
+		}
+		else if(!line.Split('=', nullptr, nullptr))
+		{
+			if(!m_ParseTick(line, tick, lineNumber))
+				return false;
+			numTicks++;
+		}
+	}
 
-				// Split up parameters
-				Vector<String> paramsString = strings[2].Explode(";");
-				for(auto param : paramsString)
-				{
-					String k, v;
-					if(!param.Split("=", &k, &v))
-					{
-						Logf("Invalid parameter in custom effect definition for [%s]@%d: \"%s\"", Logger::Warning, def.typeName, lineNumber, line);
-						continue;
-					}
-					def.parameters.Add(k, v);
-				}
+	return true;
+}
+bool KShootMap::m_ReadHeader(BinaryStream& input, uint32& lineNumber)
+{
+	// Read in small parts, so nothing after the header is read from the stream
+	static const size_t chunkSize = 4096;
 
-				if(strings[0] == "#define_fx")
-				{
-					fxDefines.Add(def.typeName, def);
-				}
-				else if(strings[0] == "#define_filter")
-				{
-					filterDefines.Add(def.typeName, def);
-				}
-				else
-				{
-					Logf("Unkown define statement in ksh @%d: \"%s\"", Logger::Warning, lineNumber, line);
-				}
-			}
-			else if(line.Split("=", &k, &v))
-			{
-				KShootTickSetting ts;
-				ts.first = k;
-				ts.second = v;
-				tick.settings.Add(ts);
-			}
-			else
-			{
-				// Parse tick content string 
-				// The format looks like:
-				// buttons*4|fx buttons*2|lasers*2 + additional things?
-				// (fx) buttons are either '1' for normal '2' for hold, '0' for nothing
-				//
-				// lasers use a char to indicate position from left to right ASCII characters '0' -> 'o' respectively
-				// '-' means no laser, ':' indicates a linear interpolation from previous point to the last point
+	size_t position = 0;
+	while(true)
+	{
+		const char* start = (const char*)m_data.data();
+		const char* lineStart = start + position;
+		const char* end = start + m_data.size();
 
-				line.Split("|", &tick.buttons, &tick.fx);
-				tick.fx.Split("|", &tick.fx, &tick.laser);
-				if(tick.buttons.length() != 4)
-				{
-					Logf("Invalid buttons at line %d", Logger::Error, lineNumber);
-					return false;
-				}
-				if(tick.fx.length() != 2)
-				{
-					Logf("Invalid FX buttons at line %d", Logger::Error, lineNumber);
-					return false;
-				}
-				if(tick.laser.length() < 2)
-				{
-					Logf("Invalid lasers at line %d", Logger::Error, lineNumber);
-					return false;
-				}
-				if(tick.laser.length() > 2)
-				{
-					tick.add = tick.laser.substr(2);
-					tick.laser = tick.laser.substr(0, 2);
-				}
+		// Only read complete lines, unless the stream ended
+		bool completeLine = lineStart < end && memchr(lineStart, '\n', end - lineStart);
+		if(!completeLine && input.Tell() < input.GetSize())
+		{
+			size_t offset = m_data.size();
+			m_data.resize(offset + Math::Min(chunkSize, input.GetSize() - input.Tell()));
+			if(input.Serialize(m_data.data() + offset, m_data.size() - offset) != m_data.size() - offset)
+				return false;
+			continue;
+		}
+		if(lineStart == end)
+			break;
 
-				block.ticks.push_back(tick);
-				tick = KShootTick(); // Reset tick
-				time.tick++;
-			}
+		String line = ReadLine(lineStart, end).ToString();
+		position = lineStart - start;
+		line.Trim();
+		lineNumber++;
+		if(line == c_sep)
+		{
+			break;
 		}
+		String k, v;
+		if(line.empty())
+			continue;
+		if(!line.Split("=", &k, &v))
+			return false;
+		settings.FindOrAdd(k) = v;
 	}
-
+	m_bodyStart = position;
 	return true;
 }
-bool KShootMap::GetBlock(const KShootTime& time, KShootBlock*& tickOut)
-{
-	if(!time)
-		return false;
-	if(time.block >= blocks.size())
-		return false;
-	tickOut = &blocks[time.block];
-	return tickOut->ticks.size() > 0;
-}
-bool KShootMap::GetTick(const KShootTime& time, KShootTick*& tickOut)
+bool KShootMap::m_ParseTick(const KShootString& line, KShootTick& tick, uint32 lineNumber)
 {
-	if(!time)
+	// Parse tick content string
+	// The format looks like:
+	// buttons*4|fx buttons*2|lasers*2 + additional things?
+	// (fx) buttons are either '1' for normal '2' for hold, '0' for nothing
+	//
+	// lasers use a char to indicate position from left to right ASCII characters '0' -> 'o' respectively
+	// '-' means no laser, ':' indicates a linear interpolation from previous point to the last point
+
+	tick.buttons = tick.fx = tick.laser = tick.add = KShootString();
+	line.Split('|', &tick.buttons, &tick.fx);
+	tick.fx.Split('|', &tick.fx, &tick.laser);
+	if(tick.buttons.length != 4)
+	{
+		Logf("Invalid buttons at line %d", Logger::Error, lineNumber);
 		return false;
-	if(time.block >= blocks.size())
+	}
+	if(tick.fx.length != 2)
+	{
+		Logf("Invalid FX buttons at line %d", Logger::Error, lineNumber);
 		return false;
-	KShootBlock& b = blocks[time.block];
-	if(time.tick >= b.ticks.size() || time.tick < 0)
+	}
+	if(tick.laser.length < 2)
+	{
+		Logf("Invalid lasers at line %d", Logger::Error, lineNumber);
 		return false;
-	tickOut = &b.ticks[time.tick];
+	}
+	if(tick.laser.length > 2)
+	{
+		tick.add = KShootString(tick.laser.data + 2, tick.laser.length - 2);
+		tick.laser.length = 2;
+	}
 	return true;
 }
-float KShootMap::TimeToFloat(const KShootTime& time) const
+void KShootMap::m_ParseDefine(const KShootString& line, uint32 lineNumber)
 {
-	KShootBlock* block;
-	if(!const_cast<KShootMap*>(this)->GetBlock(time, block))
-		return -1.0f;
-	float seg = (float)time.tick / (float)block->ticks.size();
-	return (float)time.block + seg;
+	// Definitions are rare enough to be parsed as normal strings
+	String defineLine = line.ToString();
+	Vector<String> strings = defineLine.Explode(" ");
+	if(strings.size() != 3)
+	{
+		Logf("Invalid define found in ksh map @%d: %s", Logger::Warning, lineNumber, defineLine);
+		return;
+	}
+
+	KShootEffectDefinition def;
+	def.typeName = strings[1];
+
+	// Split up parameters
+	Vector<String> paramsString = strings[2].Explode(";");
+	for(auto param : paramsString)
+	{
+		String k, v;
+		if(!param.Split("=", &k, &v))
+		{
+			Logf("Invalid parameter in custom effect definition for [%s]@%d: \"%s\"", Logger::Warning, def.typeName, lineNumber, defineLine);
+			continue;
+		}
+		def.parameters.Add(k, v);
+	}
+
+	if(strings[0] == "#define_fx")
+	{
+		fxDefines.Add(def.typeName, def);
+	}
+	else if(strings[0] == "#define_filter")
+	{
+		filterDefines.Add(def.typeName, def);
+	}
+	else
+	{
+		Logf("Unkown define statement in ksh @%d: \"%s\"", Logger::Warning, lineNumber, defineLine);
+	}
 }
 float KShootMap::TranslateLaserChar(char c) const
 {
@@ -280,4 +378,4 @@ float KShootMap::TranslateLaserChar(char c) const
 	}
 	return (float)index[0] / (float)(laserCharacters.size()-1);
 }
-const char* KShootMap::c_sep = "--";
\ No newline at end of file
+const char* KShootMap::c_sep = "--";
@@ -2,8 +2,10 @@
 #include "MapDatabase.hpp"
 #include "Database.hpp"
 #include "Beatmap.hpp"
+#include "ChartCache.hpp"
 #include "Shared/Profiling.hpp"
 #include "Shared/Files.hpp"
+#include "Shared/Jobs.hpp"
 #include <thread>
 #include <mutex>
 #include <chrono>
@@ -22,6 +24,8 @@ public:
 	bool m_interruptSearch = false;
 	Set<String> m_searchPaths;
 	Database m_database;
+	// Used to load found maps in parallel
+	JobSheduler* m_jobSheduler = nullptr;
 
 	Map<int32, MapIndex*> m_maps;
 	Map<int32, DifficultyIndex*> m_difficulties;
@@ -626,17 +630,28 @@ private:
 					AddChange(evt);
 				}
 			}
+
+			// Cached maps of charts that are gone would never be used again
+			Vector<String> sourcePaths;
+			for(auto f : fileList)
+			{
+				sourcePaths.Add(f.first);
+			}
+			ChartCache::Prune(sourcePaths);
 		}
 
 		{
 			ProfilerScope $("Map Database - Process New Files");
 
-			// Process scanned files
+			// Find files that are new or changed
+			struct FoundMap
+			{
+				Event evt;
+				bool existed;
+			};
+			Vector<FoundMap> found;
 			for(auto f : fileList)
 			{
-				if(!m_searching)
-					break;
-
 				uint64 mylwt = f.second.lastWriteTime;
 				Event evt;
 				evt.lwt = mylwt;
@@ -663,38 +678,55 @@ private:
 				}
 
 				Logf("Discovered Map [%s]", Logger::Info, f.first);
+				evt.path = f.first;
+				found.Add({ evt, existing != nullptr });
+			}
 
-				// Try to read map metadata
-				bool mapValid = false;
+			// Try to read map metadata, maps don't depend on each other
+			//	only the header of a map is read, not the rest of the file
+			auto loadMap = [&](uint32 i)
+			{
+				if(!m_searching)
+					return;
 				File fileStream;
-				Beatmap map;
-				if(fileStream.OpenRead(f.first))
+				BeatmapSettings settings;
+				if(fileStream.OpenRead(found[i].evt.path))
 				{
 					FileReader reader(fileStream);
-
-					if(map.Load(reader, true))
-					{
-						mapValid = true;
-					}
+					if(Beatmap::LoadSettings(reader, settings))
+						found[i].evt.mapData = new BeatmapSettings(settings);
 				}
+			};
+			if(m_jobSheduler)
+			{
+				m_jobSheduler->ParallelFor(0, (uint32)found.size(), 4, loadMap);
+			}
+			else
+			{
+				for(uint32 i = 0; i < found.size(); i++)
+					loadMap(i);
+			}
 
-				if(mapValid)
+			for(uint32 i = 0; i < found.size(); i++)
+			{
+				if(!m_searching)
 				{
-					evt.mapData = new BeatmapSettings(map.GetMapSettings());
+					delete found[i].evt.mapData;
+					continue;
 				}
-				else
+
+				Event& evt = found[i].evt;
+				if(!evt.mapData)
 				{
-					if(!existing) // Never added
+					if(!found[i].existed) // Never added
 					{
-						Logf("Skipping corrupted map [%s]", Logger::Warning, f.first);
+						Logf("Skipping corrupted map [%s]", Logger::Warning, evt.path);
 						continue;
 					}
 					// Invalid maps get removed from the database
 					evt.action = Event::Removed;
 				}
-				evt.path = f.first;
 				AddChange(evt);
-				continue;
 			}
 		}
 		m_searching = false;
@@ -737,6 +769,10 @@ MapIndex* MapDatabase::GetMap(int32 idx)
 	MapIndex** mapIdx = m_impl->m_maps.Find(idx);
 	return mapIdx ? *mapIdx : nullptr;
 }
+void MapDatabase::SetJobSheduler(JobSheduler* sheduler)
+{
+	m_impl->m_jobSheduler = sheduler;
+}
 void MapDatabase::AddSearchPath(const String& path)
 {
 	m_impl->AddSearchPath(path);
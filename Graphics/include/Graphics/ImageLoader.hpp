@@ -13,5 +13,7 @@ namespace Graphics
 	{
 	public:
 		static bool Load(ImageRes* outPtr, const String& fullPath);
+		// Loads from the contents of an image file that was already read
+		static bool Load(ImageRes* outPtr, Buffer& data);
 	};
 }
\ No newline at end of file
@@ -79,6 +79,8 @@ namespace Graphics
 		static Ref<MaterialRes> Create(class OpenGL* gl);
 		// Create a material that has both a vertex and fragment shader
 		static Ref<MaterialRes> Create(class OpenGL* gl, const String& vsPath, const String& fsPath);
+		// Create a material from a vertex and fragment shader that were already loaded
+		static Ref<MaterialRes> Create(class OpenGL* gl, Shader vertexShader, Shader fragmentShader);
 
 		bool opaque = true;
 		MaterialBlendMode blendMode = MaterialBlendMode::Normal;
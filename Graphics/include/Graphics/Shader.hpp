@@ -19,6 +19,8 @@ namespace Graphics
 	public:
 		virtual ~ShaderRes() = default;
 		static Ref<ShaderRes> Create(class OpenGL* gl, ShaderType type, const String& assetPath);
+		// Creates a shader from source that was already read from <assetPath>, the path is still used for logging and hot-reloading
+		static Ref<ShaderRes> Create(class OpenGL* gl, ShaderType type, const String& assetPath, const String& source);
 		static void Unbind(class OpenGL* gl, ShaderType type);
 		friend class OpenGL;
 	public:
@@ -133,6 +133,10 @@ namespace Graphics
 
 			Buffer b(f.GetSize());
 			f.Read(b.data(), b.size());
+			return Load(pImage, b);
+		}
+		bool Load(ImageRes* pImage, Buffer& b)
+		{
 			if(b.size() < 4)
 				return false;
 
@@ -155,4 +159,8 @@ namespace Graphics
 	{
 		return ImageLoader_Impl::Main().Load(pImage, fullPath);
 	}
+	bool ImageLoader::Load(ImageRes* pImage, Buffer& data)
+	{
+		return ImageLoader_Impl::Main().Load(pImage, data);
+	}
 }
\ No newline at end of file
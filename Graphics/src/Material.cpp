@@ -397,6 +397,20 @@ namespace Graphics
 
 		return GetResourceManager<ResourceType::Material>().Register(impl);
 	}
+	Material MaterialRes::Create(OpenGL* gl, Shader vertexShader, Shader fragmentShader)
+	{
+		if(!vertexShader || !fragmentShader)
+			return Material();
+
+		Material_Impl* impl = new Material_Impl(gl);
+		impl->AssignShader(ShaderType::Vertex, vertexShader);
+		impl->AssignShader(ShaderType::Fragment, fragmentShader);
+#if _DEBUG
+		impl->m_debugNames[(size_t)ShaderType::Vertex] = vertexShader->GetOriginalName();
+		impl->m_debugNames[(size_t)ShaderType::Fragment] = fragmentShader->GetOriginalName();
+#endif
+		return GetResourceManager<ResourceType::Material>().Register(impl);
+	}
 
 	void MaterialParameterSet::SetParameter(const String& name, int sc)
 	{
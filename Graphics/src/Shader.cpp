@@ -64,19 +64,26 @@ namespace Graphics
 			m_changeNotification = FindFirstChangeNotificationA(*rootFolder, false, FILE_NOTIFY_CHANGE_LAST_WRITE);
 #endif
 		}
-		bool LoadProgram(uint32& programOut)
+		// Reads the source from m_sourcePath if no <source> is given
+		bool LoadProgram(uint32& programOut, const String* source = nullptr)
 		{
-			File in;
-			if(!in.OpenRead(m_sourcePath))
-				return false;
-
 			String sourceStr;
-			sourceStr.resize(in.GetSize());
+			if(source)
+			{
+				sourceStr = *source;
+			}
+			else
+			{
+				File in;
+				if(!in.OpenRead(m_sourcePath))
+					return false;
+				sourceStr.resize(in.GetSize());
+				if(sourceStr.size() > 0)
+					in.Read(&sourceStr.front(), sourceStr.size());
+			}
 			if(sourceStr.size() == 0)
 				return false;
 
-			in.Read(&sourceStr.front(), sourceStr.size());
-
 			const char* pChars = *sourceStr;
 			programOut = glCreateShaderProgramv(typeMap[(size_t)m_type], 1, &pChars);
 			if(programOut == 0)
@@ -97,7 +104,7 @@ namespace Graphics
 			// Shader hot-reload in debug mode
 #if defined(_DEBUG) && defined(_WIN32)
 			// Store last write time
-			m_lwt = in.GetLastWriteTime();
+			m_lwt = File::GetLastWriteTime(m_sourcePath);
 			SetupChangeHandler();
 #endif
 			return true;
@@ -129,11 +136,11 @@ namespace Graphics
 			return false;
 		}
 
-		bool Init(ShaderType type, const String& name)
+		bool Init(ShaderType type, const String& name, const String* source = nullptr)
 		{
 			m_sourcePath = Path::Normalize(name);
 			m_type = type;
-			return LoadProgram(m_prog);
+			return LoadProgram(m_prog, source);
 		}
 
 		virtual void Bind()
@@ -225,6 +232,19 @@ namespace Graphics
 			return GetResourceManager<ResourceType::Shader>().Register(pImpl);
 		}
 	}
+	Shader ShaderRes::Create(class OpenGL* gl, ShaderType type, const String& assetPath, const String& source)
+	{
+		Shader_Impl* pImpl = new Shader_Impl(gl);
+		if(!pImpl->Init(type, assetPath, &source))
+		{
+			delete pImpl;
+			return Shader();
+		}
+		else
+		{
+			return GetResourceManager<ResourceType::Shader>().Register(pImpl);
+		}
+	}
 	void ShaderRes::Unbind(class OpenGL* gl, ShaderType type)
 	{
 		if(gl->m_activeShaders[(size_t)type] != 0)
@@ -61,6 +61,9 @@ Vector2i g_resolution;
 
 static float g_avgRenderDelta = 0.0f;
 
+// Time spent finalizing finished jobs every frame, so many jobs finishing at once don't cause a hitch
+static const float jobFinalizeTimeBudget = 0.002f;
+
 Application::Application()
 {
 	// Enforce single instance
@@ -251,12 +254,18 @@ bool Application::m_Init()
 
 		// Init audio
 		new Audio();
-		if(!g_audio->Init())
+		uint32 audioBufferSize = (uint32)Math::Max(0, g_gameConfig.GetInt(GameConfigKeys::AudioBufferSize));
+		uint32 audioSampleRate = (uint32)Math::Max(0, g_gameConfig.GetInt(GameConfigKeys::AudioSampleRate));
+		if(!g_audio->Init(audioBufferSize, audioSampleRate))
 		{
 			Log("Audio initialization failed", Logger::Error);
 			delete g_audio;
 			return 1;
 		}
+		g_audio->SetLatencyCompensation(g_gameConfig.GetBool(GameConfigKeys::AudioLatencyCompensation));
+		g_audio->SetCacheMemoryBudget((size_t)Math::Max(0, g_gameConfig.GetInt(GameConfigKeys::AudioCacheSize)) * 1024 * 1024);
+		if(g_gameConfig.GetBool(GameConfigKeys::AudioCacheToDisk))
+			g_audio->SetCacheFolder("audiocache");
 
 		// Debug Mute?
 		// Test tracks may get annoying when continously debugging ;)
@@ -310,6 +319,7 @@ void Application::m_MainLoop()
 {
 	Timer appTimer;
 	m_lastRenderTime = 0.0f;
+	float jobTimeLeft = jobFinalizeTimeBudget;
 	while(true)
 	{
 		// Process changes in the list of items
@@ -403,14 +413,20 @@ void Application::m_MainLoop()
 
 			m_Tick();
 			timeSinceRender = 0.0f;
+			jobTimeLeft = jobFinalizeTimeBudget;
 
 			// Garbage collect resources
 			ResourceManagers::TickAll();
 		}
 
 		// Tick job sheduler
-		// processed callbacks for finished tasks
-		g_jobSheduler->Update();
+		// processed callbacks for finished tasks, until this frame's budget is used up
+		if(jobTimeLeft > 0.0f)
+		{
+			float jobStart = appTimer.SecondsAsFloat();
+			g_jobSheduler->Update(jobTimeLeft);
+			jobTimeLeft -= appTimer.SecondsAsFloat() - jobStart;
+		}
 
 		if(timeSinceRender < targetRenderTime)
 		{
@@ -579,6 +595,53 @@ Material Application::LoadMaterial(const String& name)
 	assert(ret);
 	return ret;
 }
+static bool ReadShaderSource(const String& path, String& out)
+{
+	File in;
+	if(!in.OpenRead(path))
+		return false;
+	out.resize(in.GetSize());
+	if(out.empty())
+		return false;
+	return in.Read(&out.front(), out.size()) == out.size();
+}
+bool Application::ReadMaterialSources(const String& name, MaterialSources& out)
+{
+	out.vertexPath = String("skins/") + m_skin + String("/shaders/") + name + ".vs";
+	out.fragmentPath = String("skins/") + m_skin + String("/shaders/") + name + ".fs";
+	out.geometryPath = String("skins/") + m_skin + String("/shaders/") + name + ".gs";
+	if(!ReadShaderSource(out.vertexPath, out.vertex))
+	{
+		Logf("Failed to read vertex shader for material from %s", Logger::Error, out.vertexPath);
+		return false;
+	}
+	if(!ReadShaderSource(out.fragmentPath, out.fragment))
+	{
+		Logf("Failed to read fragment shader for material from %s", Logger::Error, out.fragmentPath);
+		return false;
+	}
+	if(Path::FileExists(out.geometryPath))
+		ReadShaderSource(out.geometryPath, out.geometry);
+	return true;
+}
+Material Application::CreateMaterial(const MaterialSources& sources)
+{
+	Shader vshader = ShaderRes::Create(g_gl, ShaderType::Vertex, sources.vertexPath, sources.vertex);
+	Shader fshader = ShaderRes::Create(g_gl, ShaderType::Fragment, sources.fragmentPath, sources.fragment);
+	Material ret = MaterialRes::Create(g_gl, vshader, fshader);
+	if(!ret)
+	{
+		Logf("Failed to create material from %s and %s", Logger::Error, sources.vertexPath, sources.fragmentPath);
+		return ret;
+	}
+	if(!sources.geometry.empty())
+	{
+		Shader gshader = ShaderRes::Create(g_gl, ShaderType::Geometry, sources.geometryPath, sources.geometry);
+		assert(gshader);
+		ret->AssignShader(ShaderType::Geometry, gshader);
+	}
+	return ret;
+}
 Sample Application::LoadSample(const String& name, const bool& external)
 {
     String path;
@@ -9,6 +9,18 @@ extern class Application* g_application;
 extern class JobSheduler* g_jobSheduler;
 extern class Input g_input;
 
+// Shader sources of a skin material
+struct MaterialSources
+{
+	String vertexPath;
+	String fragmentPath;
+	String geometryPath;
+	String vertex;
+	String fragment;
+	// Empty if the material has no geometry shader
+	String geometry;
+};
+
 // GUI
 extern class GUIRenderer* g_guiRenderer;
 extern Ref<class Canvas> g_rootCanvas;
@@ -49,6 +61,10 @@ public:
 	Texture LoadTexture(const String& name);
 	Texture LoadTexture(const String & name, const bool& external);
 	Material LoadMaterial(const String& name);
+	// Reads the shaders of a material, can be called from any thread
+	bool ReadMaterialSources(const String& name, MaterialSources& out);
+	// Creates a material from sources read by ReadMaterialSources, on the main thread
+	Material CreateMaterial(const MaterialSources& sources);
 	Sample LoadSample(const String& name, const bool& external = false);
 
 	float GetAppTime() const { return m_lastRenderTime; }
@@ -1,10 +1,13 @@
 #include "stdafx.h"
 #include "AsyncAssetLoader.hpp"
 #include "Application.hpp"
+#include "Shared/Jobs.hpp"
+#include <cfloat>
 
 struct AsyncLoadOperation : public IAsyncLoadable
 {
 	String name;
+	bool loaded = false;
 };
 struct AsyncTextureLoadOperation : public AsyncLoadOperation
 {
@@ -45,17 +48,19 @@ struct AsyncMeshLoadOperation : public AsyncLoadOperation
 struct AsyncMaterialLoadOperation : public AsyncLoadOperation
 {
 	Material& target;
+	MaterialSources sources;
 	AsyncMaterialLoadOperation(Material& target, const String& path) : target(target)
 	{
 		name = path;
 	}
 	bool AsyncLoad()
 	{
-		return true;
+		// Shaders have to be compiled on the main thread, only read them here
+		return g_application->ReadMaterialSources(name, sources);
 	}
 	bool AsyncFinalize()
 	{
-		return (target = g_application->LoadMaterial(name)).IsValid();
+		return (target = g_application->CreateMaterial(sources)).IsValid();
 	}
 };
 struct AsyncWrapperOperation : public AsyncLoadOperation
@@ -73,12 +78,19 @@ struct AsyncWrapperOperation : public AsyncLoadOperation
 	{
 		return target.AsyncFinalize();
 	}
+	bool AsyncFinalizeStep(float timeBudget)
+	{
+		return target.AsyncFinalizeStep(timeBudget);
+	}
 };
 
 class AsyncAssetLoader_Impl
 {
 public:
 	Vector<AsyncLoadOperation*> loadables;
+	// Index of the next loadable to finalize
+	uint32 nextFinalize = 0;
+	bool success = true;
 	~AsyncAssetLoader_Impl()
 	{
 		for(auto& loadable : loadables)
@@ -116,28 +128,51 @@ void AsyncAssetLoader::AddLoadable(IAsyncLoadable& loadable, const String& id /*
 
 bool AsyncAssetLoader::Load()
 {
-	bool success = true;
-	for(auto& ld : m_impl->loadables)
+	// Loadables don't depend on each other until they are finalized
+	Vector<AsyncLoadOperation*>& loadables = m_impl->loadables;
+	g_jobSheduler->ParallelFor(0, (uint32)loadables.size(), 1, [&](uint32 i)
 	{
-		if(!ld->AsyncLoad())
+		loadables[i]->loaded = loadables[i]->AsyncLoad();
+	});
+
+	for(auto& ld : loadables)
+	{
+		if(!ld->loaded)
 		{
 			Logf("[AsyncLoad] Load failed on %s", Logger::Error, ld->name);
-			success = false;
+			m_impl->success = false;
 		}
 	}
-	return success;
+	return m_impl->success;
 }
-bool AsyncAssetLoader::Finalize()
+bool AsyncAssetLoader::FinalizeStep(float timeBudget)
 {
-	bool success = true;
-	for(auto& ld : m_impl->loadables)
+	// Finalize in order, later loadables can use the ones before them
+	Timer timer;
+	Vector<AsyncLoadOperation*>& loadables = m_impl->loadables;
+	while(m_impl->nextFinalize < loadables.size())
 	{
+		AsyncLoadOperation* ld = loadables[m_impl->nextFinalize];
+		if(!ld->AsyncFinalizeStep(timeBudget - timer.SecondsAsFloat()))
+			return false;
 		if(!ld->AsyncFinalize())
 		{
 			Logf("[AsyncLoad] Finalize failed on %s", Logger::Error, ld->name);
-			success = false;
+			m_impl->success = false;
 		}
+		m_impl->nextFinalize++;
+
+		if(timer.SecondsAsFloat() >= timeBudget)
+			break;
+	}
+	return m_impl->nextFinalize == loadables.size();
+}
+bool AsyncAssetLoader::Finalize()
+{
+	while(!FinalizeStep(FLT_MAX))
+	{
 	}
+	bool success = m_impl->success;
 
 	// Clear state
 	delete m_impl;
@@ -4,6 +4,7 @@
 /*
 	Loads assets and IAsyncLoadables 
 	Acts like a queue that stores loading commands
+	Everything is loaded at the same time on the job threads, and finalized in the order it was added
 */
 class AsyncAssetLoader : public Unique
 {
@@ -22,6 +23,10 @@ public:
 	void AddLoadable(IAsyncLoadable& loadable, const String& id = "unknown");
 
 	bool Load();
+	// Finalizes assets until <timeBudget> seconds passed
+	//	returns true once all assets are finalized
+	bool FinalizeStep(float timeBudget);
+	// Finalizes the remaining assets, returns false if any asset failed to load or finalize
 	bool Finalize();
 
 private:
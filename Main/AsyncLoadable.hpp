@@ -18,6 +18,13 @@ public:
 	//	for example, any OpenGL stuff
 	//	returns success
 	virtual bool AsyncFinalize() = 0;
+	// Called on the main thread once every frame before AsyncFinalize, until it returns true
+	//	allows spreading expensive finalization, like texture uploads, over multiple frames
+	//	should return after about <timeBudget> seconds
+	virtual bool AsyncFinalizeStep(float timeBudget)
+	{
+		return true;
+	}
 };
 
 // Both an application tickable and async loadable
@@ -5,6 +5,9 @@
 #include <Audio/Audio.hpp>
 #include <Audio/DSP.hpp>
 
+// Length of the start of the music that is kept decoded, so restarting a chart doesn't have to decode it again
+static const int32 cachedIntroLength = 10000;
+
 AudioPlayback::AudioPlayback()
 {
 }
@@ -23,6 +26,24 @@ bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootP
 	m_CleanupDSP(m_buttonDSPs[1]);
 	m_CleanupDSP(m_laserDSP);
 
+	// Prepare effects up front, so activating them during a chart doesn't allocate
+	//	one for the laser and one for each button
+	if(m_dspPool.GetNumFree<BQFDSP>() == 0)
+	{
+		uint32 sampleRate = g_audio->GetSampleRate();
+		m_dspPool.Reserve<BQFDSP>(3, sampleRate);
+		m_dspPool.Reserve<BitCrusherDSP>(3, sampleRate);
+		m_dspPool.Reserve<EchoDSP>(2, sampleRate);
+		m_dspPool.Reserve<GateDSP>(2, sampleRate);
+		m_dspPool.Reserve<TapeStopDSP>(2, sampleRate);
+		m_dspPool.Reserve<RetriggerDSP>(2, sampleRate);
+		m_dspPool.Reserve<WobbleDSP>(2, sampleRate);
+		m_dspPool.Reserve<PhaserDSP>(2, sampleRate);
+		m_dspPool.Reserve<FlangerDSP>(2, sampleRate);
+		m_dspPool.Reserve<SidechainDSP>(2, sampleRate);
+		m_dspPool.Reserve<PitchShiftDSP>(2, sampleRate);
+	}
+
 	m_playback = &playback;
 	m_beatmap = &playback.GetBeatmap();
 	m_beatmapRootPath = mapRootPath;
@@ -39,7 +60,7 @@ bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootP
 		Logf("Audio file for beatmap does not exists at: \"%s\"", Logger::Error, audioPath);
 		return false;
 	}
-	m_music = g_audio->CreateStream(audioPath, true);
+	m_music = g_audio->CreateStream(audioPath, true, cachedIntroLength);
 	if(!m_music)
 	{
 		Logf("Failed to load any audio for beatmap \"%s\"", Logger::Error, audioPath);
@@ -58,7 +79,7 @@ bool AudioPlayback::Init(class BeatmapPlayback& playback, const String& mapRootP
 		}
 		else
 		{
-			m_fxtrack = g_audio->CreateStream(audioPath, true);
+			m_fxtrack = g_audio->CreateStream(audioPath, true, cachedIntroLength);
 			if(m_fxtrack)
 			{
 				// Initially mute normal track if fx is enabled
@@ -245,12 +266,26 @@ const String& AudioPlayback::GetBeatmapRootPath() const
 {
 	return m_beatmapRootPath;
 }
+DSPPool& AudioPlayback::GetDSPPool()
+{
+	return m_dspPool;
+}
+float AudioPlayback::GetEffectProcessTime() const
+{
+	uint32 time = 0;
+	for(DSP* dsp : { m_buttonDSPs[0], m_buttonDSPs[1], m_laserDSP })
+	{
+		if(dsp)
+			time += dsp->GetProcessTime();
+	}
+	return (float)time * 0.001f;
+}
 void AudioPlayback::m_CleanupDSP(DSP*& ptr)
 {
 	if(ptr)
 	{
 		m_GetDSPTrack()->RemoveDSP(ptr);
-		delete ptr;
+		m_dspPool.Release(ptr);
 		ptr = nullptr;
 	}
 }
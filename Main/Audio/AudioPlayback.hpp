@@ -2,6 +2,7 @@
 #include <Beatmap/Beatmap.hpp>
 #include <Beatmap/AudioEffects.hpp>
 #include <Audio/AudioStream.hpp>
+#include <Audio/DSPPool.hpp>
 
 /*
 	Audio effect with customized parameters
@@ -70,6 +71,10 @@ public:
 	BeatmapPlayback& GetBeatmapPlayback();
 	const Beatmap& GetBeatmap() const;
 	const String& GetBeatmapRootPath() const;
+	// Effect DSP's are taken from here and returned when the effect ends
+	DSPPool& GetDSPPool();
+	// Time in microseconds the active effects took in the last mixed block
+	float GetEffectProcessTime() const;
 
 private:
 	// Returns the track that should have effects applied to them
@@ -98,4 +103,7 @@ private:
 	class DSP* m_buttonDSPs[2] = { nullptr };
 	HoldObjectState* m_currentHoldEffects[2] = { nullptr };
 	float m_effectMix[2] = { 0.0f };
+
+	// Effect DSP's that are not in use
+	DSPPool m_dspPool;
 };
\ No newline at end of file
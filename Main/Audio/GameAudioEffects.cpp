@@ -13,12 +13,11 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 
 	float filterInput = playback.GetLaserFilterInput();
 	uint32 actualLength = duration.Sample(filterInput).Absolute(noteDuration);
-	uint32 maxLength = Math::Max(duration.Sample(0.f).Absolute(noteDuration), duration.Sample(1.f).Absolute(noteDuration));
 	switch(type)
 	{
 	case EffectType::Bitcrush:
 	{
-		BitCrusherDSP* bcDSP = new BitCrusherDSP();
+		BitCrusherDSP* bcDSP = playback.GetDSPPool().Acquire<BitCrusherDSP>();
 		audioTrack->AddDSP(bcDSP);
 		bcDSP->SetPeriod((float)bitcrusher.reduction.Sample(filterInput));
 		ret = bcDSP;
@@ -26,7 +25,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::Echo:
 	{
-		EchoDSP* echoDSP = new EchoDSP();
+		EchoDSP* echoDSP = playback.GetDSPPool().Acquire<EchoDSP>();
 		audioTrack->AddDSP(echoDSP);
 		echoDSP->feedback = echo.feedback.Sample(filterInput);
 		echoDSP->SetLength(actualLength);
@@ -38,14 +37,14 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	case EffectType::HighPassFilter:
 	{
 		// Don't set anthing for biquad Filters
-		BQFDSP* bqfDSP = new BQFDSP();
+		BQFDSP* bqfDSP = playback.GetDSPPool().Acquire<BQFDSP>();
 		audioTrack->AddDSP(bqfDSP);
 		ret = bqfDSP;
 		break;
 	}
 	case EffectType::Gate:
 	{
-		GateDSP* gateDSP = new GateDSP();
+		GateDSP* gateDSP = playback.GetDSPPool().Acquire<GateDSP>();
 		audioTrack->AddDSP(gateDSP);
 		gateDSP->SetLength(actualLength);
 		gateDSP->SetGating(gate.gate.Sample(filterInput));
@@ -54,7 +53,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::TapeStop:
 	{
-		TapeStopDSP* tapestopDSP = new TapeStopDSP();
+		TapeStopDSP* tapestopDSP = playback.GetDSPPool().Acquire<TapeStopDSP>();
 		audioTrack->AddDSP(tapestopDSP);
 		tapestopDSP->SetLength(actualLength);
 		ret = tapestopDSP;
@@ -62,9 +61,8 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::Retrigger:
 	{
-		RetriggerDSP* retriggerDSP = new RetriggerDSP();
+		RetriggerDSP* retriggerDSP = playback.GetDSPPool().Acquire<RetriggerDSP>();
 		audioTrack->AddDSP(retriggerDSP);
-		retriggerDSP->SetMaxLength(maxLength);
 		retriggerDSP->SetLength(actualLength);
 		retriggerDSP->SetGating(retrigger.gate.Sample(filterInput));
 		retriggerDSP->SetResetDuration(retrigger.reset.Sample(filterInput).Absolute(noteDuration));
@@ -73,7 +71,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::Wobble:
 	{
-		WobbleDSP* wb = new WobbleDSP();
+		WobbleDSP* wb = playback.GetDSPPool().Acquire<WobbleDSP>();
 		audioTrack->AddDSP(wb);
 		wb->SetLength(actualLength);
 		wb->q = wobble.q.Sample(filterInput);
@@ -84,7 +82,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::Phaser:
 	{
-		PhaserDSP* phs = new PhaserDSP();
+		PhaserDSP* phs = playback.GetDSPPool().Acquire<PhaserDSP>();
 		audioTrack->AddDSP(phs);
 		phs->SetLength(actualLength);
 		phs->dmin = phaser.min.Sample(filterInput);
@@ -95,7 +93,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::Flanger:
 	{
-		FlangerDSP* fl = new FlangerDSP();
+		FlangerDSP* fl = playback.GetDSPPool().Acquire<FlangerDSP>();
 		audioTrack->AddDSP(fl);
 		fl->SetLength(actualLength);
 		fl->SetDelayRange(flanger.offset.Sample(filterInput),
@@ -105,7 +103,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::SideChain:
 	{
-		SidechainDSP* sc = new SidechainDSP();
+		SidechainDSP* sc = playback.GetDSPPool().Acquire<SidechainDSP>();
 		audioTrack->AddDSP(sc);
 		sc->SetLength(actualLength);
 		sc->amount = 1.0f;
@@ -115,7 +113,7 @@ DSP* GameAudioEffect::CreateDSP(class AudioBase* audioTrack, AudioPlayback& play
 	}
 	case EffectType::PitchShift:
 	{
-		PitchShiftDSP* ps = new PitchShiftDSP();
+		PitchShiftDSP* ps = playback.GetDSPPool().Acquire<PitchShiftDSP>();
 		audioTrack->AddDSP(ps);
 		ps->amount = pitchshift.amount.Sample(filterInput);
 		ret = ps;
@@ -57,11 +57,11 @@ Texture SongSelectStyle::GetJacketThumnail(const String& path)
 	{
 		CachedJacketImage* newImage = new CachedJacketImage();
 		JacketLoadingJob* job = new JacketLoadingJob();
-		job->imagePath = path;
+		job->file = g_jobSheduler->QueueRead(path);
 		job->target = newImage;
 		newImage->loadingJob = Ref<JobBase>(job);
 		newImage->lastUsage = m_timer.SecondsAsFloat();
-		g_jobSheduler->Queue(newImage->loadingJob);
+		g_jobSheduler->QueueAfter(newImage->loadingJob, job->file.As<JobBase>());
 
 		m_jacketImages.Add(path, newImage);
 	}
@@ -73,6 +73,11 @@ Texture SongSelectStyle::GetJacketThumnail(const String& path)
 		{
 			ret = it->second->texture;
 		}
+		else if(!it->second->loadingJob->IsFinished())
+		{
+			// Visible right now, load it before jackets that were scrolled past
+			g_jobSheduler->Prioritize(it->second->loadingJob);
+		}
 	}
 
 	// cleanup
@@ -93,8 +98,11 @@ Texture SongSelectStyle::GetJacketThumnail(const String& path)
 }
 bool JacketLoadingJob::Run()
 {
-	// Create loading task
-	loadedImage = ImageRes::Create(imagePath);
+	if(!file->IsSuccessfull())
+		return false;
+	loadedImage = ImageRes::Create(file->data);
+	// The file data is not needed after decoding
+	file->data = Buffer();
 	if (loadedImage.IsValid()){
 		if (loadedImage->GetSize().x > 150 || loadedImage->GetSize().y > 150){
 			loadedImage->ReSize({150,150});
@@ -9,6 +9,7 @@ struct CachedJacketImage
 	Job loadingJob;
 };
 
+// Decodes a jacket image after it's file is read on the IO threads
 class JacketLoadingJob : public JobBase
 {
 public:
@@ -16,7 +17,7 @@ public:
 	virtual void Finalize();
 
 	Image loadedImage;
-	String imagePath;
+	Ref<FileReadJob> file;
 	CachedJacketImage* target;
 };
 
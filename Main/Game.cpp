@@ -4,6 +4,7 @@
 #include <array>
 #include <random>
 #include <Beatmap/BeatmapPlayback.hpp>
+#include <Beatmap/ChartCache.hpp>
 #include <Shared/Profiling.hpp>
 #include "Scoring.hpp"
 #include <Audio/Audio.hpp>
@@ -32,20 +33,10 @@
 // Try load map helper
 Ref<Beatmap> TryLoadMap(const String& path)
 {
-	// Load map file
-	Beatmap* newMap = new Beatmap();
-	File mapFile;
-	if(!mapFile.OpenRead(path))
-	{
-		delete newMap;
-		return Ref<Beatmap>();
-	}
-	FileReader reader(mapFile);
-	if(!newMap->Load(reader))
-	{
-		delete newMap;
+	// Load map file, charts are only parsed when they changed since they were cached
+	Beatmap* newMap = ChartCache::LoadMap(path);
+	if(!newMap)
 		return Ref<Beatmap>();
-	}
 	return Ref<Beatmap>(newMap);
 }
 
@@ -349,6 +340,10 @@ public:
 
 		return true;
 	}
+	virtual bool AsyncFinalizeStep(float timeBudget) override
+	{
+		return loader.FinalizeStep(timeBudget);
+	}
 	virtual bool AsyncFinalize() override
 	{
 		if(m_jacketImage)
@@ -1159,7 +1154,21 @@ public:
 		textPos.y += RenderText(bms.title, textPos).y;
 		textPos.y += RenderText(bms.artist, textPos).y;
 		textPos.y += RenderText(Utility::Sprintf("%.2f FPS", g_application->GetRenderFPS()), textPos).y;
-		textPos.y += RenderText(Utility::Sprintf("Audio Offset: %d ms", g_audio->audioLatency), textPos).y;
+		textPos.y += RenderText(Utility::Sprintf("Audio Latency: %d ms", (int32)g_audio->audioLatency), textPos).y;
+
+		// Audio callback timing over the last second or so
+		const AudioStats& audioStats = g_audio->GetStats();
+		AudioStats::Summary audioSummary = audioStats.Summarize(AudioStats::historySize);
+		textPos.y += RenderText(Utility::Sprintf("Audio Mix: %.2f ms avg, %.2f ms max (budget %.2f ms)",
+			audioSummary.averageDuration, audioSummary.maxDuration, audioSummary.budget), textPos).y;
+		Color audioErrorColor = (audioStats.GetNumOverruns() + audioStats.GetNumUnderruns() + audioStats.GetNumDroppedCallbacks() > 0) ? Color::Red : Color::White;
+		textPos.y += RenderText(Utility::Sprintf("Audio Overruns: %d Underruns: %d Dropped: %d Bypassed: %d",
+			(int32)audioStats.GetNumOverruns(), (int32)audioStats.GetNumUnderruns(),
+			(int32)audioStats.GetNumDroppedCallbacks(), (int32)audioStats.GetNumBypassedBlocks()), textPos, audioErrorColor).y;
+		AudioMeter audioMeter = g_audio->GetOutputMeter();
+		textPos.y += RenderText(Utility::Sprintf("Audio Output: peak %.2f rms %.2f limiter %.2f",
+			audioMeter.peak, audioMeter.rms, audioMeter.gain), textPos).y;
+		textPos.y += RenderText(Utility::Sprintf("Audio Effects: %.1f us", m_audioPlayback.GetEffectProcessTime()), textPos).y;
 
 		float currentBPM = (float)(60000.0 / tp.beatDuration);
 		textPos.y += RenderText(Utility::Sprintf("BPM: %.1f", currentBPM), textPos).y;
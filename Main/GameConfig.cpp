@@ -35,6 +35,11 @@ void GameConfig::InitDefaults()
 	Set(GameConfigKeys::InputOffset, 0);
 	Set(GameConfigKeys::FPSTarget, 0);
 	Set(GameConfigKeys::LaserAssistLevel, 1.5f);
+	Set(GameConfigKeys::AudioBufferSize, 1024);
+	Set(GameConfigKeys::AudioSampleRate, 44100);
+	Set(GameConfigKeys::AudioLatencyCompensation, false);
+	Set(GameConfigKeys::AudioCacheSize, 128);
+	Set(GameConfigKeys::AudioCacheToDisk, false);
 	Set(GameConfigKeys::UseMMod, false);
 	Set(GameConfigKeys::UseCMod, false);
 	Set(GameConfigKeys::ModSpeed, 300.0f);
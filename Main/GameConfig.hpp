@@ -30,6 +30,15 @@ DefineEnum(GameConfigKeys,
 	FPSTarget,
 	LaserAssistLevel,
 
+	// Audio device settings
+	AudioBufferSize,
+	AudioSampleRate,
+	// Off by default, the global offset of existing configs was tuned without it
+	AudioLatencyCompensation,
+	// Decoded audio cache, size in MB and whether to keep evicted audio on disk
+	AudioCacheSize,
+	AudioCacheToDisk,
+
 	// Input device setting per element
 	LaserInputDevice,
 	ButtonInputDevice,
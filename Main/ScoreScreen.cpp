@@ -380,6 +380,10 @@ public:
 
 		return loader.Load();
 	}
+	virtual bool AsyncFinalizeStep(float timeBudget) override
+	{
+		return loader.FinalizeStep(timeBudget);
+	}
 	virtual bool AsyncFinalize() override
 	{
 		if(!loader.Finalize())
@@ -23,7 +23,8 @@
 class PreviewPlayer
 {
 public:
-	void FadeTo(AudioStream stream)
+	// The new stream loops the range starting at loopStart, a duration of 0 plays it until the end
+	void FadeTo(AudioStream stream, int32 loopStart = 0, int32 loopDuration = 0)
 	{
 		// Already existing transition?
 		if(m_nextStream)
@@ -36,6 +37,8 @@ public:
 		}
 		m_nextStream = stream;
 		m_nextSet = true;
+		m_loopStart = loopStart;
+		m_loopDuration = loopDuration;
 		if(m_nextStream)
 		{
 			m_nextStream->SetVolume(0.0f);
@@ -45,6 +48,18 @@ public:
 	}
 	void Update(float deltaTime)
 	{
+		// Restart the newest stream at the start of the preview
+		AudioStream& stream = m_nextSet ? m_nextStream : m_currentStream;
+		if(stream)
+		{
+			bool pastEnd = m_loopDuration > 0 && stream->GetPosition() >= m_loopStart + m_loopDuration;
+			if(stream->HasEnded() || pastEnd)
+			{
+				stream->SetPosition(m_loopStart);
+				stream->Play();
+			}
+		}
+
 		if(m_nextSet)
 		{
 			m_fadeTimer += deltaTime;
@@ -92,6 +107,8 @@ private:
 	AudioStream m_nextStream;
 	AudioStream m_currentStream;
 	bool m_nextSet = false;
+	int32 m_loopStart = 0;
+	int32 m_loopDuration = 0;
 };
 const float PreviewPlayer::m_fadeDuration = 0.5f;
 
@@ -800,6 +817,8 @@ private:
 	MouseLockHandle m_lockMouse;
 	bool m_suspended = false;
 	bool m_previewLoaded = true;
+	// Length of the preview for charts that don't specify one, in milliseconds
+	static const int32 m_defaultPreviewDuration = 20000;
 	bool m_showScores = false;
 	uint64_t m_previewDelayTicks = 0;
 	Map<Input::Button, float> m_timeSinceButtonPressed;
@@ -908,6 +927,7 @@ public:
 
 		// Setup the map database
 		m_mapDatabase.AddSearchPath(g_gameConfig.GetString(GameConfigKeys::SongFolder));
+		m_mapDatabase.SetJobSheduler(g_jobSheduler);
 
 		m_mapDatabase.OnMapsAdded.Add(m_selectionWheel.GetData(), &SelectionWheel::OnMapsAdded);
 		m_mapDatabase.OnMapsUpdated.Add(m_selectionWheel.GetData(), &SelectionWheel::OnMapsUpdated);
@@ -944,11 +964,15 @@ public:
 				DifficultyIndex* previewDiff = m_currentPreviewAudio->difficulties[0];
 				String audioPath = m_currentPreviewAudio->path + Path::sep + previewDiff->settings.audioNoFX;
 
-				AudioStream previewAudio = g_audio->CreateStream(audioPath);
+				// Previews are served from the decoded audio cache, scrolling back to a song doesn't decode it again
+				int32 previewOffset = previewDiff->settings.previewOffset;
+				int32 previewDuration = previewDiff->settings.previewDuration;
+				if(previewDuration <= 0)
+					previewDuration = m_defaultPreviewDuration;
+				AudioStream previewAudio = g_audio->CreateCachedStream(audioPath, previewOffset, previewDuration);
 				if (previewAudio)
 				{
-					previewAudio->SetPosition(previewDiff->settings.previewOffset);
-					m_previewPlayer.FadeTo(previewAudio);
+					m_previewPlayer.FadeTo(previewAudio, previewOffset, previewDuration);
 				}
 				else
 				{
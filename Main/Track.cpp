@@ -121,6 +121,10 @@ bool Track::AsyncLoad()
 
 	return loader->Load();
 }
+bool Track::AsyncFinalizeStep(float timeBudget)
+{
+	return loader->FinalizeStep(timeBudget);
+}
 bool Track::AsyncFinalize()
 {
 	// Finalizer loading textures/material/etc.
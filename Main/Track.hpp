@@ -37,6 +37,7 @@ public:
 	~Track();
 	virtual bool AsyncLoad() override;
 	virtual bool AsyncFinalize() override;
+	virtual bool AsyncFinalizeStep(float timeBudget) override;
 	void Tick(class BeatmapPlayback& playback, float deltaTime);
 
 	// Draw black laser underlays for wide lasers or all lasers if lane is hidden
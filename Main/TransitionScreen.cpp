@@ -6,6 +6,9 @@
 #include <GUI/Spinner.hpp>
 #include "AsyncLoadable.hpp"
 
+// Time spent finalizing the loaded tickable every frame, so the loading screen keeps running while textures are uploaded
+static const float finalizeTimeBudget = 0.004f;
+
 class TransitionScreen_Impl : public TransitionScreen
 {
 	Ref<Canvas> m_loadingOverlay;
@@ -21,6 +24,8 @@ class TransitionScreen_Impl : public TransitionScreen
 	};
 	Transition m_transition = Transition::In;
 	float m_transitionTimer;
+	// Loaded, finalizing over multiple frames
+	bool m_finalizing = false;
 
 public:
 	TransitionScreen_Impl(IAsyncLoadableApplicationTickable* next)
@@ -41,7 +46,15 @@ public:
 		
 		if(m_transition == In)
 		{
-
+			if(m_finalizing)
+			{
+				IAsyncLoadable* loadable = dynamic_cast<IAsyncLoadable*>(m_tickableToLoad);
+				if(loadable->AsyncFinalizeStep(finalizeTimeBudget))
+				{
+					m_finalizing = false;
+					m_Finalize();
+				}
+			}
 		}
 		else if(m_transition == Out)
 		{
@@ -84,6 +97,8 @@ public:
 			return DoLoad();
 		});
 		m_loadingJob->OnFinished.Add(this, &TransitionScreen_Impl::OnFinished);
+		// Don't wait behind jacket loads
+		m_loadingJob->priority = JobPriority::High;
 		g_jobSheduler->Queue(m_loadingJob);
 
 		return true;
@@ -95,11 +110,11 @@ public:
 		IAsyncLoadable* loadable = dynamic_cast<IAsyncLoadable*>(m_tickableToLoad);
 		if(job->IsSuccessfull())
 		{
-			if(loadable && !loadable->AsyncFinalize())
+			if(loadable)
 			{
-				Logf("[Transition] Failed to finalize loading of tickable", Logger::Error);
-				delete m_tickableToLoad;
-				m_tickableToLoad = nullptr;
+				// Continued in Tick
+				m_finalizing = true;
+				return;
 			}
 		}
 		else
@@ -108,7 +123,21 @@ public:
 			delete m_tickableToLoad;
 			m_tickableToLoad = nullptr;
 		}
-
+		m_Complete();
+	}
+	void m_Finalize()
+	{
+		IAsyncLoadable* loadable = dynamic_cast<IAsyncLoadable*>(m_tickableToLoad);
+		if(!loadable->AsyncFinalize())
+		{
+			Logf("[Transition] Failed to finalize loading of tickable", Logger::Error);
+			delete m_tickableToLoad;
+			m_tickableToLoad = nullptr;
+		}
+		m_Complete();
+	}
+	void m_Complete()
+	{
 		if(m_tickableToLoad)
 		{
 			Logf("[Transition] Finished loading tickable", Logger::Info);
@@ -24,6 +24,8 @@ public:
 	size_t GetSize() const;
 	size_t Read(void* data, size_t len);
 	size_t Write(const void* data, size_t len);
+	// Hints that the whole file will be read soon, so the system can start reading it in the background
+	void Prefetch();
 
 	// Get the last write time of the file
 	uint64 GetLastWriteTime() const;
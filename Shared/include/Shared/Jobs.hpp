@@ -5,10 +5,14 @@
 #include "Shared/Unique.hpp"
 #include "Shared/Ref.hpp"
 #include "Shared/Delegate.hpp"
+#include "Shared/Vector.hpp"
+#include "Shared/File.hpp"
+#include <atomic>
+#include <functional>
 
 /*
 	Additional job flags,
-	this allows clustering IO operation onto the same thread as to not lock up the system
+	IO jobs run on separate IO threads, so waiting for files never holds up other jobs
 */
 enum class JobFlags : uint8
 {
@@ -18,6 +22,17 @@ enum class JobFlags : uint8
 JobFlags operator|(JobFlags a, JobFlags b);
 JobFlags operator&(JobFlags a, JobFlags b);
 
+/*
+	Order in which queued jobs are picked up by the job threads
+	jobs of the same priority run in the order they were queued, newer jobs first on the thread that queued them
+*/
+enum class JobPriority : uint8
+{
+	Low = 0,
+	Normal,
+	High,
+};
+
 /*
 	A single task that gets completed by the JobSheduler
 	abstract
@@ -28,21 +43,34 @@ class JobBase : public Unique
 public:
 	virtual ~JobBase() = default;
 
+	// True after the job was finalized and it's callback was called by JobSheduler::Update
 	bool IsFinished() const;
+	// True once the job ran, the job threads can use it's results from then on
+	//	IsFinished becomes true later, when the main thread finalized it
+	bool HasRun() const;
 	bool IsSuccessfull() const;
 	bool IsQueued() const;
 
 	// Either cancel this job or wait till it finished if it is already being processed
+	//	jobs that were queued to run after this one are cancelled as well
 	void Terminate();
+	// Blocks until this job ran, other jobs are run on the calling thread while waiting
+	//	returns right away if the job is not queued
+	void Wait();
 	
 	// Flags for jobs
 	// make sure to add the IO flag if this job performs file operations
 	JobFlags jobFlags = JobFlags::None;
+	// Should be set before the job is queued
+	JobPriority priority = JobPriority::Normal;
 
 	// Performs the task to be done, returns success
 	virtual bool Run() = 0;
 	// Called on the main thread before the delegate callback
 	virtual void Finalize();
+	// Called for IO jobs that are taken from the queue together, before the first of them runs
+	//	can be used to start reading ahead so the files of the whole batch are read at the same time
+	virtual void Prefetch();
 
 	// Called when finished
 	//	called from main thread when JobSheduler::Update is called
@@ -53,8 +81,26 @@ public:
 	static Ref<JobBase> CreateLambda(Lambda&& obj, Args...);
 
 private:
+	enum class State : uint8
+	{
+		Idle = 0,
+		// Queued after another job that is not done yet
+		Waiting,
+		Queued,
+		Running,
+		// Ran, waiting to be finalized on the main thread
+		Done,
+	};
+
+	std::atomic<State> m_state = { State::Idle };
 	bool m_ret = false;
 	bool m_finished = false;
+	// Not owned by the sheduler and not finalized, for jobs the sheduler uses internally
+	bool m_detached = false;
+	// Jobs that are waiting for this one, owned by the sheduler
+	Vector<JobBase*> m_continuations;
+	// Jobs this one is still waiting for
+	Vector<JobBase*> m_predecessors;
 	class JobSheduler_Impl* m_sheduler = nullptr;
 	friend class JobSheduler_Impl;
 };
@@ -87,12 +133,98 @@ private:
 };
 typedef Ref<JobBase> Job;
 
+/*
+	IO job that reads a whole file, see JobSheduler::QueueRead
+	the data can be used once the job ran, from jobs queued after it or from it's OnFinished callback
+*/
+class FileReadJob : public JobBase
+{
+public:
+	FileReadJob();
+	virtual bool Run() override;
+	virtual void Prefetch() override;
+
+	String path;
+	Buffer data;
+
+private:
+	// Opened by Prefetch
+	File m_file;
+	bool m_opened = false;
+};
+
 template<typename Lambda, typename... Args>
 Job JobBase::CreateLambda(Lambda&& obj, Args... args)
 {
 	return Ref<JobBase>(new LambdaJob<Lambda, Args...>(obj, args...));
 }
 
+/*
+	Job that produces a value, see JobSheduler::Async
+*/
+template<typename T>
+class ValueJob : public JobBase
+{
+public:
+	T value = T();
+};
+template<typename T, typename Lambda>
+class FutureJob : public ValueJob<T>
+{
+public:
+	FutureJob(Lambda&& lambda) : m_lambda(std::forward<Lambda>(lambda))
+	{
+	}
+	virtual bool Run() override
+	{
+		this->value = m_lambda();
+		return true;
+	}
+
+private:
+	typename std::decay<Lambda>::type m_lambda;
+};
+
+/*
+	Result of a job that runs on the job threads
+	Get waits for the job, so results can be used from other jobs or the main thread without a callback
+	copying a Future changes the reference count of the job, so copies should only be made on the thread that created it
+*/
+template<typename T>
+class Future
+{
+public:
+	Future() = default;
+	Future(Ref<ValueJob<T>> job) : m_job(job), m_data(job.GetData())
+	{
+	}
+
+	bool IsValid() const
+	{
+		return m_data != nullptr;
+	}
+	bool IsReady() const
+	{
+		return m_data->HasRun();
+	}
+	// Waits for the value
+	T& Get()
+	{
+		m_data->Wait();
+		return m_data->value;
+	}
+	// The job that produces the value, to queue other jobs after it
+	Job GetJob()
+	{
+		return m_job.template As<JobBase>();
+	}
+
+private:
+	Ref<ValueJob<T>> m_job;
+	// Used to access the job, the reference count is not safe to read while other threads copy the reference
+	ValueJob<T>* m_data = nullptr;
+};
+
 /*
 	The manager for performing asynchronous tasks
 	you should only have one of these
@@ -106,10 +238,61 @@ public:
 	// Runs callbacks on finished tasks on the main thread
 	// should thus be called from the main thread only
 	void Update();
+	// Same as Update, but stops once <timeBudget> seconds were spent, the rest is finalized in later calls
+	//	jobs are finalized highest priority first and at least one job is finalized every call
+	void Update(float timeBudget);
 
 	// Queue job
+	//	can be called from any thread, including from jobs that are running
 	bool Queue(Job job);
+	// Queue a job that starts after <predecessor> has run, on the thread that ran it
+	//	the job is queued right away if the predecessor already ran or is not queued
+	bool QueueAfter(Job job, Job predecessor);
+	// Queue a job that starts after all of <predecessors> have run
+	bool QueueAfter(Job job, const Vector<Job>& predecessors);
+	// Queues a job that is done after all <jobs> ran, it succeeds if all of them succeeded
+	Job WhenAll(const Vector<Job>& jobs);
+
+	// Runs a function on the job threads and returns it's result as a Future
+	template<typename Lambda>
+	auto Async(Lambda&& lambda, JobPriority priority = JobPriority::Normal) -> Future<decltype(lambda())>;
+
+	// Calls <func> for every index in [begin, end), spread over the job threads and the calling thread
+	//	every job handles <grain> indices, returns when all of them are done
+	template<typename Lambda>
+	void ParallelFor(uint32 begin, uint32 end, uint32 grain, Lambda&& func);
+	// Raises a job to high priority, along with the jobs it waits for
+	//	a job that already ran is moved to the front of the jobs waiting to be finalized, for results that are needed right now
+	void Prioritize(Job job);
+	// Queues a job that reads a file on the IO threads
+	//	jobs that process the data can be queued after it with QueueAfter
+	Ref<FileReadJob> QueueRead(const String& path, JobPriority priority = JobPriority::Normal);
+
+	// Number of threads that run jobs, not counting the IO threads
+	uint32 GetNumThreads() const;
 
 private:
+	// Calls <func> with ranges of up to <grain> indices
+	void m_ParallelFor(uint32 begin, uint32 end, uint32 grain, const std::function<void(uint32, uint32)>& func);
+
 	class JobSheduler_Impl* m_impl;
 };
+
+template<typename Lambda>
+auto JobSheduler::Async(Lambda&& lambda, JobPriority priority) -> Future<decltype(lambda())>
+{
+	typedef decltype(lambda()) T;
+	Ref<ValueJob<T>> job = Ref<ValueJob<T>>(new FutureJob<T, Lambda>(std::forward<Lambda>(lambda)));
+	job->priority = priority;
+	Queue(job.template As<JobBase>());
+	return Future<T>(job);
+}
+template<typename Lambda>
+void JobSheduler::ParallelFor(uint32 begin, uint32 end, uint32 grain, Lambda&& func)
+{
+	m_ParallelFor(begin, end, grain, [&](uint32 rangeBegin, uint32 rangeEnd)
+	{
+		for(uint32 i = rangeBegin; i < rangeEnd; i++)
+			func(i);
+	});
+}
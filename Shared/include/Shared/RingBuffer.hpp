@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include "Shared/Unique.hpp"
+
+/*
+	Fixed size single producer, single consumer ring buffer
+	One thread may write to the buffer while another thread reads from it without any locking,
+	the storage is allocated once in Init so neither side ever allocates memory
+*/
+template<typename T>
+class RingBuffer : Unique
+{
+public:
+	RingBuffer() = default;
+	RingBuffer(size_t capacity)
+	{
+		Init(capacity);
+	}
+	~RingBuffer()
+	{
+		delete[] m_data;
+	}
+
+	// Allocates storage for at least <capacity> items (rounded up to a power of 2)
+	// not thread safe, call this before either side starts using the buffer
+	void Init(size_t capacity)
+	{
+		size_t actualCapacity = 1;
+		while(actualCapacity < capacity)
+			actualCapacity <<= 1;
+
+		delete[] m_data;
+		m_data = new T[actualCapacity];
+		m_mask = actualCapacity - 1;
+		m_readPos.store(0);
+		m_writePos.store(0);
+	}
+	// Discards all items, only call this when neither side is using the buffer
+	void Clear()
+	{
+		m_readPos.store(m_writePos.load());
+	}
+
+	size_t GetCapacity() const
+	{
+		return m_data ? m_mask + 1 : 0;
+	}
+	// Number of items that can be read
+	size_t GetReadAvailable() const
+	{
+		return m_writePos.load(std::memory_order_acquire) - m_readPos.load(std::memory_order_acquire);
+	}
+	// Number of items that can be written
+	size_t GetWriteAvailable() const
+	{
+		return GetCapacity() - GetReadAvailable();
+	}
+
+	// Adds a single item, returns false if the buffer is full
+	bool Push(const T& item)
+	{
+		return Write(&item, 1) == 1;
+	}
+	// Removes a single item, returns false if the buffer is empty
+	bool Pop(T& item)
+	{
+		return Read(&item, 1) == 1;
+	}
+
+	// Writes up to <count> items, returns the number of items written
+	// producer side only
+	size_t Write(const T* src, size_t count)
+	{
+		size_t writePos = m_writePos.load(std::memory_order_relaxed);
+		size_t readPos = m_readPos.load(std::memory_order_acquire);
+		size_t available = GetCapacity() - (writePos - readPos);
+		if(count > available)
+			count = available;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			m_data[(writePos + i) & m_mask] = src[i];
+		}
+		m_writePos.store(writePos + count, std::memory_order_release);
+		return count;
+	}
+	// Reads up to <count> items, returns the number of items read
+	// consumer side only
+	size_t Read(T* dst, size_t count)
+	{
+		size_t readPos = m_readPos.load(std::memory_order_relaxed);
+		size_t writePos = m_writePos.load(std::memory_order_acquire);
+		size_t available = writePos - readPos;
+		if(count > available)
+			count = available;
+
+		for(size_t i = 0; i < count; i++)
+		{
+			dst[i] = m_data[(readPos + i) & m_mask];
+		}
+		m_readPos.store(readPos + count, std::memory_order_release);
+		return count;
+	}
+	// Discards up to <count> items without reading them, returns the number of items skipped
+	// consumer side only
+	size_t Skip(size_t count)
+	{
+		size_t readPos = m_readPos.load(std::memory_order_relaxed);
+		size_t writePos = m_writePos.load(std::memory_order_acquire);
+		size_t available = writePos - readPos;
+		if(count > available)
+			count = available;
+		m_readPos.store(readPos + count, std::memory_order_release);
+		return count;
+	}
+
+private:
+	T* m_data = nullptr;
+	size_t m_mask = 0;
+
+	// Read and write cursors are kept on seperate cache lines so the two threads don't fight over them
+	std::atomic<size_t> m_readPos = { 0 };
+	uint8_t m_padding[64];
+	std::atomic<size_t> m_writePos = { 0 };
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/*
+	Value written by a single thread and read by any number of threads without locking
+	Readers retry when they overlap with a write, so they always see a complete value
+	T should be a small plain struct, it is copied on every Load/Store
+*/
+template<typename T>
+class SeqLock
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock values must be trivially copyable");
+	static const size_t numWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+	SeqLock()
+	{
+		Store(T());
+	}
+	SeqLock(const T& value)
+	{
+		Store(value);
+	}
+
+	// Writer side only
+	void Store(const T& value)
+	{
+		uint64_t words[numWords] = { 0 };
+		memcpy(words, &value, sizeof(T));
+
+		uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+		m_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for(size_t i = 0; i < numWords; i++)
+		{
+			m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+		m_sequence.store(sequence + 2, std::memory_order_release);
+	}
+	T Load() const
+	{
+		uint64_t words[numWords];
+		uint32_t before, after;
+		do
+		{
+			before = m_sequence.load(std::memory_order_acquire);
+			for(size_t i = 0; i < numWords; i++)
+			{
+				words[i] = m_words[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			after = m_sequence.load(std::memory_order_relaxed);
+		} while((before & 1) != 0 || before != after);
+
+		T value;
+		memcpy(&value, words, sizeof(T));
+		return value;
+	}
+
+private:
+	// Odd while a write is in progress
+	std::atomic<uint32_t> m_sequence = { 0 };
+	std::atomic<uint64_t> m_words[numWords];
+};
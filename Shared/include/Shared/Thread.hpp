@@ -11,6 +11,28 @@ public:
 	using std::thread::thread;
 	size_t SetAffinityMask(size_t affinityMask);
 	static size_t SetCurrentThreadAffinityMask(size_t affinityMask);
+	// Gives the calling thread the highest scheduling priority the platform allows for a process without special rights
+	//	returns false if the priority could not be changed
+	static bool SetCurrentThreadRealtime();
+};
+
+/*
+	Counting semaphore using the platform's own, Post never takes a lock so it can be used from the audio callback
+*/
+class Semaphore
+{
+public:
+	Semaphore();
+	~Semaphore();
+	Semaphore(const Semaphore&) = delete;
+	Semaphore& operator=(const Semaphore&) = delete;
+
+	void Post(uint32 count = 1);
+	// Blocks until the semaphore was posted
+	void Wait();
+
+private:
+	void* m_handle;
 };
 
 /* 
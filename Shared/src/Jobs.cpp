@@ -2,10 +2,13 @@
 #include "Jobs.hpp"
 #include "List.hpp"
 #include "Vector.hpp"
+#include "Map.hpp"
 #include "Log.hpp"
 #include "Thread.hpp"
-#include <thread>
 #include "Timer.hpp"
+#include <thread>
+#include <cfloat>
+#include <condition_variable>
 
 JobFlags operator|(JobFlags a, JobFlags b)
 {
@@ -16,42 +19,66 @@ JobFlags operator&(JobFlags a, JobFlags b)
 	return (JobFlags)((uint8)a & (uint8)b);
 }
 
+static const uint32 numJobPriorities = 3;
+// Threads that only run IO jobs, file operations mostly wait so these don't take a core each
+static const uint32 numIOThreads = 2;
+// Maximum number of IO jobs an IO thread takes at once
+static const uint32 ioBatchSize = 8;
+
 struct JobThread
 {
 	// Thread index
 	uint32 index = 0;
-	bool terminate = false;
+	class JobSheduler_Impl* sheduler = nullptr;
 	Thread thread;
 
-	// Job currently being processed
-	Job activeJob;
+	// Jobs queued on this thread, one queue per priority
+	//	this thread takes the newest job from it's own queues, other threads steal the oldest
+	List<JobBase*> queues[numJobPriorities];
+	Mutex lock;
+};
 
-	Timer idleDuration;
+// The job thread the calling thread is, if any
+static thread_local JobThread* currentJobThread = nullptr;
 
-	// Terminate this thread
-	void Terminate()
-	{
-		if(terminate)
-			return; // Already terminated
-		terminate = true;
-		if(thread.joinable())
-			thread.join();
-	}
-	bool IsActive() const { return activeJob.IsValid(); }
-};
+/*
+	Work stealing sheduler
+	every thread has it's own queues, jobs queued from a job thread go to that thread and jobs from other threads are spread over all threads
+	idle threads steal from the others and sleep until new jobs are queued
 
+	IO jobs have a shared queue that is only used by the IO threads
+	an IO thread takes a batch of jobs and lets them prefetch before running them, so the system can read all their files at once
+*/
 class JobSheduler_Impl
 {
 public:
-	// Contains tasks to be done
-	List<Job> m_jobQueue;
-	// Contains tasks that are done
-	List<Job> m_finishedJobs;
-	
+	typedef JobBase::State State;
+
+	// Owning references to all jobs known to the sheduler, the job threads only use the raw pointers
+	//	the reference count of a Ref is not atomic, these are only copied or released under m_lock
+	Map<JobBase*, Job> m_jobs;
+	// Jobs that ran and wait to be finalized by priority, in the order they finished
+	List<JobBase*> m_finalizeQueue[numJobPriorities];
 	Mutex m_lock;
+	// Signaled when a job is done, for Terminate
+	std::condition_variable_any m_jobDone;
+
+	// IO jobs by priority, oldest first
+	List<JobBase*> m_ioQueue[numJobPriorities];
+	Mutex m_ioLock;
+	Vector<Thread> m_ioThreads;
+
 	Vector<JobThread*> m_threadPool;
+	uint32 m_nextThread = 0;
 
-	friend class JobBase;
+	// Number of jobs in the thread queues and the IO queue
+	std::atomic<uint32> m_numQueued = { 0 };
+	std::atomic<uint32> m_numQueuedIO = { 0 };
+	// Idle threads wait on these until a job is queued
+	std::condition_variable m_wakeup;
+	std::condition_variable m_ioWakeup;
+	std::mutex m_sleepLock;
+	std::atomic<bool> m_terminate = { false };
 
 	JobSheduler_Impl()
 	{
@@ -63,22 +90,40 @@ public:
 	}
 	void ClearThreads()
 	{
+		m_sleepLock.lock();
+		m_terminate = true;
+		m_sleepLock.unlock();
+		m_wakeup.notify_all();
+		m_ioWakeup.notify_all();
+
 		for(JobThread* t : m_threadPool)
 		{
-			t->Terminate();
+			if(t->thread.joinable())
+				t->thread.join();
 			delete t;
 		}
-		m_lock.lock();
-		// Unregister jobs
-		for(auto job : m_jobQueue)
+		m_threadPool.clear();
+		for(Thread& t : m_ioThreads)
 		{
-			job->m_sheduler = nullptr;
+			if(t.joinable())
+				t.join();
 		}
-		for(auto job : m_finishedJobs)
+		m_ioThreads.clear();
+
+		// Unregister jobs
+		m_lock.lock();
+		for(auto& job : m_jobs)
 		{
-			job->m_sheduler = nullptr;
+			job.first->m_sheduler = nullptr;
+			job.first->m_predecessors.clear();
+			job.first->m_continuations.clear();
+			job.first->m_state = State::Idle;
 		}
-		m_threadPool.clear();
+		m_jobs.clear();
+		for(List<JobBase*>& queue : m_finalizeQueue)
+			queue.clear();
+		for(List<JobBase*>& queue : m_ioQueue)
+			queue.clear();
 		m_lock.unlock();
 	}
 	void AllocateThreads()
@@ -90,97 +135,461 @@ public:
 		if(targetThreadCount <= 0)
 			targetThreadCount = 1;
 
+		// Create all threads before starting them, they steal from each other
 		for(int32 i = 0; i < targetThreadCount; i++)
+		{
+			JobThread* thread = m_threadPool.Add(new JobThread());
+			thread->index = i;
+			thread->sheduler = this;
+		}
+		for(JobThread* thread : m_threadPool)
 		{
 			// Create affinity mask for job threads
 			// always skip the first core since it runs the main thread
-			uint32 affinityMask = 1 << (i+1);
+			uint32 affinityMask = 1 << (thread->index + 1);
 
-			JobThread* thread = m_threadPool.Add(new JobThread());
-			thread->index = i;
 			thread->thread = Thread(&JobSheduler_Impl::m_JobThread, this, thread);
 			thread->thread.SetAffinityMask(affinityMask);
 		}
+
+		for(uint32 i = 0; i < numIOThreads; i++)
+			m_ioThreads.emplace_back(&JobSheduler_Impl::m_IOThread, this);
 	}
 
-	void Update()
+	void Update(float timeBudget)
 	{
-		m_lock.lock();
-		List<Job> finished = m_finishedJobs;
-		m_finishedJobs.clear();
-		m_lock.unlock();
-
-		for(Job& j : finished)
+		Timer timer;
+		while(true)
 		{
+			// Take the reference out of the registry, the job is no longer used by the job threads
+			m_lock.lock();
+			JobBase* next = nullptr;
+			for(int32 p = numJobPriorities - 1; p >= 0 && !next; p--)
+			{
+				if(!m_finalizeQueue[p].empty())
+					next = m_finalizeQueue[p].PopFront();
+			}
+			if(!next)
+			{
+				m_lock.unlock();
+				break;
+			}
+			Job j = *m_jobs.Find(next);
+			m_jobs.erase(next);
+			m_lock.unlock();
+
 			j->Finalize();
 			j->OnFinished.Call(j);
 			j->m_finished = true;
+			j->m_state = State::Idle;
 			j->m_sheduler = nullptr;
+
+			if(timer.SecondsAsFloat() >= timeBudget)
+				break;
 		}
 	}
 
-	bool QueueUnchecked(Job job)
+	bool Queue(Job job)
 	{
-		job->m_sheduler = this;
-
 		m_lock.lock();
-		m_jobQueue.AddBack(job);
+		m_Register(job);
+		m_Push(job.GetData());
+		m_lock.unlock();
+		return true;
+	}
+	bool QueueAfter(Job job, const Vector<Job>& predecessors)
+	{
+		m_lock.lock();
+		m_Register(job);
+		for(Job predecessor : predecessors)
+		{
+			JobBase* before = predecessor.GetData();
+			State state = before->m_state;
+			if(before->m_sheduler != this || job->m_predecessors.Contains(before))
+				continue;
+			// Only m_Finish changes the state to done and it holds the lock
+			if(state == State::Waiting || state == State::Queued || state == State::Running)
+			{
+				job->m_predecessors.Add(before);
+				before->m_continuations.Add(job.GetData());
+			}
+		}
+		if(job->m_predecessors.empty())
+			m_Push(job.GetData());
+		else
+			job->m_state = State::Waiting;
 		m_lock.unlock();
-
 		return true;
 	}
+	// Queues a job that is not registered, the caller owns it and waits for it to run
+	void QueueDetached(JobBase* job)
+	{
+		m_lock.lock();
+		job->m_detached = true;
+		job->m_sheduler = this;
+		m_Push(job);
+		m_lock.unlock();
+	}
 
-private:
-	// Single job thread
-	void m_JobThread(JobThread* myThread)
+	void Wait(JobBase* job)
 	{
-		while(!myThread->terminate)
+		JobThread* myThread = currentJobThread;
+		if(myThread && myThread->sheduler != this)
+			myThread = nullptr;
+
+		// Other threads (the game thread mostly) only run the job they wait for, any other job could take much longer
+		//	this still lets them take part in a ParallelFor, the range jobs they wait for are run here if no thread took them yet
+		if(!myThread)
 		{
-			if(!m_jobQueue.empty())
+			std::unique_lock<Mutex> lock(m_lock);
+			bool io = (job->jobFlags & JobFlags::IO) == JobFlags::IO;
+			if(!io && job->m_state == State::Queued && m_Unqueue(job))
 			{
-				m_lock.lock();
-				if(!m_jobQueue.empty())
-				{
-					myThread->idleDuration.Restart();
+				job->m_state = State::Running;
+				lock.unlock();
+				m_Run(job);
+				return;
+			}
+			m_jobDone.wait(lock, [&]()
+			{
+				State state = job->m_state;
+				return state == State::Done || state == State::Idle;
+			});
+			return;
+		}
 
-					// Process a job
-					Job peekJob = m_jobQueue.front();
-					if((peekJob->jobFlags & JobFlags::IO) != JobFlags::IO || (myThread->index != 0)) // Only perform IO on first thread
-					{
-						myThread->activeJob = m_jobQueue.PopFront();
-						m_lock.unlock();
+		while(true)
+		{
+			State state = job->m_state;
+			if(state == State::Done || state == State::Idle)
+				break;
+
+			// Help out instead of blocking the thread, this also makes waiting from a job safe
+			JobBase* other = m_Take(myThread);
+			if(other)
+			{
+				m_Run(other);
+				continue;
+			}
 
-						// Run
-						myThread->activeJob->m_ret = myThread->activeJob->Run();
-						myThread->activeJob->m_finished = true;
+			std::unique_lock<Mutex> lock(m_lock);
+			m_jobDone.wait(lock, [&]()
+			{
+				State state = job->m_state;
+				return state == State::Done || state == State::Idle || m_numQueued > 0;
+			});
+		}
+	}
 
-						// Add to finished queue
-						m_lock.lock();
-						m_finishedJobs.AddBack(myThread->activeJob);
-						m_lock.unlock();
+	void Terminate(JobBase* job)
+	{
+		std::unique_lock<Mutex> lock(m_lock);
+		Job* ref = m_jobs.Find(job);
+		if(!ref)
+			return;
+		// Keep the job alive until it's removed
+		Job keep = *ref;
 
-						// Clear the active job
-						myThread->activeJob.Release();
+		bool removed = job->m_state == State::Waiting || m_Unqueue(job);
+		if(removed)
+		{
+			// Did not run, neither will anything that waits for it
+			m_Cancel(job);
+			lock.unlock();
+			m_jobDone.notify_all();
+			return;
+		}
+		else
+		{
+			// Wait for running job
+			m_jobDone.wait(lock, [&]() { return job->m_state == State::Done; });
+			m_finalizeQueue[(uint32)job->priority].remove(job);
+			m_Unregister(job);
+		}
+		lock.unlock();
+	}
+
+	void Prioritize(JobBase* job)
+	{
+		m_lock.lock();
+		if(job->m_sheduler == this)
+			m_Prioritize(job);
+		m_lock.unlock();
+	}
+
+private:
+	// Should be called with m_lock held
+	void m_Register(Job& job)
+	{
+		job->m_sheduler = this;
+		m_jobs.Add(job.GetData(), job);
+	}
+	void m_Unregister(JobBase* job)
+	{
+		job->m_sheduler = nullptr;
+		job->m_state = State::Idle;
+		m_jobs.erase(job);
+	}
+	// Unregisters a job that did not run and all jobs waiting for it
+	void m_Cancel(JobBase* job)
+	{
+		for(JobBase* before : job->m_predecessors)
+			before->m_continuations.Remove(job);
+		job->m_predecessors.clear();
+
+		// The job stays alive until it's unregistered
+		Vector<JobBase*> continuations = std::move(job->m_continuations);
+		job->m_continuations.clear();
+		for(JobBase* next : continuations)
+			m_Cancel(next);
+		m_Unregister(job);
+	}
+	// Should be called with m_lock held, the priority of a job is only read under it
+	void m_Prioritize(JobBase* job)
+	{
+		const JobPriority high = JobPriority::High;
+		State state = job->m_state;
+		if(state == State::Done)
+		{
+			// Finalized next, unless it is being finalized already
+			List<JobBase*>& queue = m_finalizeQueue[(uint32)job->priority];
+			auto it = std::find(queue.begin(), queue.end(), job);
+			if(it != queue.end())
+			{
+				queue.erase(it);
+				m_finalizeQueue[(uint32)high].AddFront(job);
+				job->priority = high;
+			}
+			return;
+		}
+		if(job->priority == high)
+			return;
+
+		if(state == State::Queued)
+		{
+			// Move it to the high priority queue
+			if(m_Unqueue(job))
+			{
+				job->priority = high;
+				m_Push(job);
+			}
+			return;
+		}
+		job->priority = high;
+		for(JobBase* before : job->m_predecessors)
+			m_Prioritize(before);
+	}
+	// Adds a job to a thread queue, should be called with m_lock held
+	void m_Push(JobBase* job)
+	{
+		job->m_state = State::Queued;
+		if((job->jobFlags & JobFlags::IO) == JobFlags::IO)
+		{
+			// Counted before it is in the queue, so a thread that sees a job count of zero never misses a job
+			m_numQueuedIO++;
+			m_ioLock.lock();
+			m_ioQueue[(uint32)job->priority].AddBack(job);
+			m_ioLock.unlock();
+			m_Wake(m_ioWakeup);
+		}
+		else
+		{
+			// Keep jobs queued by jobs on the same thread, since they likely use the same data
+			JobThread* target = currentJobThread;
+			if(!target || target->sheduler != this)
+				target = m_threadPool[m_nextThread++ % m_threadPool.size()];
+
+			m_numQueued++;
+			target->lock.lock();
+			target->queues[(uint32)job->priority].AddBack(job);
+			target->lock.unlock();
+			m_Wake(m_wakeup);
+		}
+	}
+	void m_Wake(std::condition_variable& wakeup)
+	{
+		// Taking the lock makes sure a thread that is about to sleep either sees the new job or gets the notification
+		m_sleepLock.lock();
+		m_sleepLock.unlock();
+		wakeup.notify_one();
+	}
+	// Removes a job that is not taken by a thread yet, should be called with m_lock held
+	bool m_Unqueue(JobBase* job)
+	{
+		if((job->jobFlags & JobFlags::IO) == JobFlags::IO)
+		{
+			std::lock_guard<Mutex> ioLock(m_ioLock);
+			for(List<JobBase*>& queue : m_ioQueue)
+			{
+				for(auto it = queue.begin(); it != queue.end(); it++)
+				{
+					if(*it == job)
+					{
+						queue.erase(it);
+						m_numQueuedIO--;
+						return true;
 					}
-					else
+				}
+			}
+			return false;
+		}
+
+		for(JobThread* t : m_threadPool)
+		{
+			std::lock_guard<Mutex> threadLock(t->lock);
+			for(List<JobBase*>& queue : t->queues)
+			{
+				for(auto it = queue.begin(); it != queue.end(); it++)
+				{
+					if(*it == job)
 					{
-						m_lock.unlock();
+						queue.erase(it);
+						m_numQueued--;
+						return true;
 					}
 				}
-				else
+			}
+		}
+		return false;
+	}
+	// Takes the next job for a thread, highest priority first
+	//	the job is marked as running while the queue is locked, so Terminate either removes it from the queue or waits for it
+	JobBase* m_Take(JobThread* myThread)
+	{
+		JobBase* job = nullptr;
+		if(m_numQueued == 0)
+			return nullptr;
+		uint32 numThreads = (uint32)m_threadPool.size();
+		for(int32 p = numJobPriorities - 1; p >= 0; p--)
+		{
+			// Own queue first, newest job
+			myThread->lock.lock();
+			List<JobBase*>& own = myThread->queues[p];
+			if(!own.empty())
+			{
+				job = own.PopBack();
+				job->m_state = State::Running;
+				m_numQueued--;
+			}
+			myThread->lock.unlock();
+			if(job)
+				return job;
+
+			// Steal the oldest job from another thread
+			for(uint32 i = 1; i < numThreads; i++)
+			{
+				JobThread* victim = m_threadPool[(myThread->index + i) % numThreads];
+				victim->lock.lock();
+				List<JobBase*>& queue = victim->queues[p];
+				if(!queue.empty())
 				{
-					// Just do nothing
-					m_lock.unlock();
+					job = queue.PopFront();
+					job->m_state = State::Running;
+					m_numQueued--;
 				}
+				victim->lock.unlock();
+				if(job)
+					return job;
 			}
+		}
+		return nullptr;
+	}
+	void m_Run(JobBase* job)
+	{
+		job->m_ret = job->Run();
+		m_Finish(job);
+	}
+	void m_Finish(JobBase* job)
+	{
+		m_lock.lock();
+		if(job->m_detached)
+		{
+			// Can be deleted by it's owner from here on
+			assert(job->m_continuations.empty());
+			job->m_sheduler = nullptr;
+			job->m_state = State::Done;
+		}
+		else
+		{
+			// Done before the jobs that wait for it start, so they see it as done
+			job->m_state = State::Done;
+			m_finalizeQueue[(uint32)job->priority].AddBack(job);
+
+			// Queue jobs that waited for this one on this thread
+			for(JobBase* next : job->m_continuations)
+			{
+				next->m_predecessors.Remove(job, false);
+				if(next->m_predecessors.empty())
+					m_Push(next);
+			}
+			job->m_continuations.clear();
+		}
+		m_lock.unlock();
+		m_jobDone.notify_all();
+	}
+	// Takes the next batch of IO jobs, highest priority first
+	//	leaves jobs for the other IO threads when there are only a few
+	void m_TakeIO(Vector<JobBase*>& batch)
+	{
+		uint32 count = (m_numQueuedIO + numIOThreads - 1) / numIOThreads;
+		if(count > ioBatchSize)
+			count = ioBatchSize;
 
-			// Various idle levels
-			if(myThread->idleDuration.Minutes() > 1)
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-			if(myThread->idleDuration.Seconds() > 1)
-				std::this_thread::sleep_for(std::chrono::milliseconds(500));
-			else
-				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		std::lock_guard<Mutex> ioLock(m_ioLock);
+		for(int32 p = numJobPriorities - 1; p >= 0 && batch.size() < count; p--)
+		{
+			List<JobBase*>& queue = m_ioQueue[p];
+			while(!queue.empty() && batch.size() < count)
+			{
+				JobBase* job = queue.PopFront();
+				job->m_state = State::Running;
+				m_numQueuedIO--;
+				batch.Add(job);
+			}
+		}
+	}
+
+	// Single job thread
+	void m_JobThread(JobThread* myThread)
+	{
+		currentJobThread = myThread;
+		while(!m_terminate)
+		{
+			JobBase* job = m_Take(myThread);
+			if(!job)
+			{
+				// Sleep until something is queued
+				std::unique_lock<std::mutex> lock(m_sleepLock);
+				m_wakeup.wait(lock, [&]() { return m_terminate || m_numQueued > 0; });
+				continue;
+			}
+
+			m_Run(job);
+		}
+		currentJobThread = nullptr;
+	}
+	// Single IO thread
+	void m_IOThread()
+	{
+		Vector<JobBase*> batch;
+		while(!m_terminate)
+		{
+			m_TakeIO(batch);
+			if(batch.empty())
+			{
+				std::unique_lock<std::mutex> lock(m_sleepLock);
+				m_ioWakeup.wait(lock, [&]() { return m_terminate || m_numQueuedIO > 0; });
+				continue;
+			}
+
+			if(batch.size() > 1)
+			{
+				for(JobBase* job : batch)
+					job->Prefetch();
+			}
+			for(JobBase* job : batch)
+				m_Run(job);
+			batch.clear();
 		}
 	}
 };
@@ -194,9 +603,17 @@ JobSheduler::~JobSheduler()
 }
 void JobSheduler::Update()
 {
-	m_impl->Update();
+	m_impl->Update(FLT_MAX);
 }
-bool JobSheduler::Queue(Job job)
+void JobSheduler::Update(float timeBudget)
+{
+	m_impl->Update(timeBudget);
+}
+void JobSheduler::Prioritize(Job job)
+{
+	m_impl->Prioritize(job.GetData());
+}
+static bool CanQueue(const Job& job)
 {
 	// Can't queue jobs twice
 	if(job->IsQueued())
@@ -210,14 +627,139 @@ bool JobSheduler::Queue(Job job)
 		Logf("Tried to register a finished job", Logger::Warning);
 		return false;
 	}
+	return true;
+}
+bool JobSheduler::Queue(Job job)
+{
+	if(!CanQueue(job))
+		return false;
+	return m_impl->Queue(job);
+}
+bool JobSheduler::QueueAfter(Job job, Job predecessor)
+{
+	return QueueAfter(job, Vector<Job>{ predecessor });
+}
+bool JobSheduler::QueueAfter(Job job, const Vector<Job>& predecessors)
+{
+	if(!CanQueue(job))
+		return false;
+	return m_impl->QueueAfter(job, predecessors);
+}
+
+/*
+	Done after a set of jobs ran, see JobSheduler::WhenAll
+*/
+class JoinJob : public JobBase
+{
+public:
+	virtual bool Run() override
+	{
+		// The references are only used on the main thread
+		for(JobBase* job : waitFor)
+		{
+			if(!job->IsSuccessfull())
+				return false;
+		}
+		return true;
+	}
 
-	return m_impl->QueueUnchecked(job);
+	Vector<Job> jobs;
+	Vector<JobBase*> waitFor;
+};
+Job JobSheduler::WhenAll(const Vector<Job>& jobs)
+{
+	JoinJob* join = new JoinJob();
+	join->jobs = jobs;
+	for(Job job : jobs)
+		join->waitFor.Add(job.GetData());
+	Job ret = Ref<JobBase>(join);
+	QueueAfter(ret, jobs);
+	return ret;
+}
+
+/*
+	Takes ranges from a shared counter until all are taken, see JobSheduler::ParallelFor
+*/
+class ParallelForJob : public JobBase
+{
+public:
+	virtual bool Run() override
+	{
+		while(true)
+		{
+			uint32 rangeBegin = next->fetch_add(grain);
+			if(rangeBegin >= end)
+				break;
+			(*func)(rangeBegin, rangeBegin + grain < end ? rangeBegin + grain : end);
+		}
+		return true;
+	}
+
+	std::atomic<uint32>* next;
+	uint32 end;
+	uint32 grain;
+	const std::function<void(uint32, uint32)>* func;
+};
+void JobSheduler::m_ParallelFor(uint32 begin, uint32 end, uint32 grain, const std::function<void(uint32, uint32)>& func)
+{
+	if(begin >= end)
+		return;
+	if(grain == 0)
+		grain = 1;
+
+	// One job for every thread that can help, the calling thread takes ranges as well
+	uint32 numRanges = (end - begin + grain - 1) / grain;
+	uint32 numJobs = GetNumThreads();
+	if(numJobs > numRanges - 1)
+		numJobs = numRanges - 1;
+
+	std::atomic<uint32> next = { begin };
+	Vector<ParallelForJob*> jobs;
+	for(uint32 i = 0; i < numJobs; i++)
+	{
+		ParallelForJob* job = jobs.Add(new ParallelForJob());
+		job->next = &next;
+		job->end = end;
+		job->grain = grain;
+		job->func = &func;
+		m_impl->QueueDetached(job);
+	}
+
+	ParallelForJob self;
+	self.next = &next;
+	self.end = end;
+	self.grain = grain;
+	self.func = &func;
+	self.Run();
+
+	// Jobs that did not start yet are run here, they return right away
+	for(ParallelForJob* job : jobs)
+	{
+		m_impl->Wait(job);
+		delete job;
+	}
+}
+Ref<FileReadJob> JobSheduler::QueueRead(const String& path, JobPriority priority)
+{
+	Ref<FileReadJob> job = Ref<FileReadJob>(new FileReadJob());
+	job->path = path;
+	job->priority = priority;
+	Queue(job.As<JobBase>());
+	return job;
+}
+uint32 JobSheduler::GetNumThreads() const
+{
+	return (uint32)m_impl->m_threadPool.size();
 }
 
 bool JobBase::IsFinished() const
 {
 	return m_finished;
 }
+bool JobBase::HasRun() const
+{
+	return m_state == State::Done || m_finished;
+}
 bool JobBase::IsSuccessfull() const
 {
 	return m_ret;
@@ -230,49 +772,51 @@ void JobBase::Terminate()
 {
 	if(!m_sheduler)
 		return; // Nothing to do
-	JobSheduler_Impl* sheduler = m_sheduler;
+	m_sheduler->Terminate(this);
+}
+void JobBase::Wait()
+{
+	// The sheduler is only cleared after the job ran
+	State state = m_state;
+	if(state == State::Done || state == State::Idle)
+		return;
+	m_sheduler->Wait(this);
+}
+void JobBase::Finalize()
+{
+}
+void JobBase::Prefetch()
+{
+}
 
-	// Try to erase from queue first
-	m_sheduler->m_lock.lock();
-	for(auto it = sheduler->m_jobQueue.begin(); it != sheduler->m_jobQueue.end(); it++)
-	{
-		if(*it == this)
-		{
-			sheduler->m_jobQueue.erase(it);
-			m_sheduler = nullptr;
-			m_sheduler->m_lock.unlock();
-			return; // Ok
-		}
-	}
-	m_sheduler->m_lock.unlock();
+FileReadJob::FileReadJob()
+{
+	jobFlags = JobFlags::IO;
+}
+void FileReadJob::Prefetch()
+{
+	m_opened = m_file.OpenRead(path);
+	if(m_opened)
+		m_file.Prefetch();
+}
+bool FileReadJob::Run()
+{
+	if(!m_opened && !m_file.OpenRead(path))
+		return false;
 
-	// Wait for running job
-	for(JobThread* t : m_sheduler->m_threadPool)
+	// Reads can return less than requested
+	size_t size = m_file.GetSize();
+	data.resize(size);
+	size_t position = 0;
+	while(position < size)
 	{
-		if(t->activeJob == this)
-		{
-			// Wait for job to complete
-			while(t->activeJob == this)
-			{
-				std::this_thread::yield();
-			}
+		size_t read = m_file.Read(data.data() + position, size - position);
+		if(read == 0 || read == (size_t)-1)
 			break;
-		}
-	}
-
-	// Remove from finished jobs list
-	m_sheduler->m_lock.lock();
-	for(auto it = m_sheduler->m_finishedJobs.rbegin(); it != m_sheduler->m_finishedJobs.rend(); it++)
-	{
-		if(*it == this)
-		{
-			m_sheduler->m_finishedJobs.erase(--(it.base()));
-			m_sheduler->m_lock.unlock();
-			return;
-		}
+		position += read;
 	}
-	m_sheduler->m_lock.unlock();
-}
-void JobBase::Finalize()
-{
+	m_file.Close();
+	m_opened = false;
+	data.resize(position);
+	return position == size;
 }
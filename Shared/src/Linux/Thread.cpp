@@ -1,6 +1,7 @@
 #pragma once
 #include "stdafx.h"
 #include "Thread.hpp"
+#include <semaphore.h>
 
 size_t Thread::SetAffinityMask(size_t affinityMask)
 {
@@ -31,3 +32,36 @@ size_t Thread::SetCurrentThreadAffinityMask(size_t affinityMask)
 	pthread_setaffinity_np(h, sizeof(cpu_set_t), &cpuset);
 	return 0;
 }
+
+bool Thread::SetCurrentThreadRealtime()
+{
+	// Usually needs elevated rights, the thread keeps it's normal priority if this fails
+	sched_param param = { 0 };
+	param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+	return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+}
+
+Semaphore::Semaphore()
+{
+	sem_t* sem = new sem_t;
+	sem_init(sem, 0, 0);
+	m_handle = sem;
+}
+Semaphore::~Semaphore()
+{
+	sem_t* sem = (sem_t*)m_handle;
+	sem_destroy(sem);
+	delete sem;
+}
+void Semaphore::Post(uint32 count)
+{
+	for(uint32 i = 0; i < count; i++)
+		sem_post((sem_t*)m_handle);
+}
+void Semaphore::Wait()
+{
+	// Retry when interrupted by a signal
+	while(sem_wait((sem_t*)m_handle) != 0 && errno == EINTR)
+	{
+	}
+}
@@ -1,4 +1,5 @@
 #include "Thread.hpp"
+#include <dispatch/dispatch.h>
 
 size_t Thread::SetAffinityMask(size_t affinityMask)
 {
@@ -9,3 +10,28 @@ size_t Thread::SetCurrentThreadAffinityMask(size_t affinityMask)
 {
 	return 0;
 }
+
+
+bool Thread::SetCurrentThreadRealtime()
+{
+	return false;
+}
+
+// Unnamed posix semaphores are not supported
+Semaphore::Semaphore()
+{
+	m_handle = dispatch_semaphore_create(0);
+}
+Semaphore::~Semaphore()
+{
+	dispatch_release((dispatch_semaphore_t)m_handle);
+}
+void Semaphore::Post(uint32 count)
+{
+	for(uint32 i = 0; i < count; i++)
+		dispatch_semaphore_signal((dispatch_semaphore_t)m_handle);
+}
+void Semaphore::Wait()
+{
+	dispatch_semaphore_wait((dispatch_semaphore_t)m_handle, DISPATCH_TIME_FOREVER);
+}
@@ -115,6 +115,15 @@ size_t File::Write(const void* data, size_t len)
 	assert(m_impl);
 	return write(m_impl->handle, data, (uint32)len);
 }
+void File::Prefetch()
+{
+	assert(m_impl);
+#ifdef __APPLE__
+	fcntl(m_impl->handle, F_RDAHEAD, 1);
+#else
+	posix_fadvise(m_impl->handle, 0, 0, POSIX_FADV_WILLNEED);
+#endif
+}
 
 uint64 File::GetLastWriteTime() const
 {
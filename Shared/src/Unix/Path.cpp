@@ -38,16 +38,9 @@ bool Path::DeleteDir(const String& path)
 }
 bool Path::Rename(const String& srcFile, const String& dstFile, bool overwrite)
 {
-	if(FileExists(*dstFile))
-	{
-		if(!overwrite)
-			return false;
-		if(Delete(*dstFile))
-		{
-			Logf("Failed to rename file, overwrite was true but the destination could not be removed", Logger::Warning);
-			return false;
-		}
-	}
+	if(!overwrite && FileExists(*dstFile))
+		return false;
+	// Replaces the destination in one step, it is never missing in between
 	return rename(*srcFile, *dstFile) == 0;
 }
 bool Path::Copy(const String& srcFile, const String& dstFile, bool overwrite)
@@ -130,6 +130,11 @@ size_t File::Write(const void* data, size_t len)
 	WriteFile(m_impl->handle, data, (DWORD)len, (DWORD*)&actual, 0);
 	return actual;
 }
+void File::Prefetch()
+{
+	// Nothing to hint, the cache manager already reads ahead on sequential reads
+	assert(m_impl);
+}
 
 uint64 File::GetLastWriteTime() const
 {
@@ -33,17 +33,10 @@ bool Path::Rename(const String& srcFile, const String& dstFile, bool overwrite)
 {
 	WString wsrc = Utility::ConvertToWString(srcFile);
 	WString wdst = Utility::ConvertToWString(dstFile);
-	if(PathFileExistsW(*wdst) == TRUE)
-	{
-		if(!overwrite)
-			return false;
-		if(DeleteFileW(*wdst) == FALSE)
-		{
-			Logf("Failed to rename file, overwrite was true but the destination could not be removed", Logger::Warning);
-			return false;
-		}
-	}
-	return MoveFileW(*wsrc, *wdst) == TRUE;
+	if(!overwrite && PathFileExistsW(*wdst) == TRUE)
+		return false;
+	// Replaces the destination in one step, it is never missing in between
+	return MoveFileExW(*wsrc, *wdst, MOVEFILE_REPLACE_EXISTING) == TRUE;
 }
 bool Path::Copy(const String& srcFile, const String& dstFile, bool overwrite)
 {
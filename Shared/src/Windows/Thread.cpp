@@ -15,4 +15,27 @@ size_t Thread::SetCurrentThreadAffinityMask(size_t affinityMask)
 	HANDLE h = (HANDLE)GetCurrentThread();
 	size_t res = (uint32)SetThreadAffinityMask(h, affinityMask);
 	return res;
+}
+
+bool Thread::SetCurrentThreadRealtime()
+{
+	return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+}
+
+Semaphore::Semaphore()
+{
+	m_handle = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+}
+Semaphore::~Semaphore()
+{
+	CloseHandle((HANDLE)m_handle);
+}
+void Semaphore::Post(uint32 count)
+{
+	if(count > 0)
+		ReleaseSemaphore((HANDLE)m_handle, (LONG)count, nullptr);
+}
+void Semaphore::Wait()
+{
+	WaitForSingleObject((HANDLE)m_handle, INFINITE);
 }
\ No newline at end of file
@@ -1,10 +1,22 @@
 #include "stdafx.h"
 #include <Audio/Audio.hpp>
 #include <Audio/DSP.hpp>
+#include <Audio/AudioKernels.hpp>
+#include <Audio/AudioCache.hpp>
+#include <Audio/Resampler.hpp>
+#include <Audio/Sample.hpp>
+#include <Audio/VoicePool.hpp>
+#include <Audio/DSPPool.hpp>
+#include <Audio/AudioStats.hpp>
+#include <Audio/Audio_Impl.hpp>
+#include <Audio/SeekIndex.hpp>
+#include <Shared/Files.hpp>
+#include <Beatmap/AudioEffects.hpp>
 #include <float.h>
 #include "TestMusicPlayer.hpp"
 
 #include <thread>
+#include <functional>
 using namespace std;
 
 static String testSamplePath = Path::Normalize("audio/laser_slam1.wav");
@@ -15,6 +27,841 @@ static String testSamplePath = Path::Normalize("audio/laser_slam1.wav");
 static String testSongPath = Path::Normalize("songs/noise/noise.ogg");
 static uint32 testSongOffset = 0;
 
+// Compare vectorized kernels against plain loops, odd counts make sure the scalar tails are hit as well
+Test("Audio.Kernels")
+{
+	const uint32 numSamples = 37;
+	int16 pcm[numSamples * 2];
+	float left[numSamples], right[numSamples];
+	float interleaved[numSamples * 2], mixed[numSamples * 2];
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		pcm[i] = (int16)(i * 1733 - 32000);
+	}
+
+	AudioKernels::Int16ToFloat(interleaved, pcm, numSamples * 2);
+	AudioKernels::Deinterleave(left, right, interleaved, numSamples);
+	for(uint32 i = 0; i < numSamples; i++)
+	{
+		TestEnsure(fabsf(left[i] - (float)pcm[i * 2] / (float)0x7FFF) < 0.00001f);
+		TestEnsure(fabsf(right[i] - (float)pcm[i * 2 + 1] / (float)0x7FFF) < 0.00001f);
+	}
+
+	AudioKernels::Int16ToPlanar(left, right, pcm, numSamples);
+	AudioKernels::Interleave(mixed, left, right, numSamples);
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		TestEnsure(mixed[i] == interleaved[i]);
+	}
+
+	AudioKernels::MixAdd(mixed, interleaved, 0.5f, numSamples * 2);
+	AudioKernels::Scale(mixed, 2.0f, numSamples * 2);
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		TestEnsure(fabsf(mixed[i] - interleaved[i] * 3.0f) < 0.00001f);
+	}
+
+	AudioKernels::Int16MonoToStereo(mixed, pcm, numSamples);
+	for(uint32 i = 0; i < numSamples; i++)
+	{
+		TestEnsure(mixed[i * 2] == interleaved[i] && mixed[i * 2 + 1] == interleaved[i]);
+	}
+
+	int16 roundTrip[numSamples * 2];
+	AudioKernels::FloatToInt16(roundTrip, interleaved, numSamples * 2);
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		TestEnsure(roundTrip[i] == pcm[i]);
+	}
+
+	// Out of range values are clipped
+	float loud[8] = { 2.0f, -2.0f, 1.0f, -1.0f, 0.5f, 1.5f, -1.5f, 0.0f };
+	int16 clipped[8];
+	AudioKernels::FloatToInt16(clipped, loud, 8);
+	TestEnsure(clipped[0] == 0x7FFF && clipped[1] == -0x7FFF && clipped[2] == 0x7FFF && clipped[7] == 0);
+
+	float peak = 0.0f, sum = 0.0f;
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		peak = Math::Max(peak, fabsf(interleaved[i]));
+		sum += interleaved[i] * interleaved[i];
+	}
+	TestEnsure(AudioKernels::PeakAbs(interleaved, numSamples * 2) == peak);
+	TestEnsure(fabsf(AudioKernels::SumSquares(interleaved, numSamples * 2) - sum) < sum * 0.0001f);
+
+	// Gain ramps end on the target gain, both channels of a frame are scaled the same
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		mixed[i] = 1.0f;
+	}
+	AudioKernels::ScaleRamp(mixed, 1.0f, 0.0f, numSamples);
+	TestEnsure(fabsf(mixed[0] - (1.0f - 1.0f / numSamples)) < 0.00001f && mixed[0] == mixed[1]);
+	TestEnsure(mixed[numSamples * 2 - 2] == 0.0f && mixed[numSamples * 2 - 1] == 0.0f);
+}
+
+// A sine converted between rates should still be the same sine
+Test("Audio.Resampler")
+{
+	const uint32 inputRate = 48000;
+	const uint32 outputRate = 44100;
+	const double frequency = 1000.0;
+	Vector<float> input, output;
+	input.resize(inputRate / 10 * 2);
+	output.resize(outputRate / 10 * 2);
+	for(uint32 i = 0; i < inputRate / 10; i++)
+	{
+		input[i * 2] = input[i * 2 + 1] = (float)sin(2.0 * Math::pi * frequency * i / inputRate);
+	}
+
+	Resampler resampler;
+	resampler.Init(inputRate, outputRate);
+	uint32 used = 0;
+	uint32 numOutput = resampler.Process(output.data(), outputRate / 10, input.data(), inputRate / 10, used);
+	TestEnsure(used == inputRate / 10);
+	TestEnsure(numOutput > outputRate / 10 - Resampler::numTaps);
+
+	// Skip the edges, which are filtered with silence
+	for(uint32 i = Resampler::numTaps; i < numOutput - Resampler::numTaps; i++)
+	{
+		float expected = (float)sin(2.0 * Math::pi * frequency * i / outputRate);
+		TestEnsure(fabsf(output[i * 2] - expected) < 0.001f);
+		TestEnsure(output[i * 2] == output[i * 2 + 1]);
+	}
+}
+
+// Low pass filter should keep low frequencies and remove high ones
+Test("Audio.Biquad")
+{
+	auto Measure = [](float frequency)
+	{
+		BQFDSP filter;
+		filter.SetLowPass(0.707f, 1000.0f, 44100.0f);
+		const uint32 numSamples = 4410;
+		Vector<float> data;
+		data.resize(numSamples * 2);
+		for(uint32 i = 0; i < numSamples; i++)
+		{
+			data[i * 2] = data[i * 2 + 1] = (float)sin(2.0 * Math::pi * frequency * i / 44100.0);
+		}
+		filter.Process(data.data(), numSamples);
+
+		// Peak after the filter settled
+		float peak = 0.0f;
+		for(uint32 i = numSamples / 2; i < numSamples; i++)
+		{
+			peak = Math::Max(peak, fabsf(data[i * 2]));
+			TestEnsure(data[i * 2] == data[i * 2 + 1]);
+		}
+		return peak;
+	};
+	TestEnsure(Measure(100.0f) > 0.95f);
+	TestEnsure(Measure(10000.0f) < 0.02f);
+
+	// Nearby parameters share coefficients
+	BQFDSP a, b;
+	a.SetPeaking(1.0f, 1000.0f, 10.0f, 44100.0f);
+	b.SetPeaking(1.0f, 1000.1f, 10.0f, 44100.0f);
+	TestEnsure(a.GetCoefficients().b0 == b.GetCoefficients().b0);
+}
+
+// Output stays below the ceiling without touching quiet audio, other than delaying it
+Test("Audio.Limiter")
+{
+	Audio audio;
+	TestEnsure(audio.InitOffline());
+	LimiterDSP limiter;
+	limiter.audio = audio.GetImpl();
+	limiter.ceiling = 0.5f;
+
+	const uint32 length = 4000;
+	Vector<float> signal, out;
+	signal.resize(length * 2);
+	for(uint32 i = 0; i < length; i++)
+	{
+		float amplitude = (i < length / 2) ? 0.25f : 2.0f;
+		signal[i * 2] = sinf((float)i * 0.05f) * amplitude;
+		signal[i * 2 + 1] = -signal[i * 2];
+	}
+
+	// Blocks that don't line up with the limiter's sub blocks
+	out = signal;
+	for(uint32 i = 0; i < length; i += 77)
+	{
+		limiter.Process(out.data() + i * 2, Math::Min(77u, length - i));
+	}
+	for(uint32 i = 0; i < LimiterDSP::lookahead * 2; i++)
+	{
+		TestEnsure(out[i] == 0.0f);
+	}
+	for(uint32 i = LimiterDSP::lookahead; i < length / 2; i++)
+	{
+		TestEnsure(out[i * 2] == signal[(i - LimiterDSP::lookahead) * 2]);
+	}
+	TestEnsure(AudioKernels::PeakAbs(out.data(), length * 2) <= limiter.ceiling + 0.0001f);
+
+	AudioMeter meter = limiter.GetMeter();
+	TestEnsure(meter.gain < 0.5f && meter.peak <= limiter.ceiling + 0.0001f && meter.rms > 0.0f);
+}
+
+// An octave up doubles the frequency of a sine, with a latency of half a window
+Test("Audio.PitchShift")
+{
+	Audio audio;
+	TestEnsure(audio.InitOffline());
+	PitchShiftDSP pitchShift;
+	pitchShift.audio = audio.GetImpl();
+	pitchShift.Prepare(44100);
+	pitchShift.amount = 12.0f;
+	TestEnsure(pitchShift.GetLatency() == PitchShiftDSP::windowLength * 44100 / 1000 / 2);
+
+	const uint32 length = 44100;
+	Vector<float> signal;
+	signal.resize(length * 2);
+	for(uint32 i = 0; i < length; i++)
+	{
+		signal[i * 2] = sinf(2.0f * Math::pi * 441.0f * (float)i / 44100.0f) * 0.5f;
+		signal[i * 2 + 1] = signal[i * 2];
+	}
+	for(uint32 i = 0; i < length; i += 384)
+	{
+		pitchShift.Process(signal.data() + i * 2, Math::Min(384u, length - i));
+	}
+
+	// Count zero crossings after the delay line has filled
+	uint32 crossings = 0;
+	for(uint32 i = length / 2 + 1; i < length; i++)
+	{
+		if((signal[i * 2] >= 0.0f) != (signal[i * 2 - 2] >= 0.0f))
+			crossings++;
+	}
+	float frequency = (float)crossings / 2.0f / 0.5f;
+	TestEnsure(frequency > 441.0f * 1.9f && frequency < 441.0f * 2.1f);
+}
+
+// Callback timing is counted and kept in order
+Test("Audio.Stats")
+{
+	AudioStats stats;
+	AudioCallbackTiming timing;
+	timing.budget = 8000000;
+	for(uint32 i = 0; i < 300; i++)
+	{
+		timing.start = 1000000 + (int64)i * timing.budget;
+		// One slow callback, one late callback
+		timing.duration = (i == 10) ? 9000000 : 100000;
+		if(i >= 20)
+			timing.start += timing.budget * 2;
+		stats.AddCallback(timing, true);
+	}
+	TestEnsure(stats.GetNumCallbacks() == 300);
+	TestEnsure(stats.GetNumOverruns() == 1);
+	TestEnsure(stats.GetNumUnderruns() == 1);
+	TestEnsure(stats.GetBucket(1) == 299 && stats.GetBucket(AudioStats::numBuckets - 1) == 0);
+
+	AudioCallbackTiming recent[4];
+	TestEnsure(stats.GetRecentCallbacks(recent, 4) == 4);
+	TestEnsure(recent[3].start - recent[2].start == timing.budget);
+	TestEnsure(recent[3].start == timing.start);
+
+	AudioStats::Summary summary = stats.Summarize(10);
+	TestEnsure(summary.numCallbacks == 10 && fabs(summary.maxDuration - 0.1) < 0.0001);
+}
+
+// Overlapping playback of the same sample, limited per sample
+Test("Audio.Voices")
+{
+	class TestSample : public SampleRes
+	{
+	public:
+		Vector<int16> pcm;
+		virtual const Vector<int16>& GetData() const override { return pcm; }
+		virtual uint32 GetBitsPerSample() const override { return 16; }
+		virtual uint32 GetNumChannels() const override { return 2; }
+		virtual void Play() override {}
+		virtual void Stop() override {}
+	};
+	TestSample sample;
+	sample.pcm.resize(100 * 2, 8192);
+
+	VoicePool pool;
+	float out[64 * 2], scratch[64 * 2], voiceBuffer[64 * 2];
+	memset(out, 0, sizeof(out));
+	pool.Play(&sample);
+	pool.Mix(out, scratch, voiceBuffer, 32);
+	pool.Play(&sample);
+	pool.Mix(out + 32 * 2, scratch, voiceBuffer, 32);
+	TestEnsure(pool.GetNumActive() == 2);
+	TestEnsure(fabsf(out[0] - 0.25f) < 0.001f);
+	TestEnsure(fabsf(out[32 * 2] - 0.5f) < 0.001f);
+
+	// First voice ends after 100 frames, the second one keeps playing
+	pool.Mix(out, scratch, voiceBuffer, 64);
+	TestEnsure(pool.GetNumActive() == 1);
+
+	for(uint32 i = 0; i < VoicePool::maxVoicesPerSample * 2; i++)
+		pool.Play(&sample);
+	TestEnsure(pool.GetNumActive(&sample) == VoicePool::maxVoicesPerSample);
+	pool.Stop(&sample);
+	TestEnsure(pool.GetNumActive() == 0);
+}
+
+// Delay lines wrap without reallocating, pooled DSP's come back cleared
+Test("Audio.DelayLine")
+{
+	DelayLine delay;
+	delay.Init(100);
+	TestEnsure(delay.GetMaxDelay() == 127);
+	for(uint32 i = 0; i < 1000; i++)
+		delay.Write((float)i, -(float)i);
+	TestEnsure(delay.Read(0)[0] == 999.0f);
+	TestEnsure(delay.Read(100)[1] == -899.0f);
+	delay.Clear();
+	delay.Write(1.0f, 1.0f);
+	TestEnsure(delay.Read(0)[0] == 1.0f && delay.Read(1)[0] == 0.0f && delay.Read(127)[0] == 0.0f);
+
+	DSPPool pool;
+	pool.Reserve<EchoDSP>(2, 44100);
+	TestEnsure(pool.GetNumFree<EchoDSP>() == 2);
+	EchoDSP* echo = pool.Acquire<EchoDSP>();
+	TestEnsure(pool.GetNumFree<EchoDSP>() == 1);
+	echo->mix = 0.5f;
+	pool.Release(echo);
+	TestEnsure(pool.GetNumFree<EchoDSP>() == 2);
+	TestEnsure(pool.Acquire<EchoDSP>() == echo && echo->mix == 1.0f);
+	pool.Release(echo);
+	TestEnsure(pool.GetNumFree<FlangerDSP>() == 0);
+	pool.Release(pool.Acquire<FlangerDSP>());
+	TestEnsure(pool.GetNumFree<FlangerDSP>() == 1);
+}
+
+// Least recently used segments are evicted first when over budget
+Test("Audio.Cache")
+{
+	auto MakeSegment = [](const String& path, uint32 numFrames)
+	{
+		Ref<PCMSegment> segment = Ref<PCMSegment>(new PCMSegment());
+		segment->path = path;
+		segment->duration = 1000;
+		segment->sampleRate = 44100;
+		segment->data.resize(numFrames * 2);
+		return segment;
+	};
+
+	AudioCache cache;
+	cache.SetMemoryBudget(1000 * 4 * 2);
+	Ref<PCMSegment> a = MakeSegment("a.ogg", 1000);
+	Ref<PCMSegment> b = MakeSegment("b.ogg", 1000);
+	Ref<PCMSegment> c = MakeSegment("c.ogg", 1000);
+	cache.Add(a);
+	cache.Add(b);
+	TestEnsure(cache.GetMemoryUsage() == 1000 * 4 * 2);
+
+	// Touch a so b is the oldest
+	Ref<PCMSegment> found = cache.Find("a.ogg", 0, 1000);
+	TestEnsure(found == a);
+	cache.Release(found);
+	cache.Add(c);
+	TestEnsure(cache.GetMemoryUsage() == 1000 * 4 * 2);
+
+	found = cache.Find("b.ogg", 0, 1000);
+	TestEnsure(!found);
+	found = cache.Find("a.ogg", 0, 1000);
+	TestEnsure(found);
+	cache.Release(found);
+	TestEnsure(!cache.Find("c.ogg", 500, 1000));
+	cache.Clear();
+	TestEnsure(cache.GetMemoryUsage() == 0);
+}
+
+// Test saving and reusing seek indices, and that streams seek to the same audio through them as when playing from the start
+Test("Audio.SeekIndex")
+{
+	SeekIndex::cacheFolder = TestBasePath + Path::sep + "seekindex";
+	Path::DeleteDir(SeekIndex::cacheFolder);
+
+	String sourcePath = TestFilename + ".ogg";
+	File source;
+	TestEnsure(source.OpenWrite(sourcePath));
+	source.Write("OggS", 4);
+	source.Close();
+
+	SeekIndex index;
+	index.samplesTotal = 3000;
+	index.Add(0, 0);
+	index.Add(1000, 4000);
+	index.Add(2000, 8000);
+	TestEnsure(index.Find(-1) == -1);
+	TestEnsure(index.Find(0) == 0);
+	TestEnsure(index.Find(1999) == 1);
+	TestEnsure(index.Find(5000) == 2);
+	TestEnsure(index.Save(sourcePath));
+
+	SeekIndex loaded;
+	TestEnsure(loaded.Load(sourcePath));
+	TestEnsure(loaded.GetSize() == 3 && loaded.samplesTotal == 3000);
+	TestEnsure(loaded[1].sample == 1000 && loaded[1].offset == 4000);
+
+	// Indices with a different layout are rejected
+	Vector<FileInfo> files = Files::ScanFiles(SeekIndex::cacheFolder);
+	TestEnsure(files.size() == 1);
+	auto ReplaceHeaderField = [&](uint32 offset, uint32 value)
+	{
+		File file;
+		TestEnsure(file.OpenRead(files[0].fullPath));
+		Buffer data;
+		data.resize(file.GetSize());
+		file.Read(data.data(), data.size());
+		file.Close();
+		uint32 original;
+		memcpy(&original, data.data() + offset, sizeof(original));
+		memcpy(data.data() + offset, &value, sizeof(value));
+		TestEnsure(file.OpenWrite(files[0].fullPath));
+		file.Write(data.data(), data.size());
+		file.Close();
+		return original;
+	};
+	uint32 magic = ReplaceHeaderField(0, 0);
+	TestEnsure(!loaded.Load(sourcePath));
+	ReplaceHeaderField(0, magic);
+	uint32 version = ReplaceHeaderField(4, 0xFFFF);
+	TestEnsure(!loaded.Load(sourcePath));
+	ReplaceHeaderField(4, version);
+	TestEnsure(loaded.Load(sourcePath));
+
+	// So are indices of a file that changed
+	TestEnsure(source.OpenWrite(sourcePath, true));
+	source.Write("OggS", 4);
+	source.Close();
+	TestEnsure(!loaded.Load(sourcePath));
+
+	// Opening the stream builds the index of the song, the next time it's loaded from disk
+	auto RenderStream = [&](int32 position, uint32 numSamples, Vector<float>& out)
+	{
+		Audio* audio = new Audio();
+		TestEnsure(audio->InitOffline(512, 44100));
+		// The limiter's delay and gain depend on what was played before
+		audio->GetImpl()->globalDSPs.Remove(audio->GetImpl()->limiter);
+		AudioStream stream = audio->CreateStream(testSongPath);
+		TestEnsure(stream.IsValid());
+		if(position > 0)
+			stream->SetPosition(position);
+		stream->Play();
+		out.resize(numSamples * 2);
+		audio->Render(out.data(), numSamples);
+		stream.Release();
+		delete audio;
+	};
+	const int32 seekTime = 2000;
+	const uint32 seekFrame = 44100 * seekTime / 1000;
+	const uint32 numFrames = 8192;
+	Vector<float> linear, seeked;
+	RenderStream(0, seekFrame + numFrames, linear);
+	SeekIndex songIndex;
+	TestEnsure(songIndex.Load(testSongPath));
+	TestEnsure(!songIndex.IsEmpty() && songIndex.samplesTotal > 0);
+	RenderStream(seekTime, numFrames, seeked);
+
+	// Resampling takes a few frames to settle after a seek
+	const uint32 settleFrames = 256;
+	float maxDifference = 0.0f;
+	for(uint32 i = settleFrames * 2; i < numFrames * 2; i++)
+	{
+		maxDifference = Math::Max(maxDifference, fabsf(seeked[i] - linear[seekFrame * 2 + i]));
+	}
+	TestEnsure(maxDifference < 0.001f);
+}
+
+// Deterministic input for offline rendering, a second of tone sweep with some noise that repeats
+//	generated up front so the source doesn't add to the measured time
+class BenchmarkSource : public AudioBase
+{
+public:
+	Vector<float> signal;
+	uint32 position = 0;
+
+	BenchmarkSource()
+	{
+		const uint32 length = 44100;
+		signal.resize(length * 2);
+		uint32 seed = 1;
+		for(uint32 i = 0; i < length; i++)
+		{
+			double t = (double)i / 44100.0;
+			float tone = (float)sin(2.0 * Math::pi * (110.0 + 440.0 * t) * t) * 0.5f;
+			seed = seed * 1664525u + 1013904223u;
+			float noise = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 0.2f;
+			signal[i * 2] = tone + noise;
+			signal[i * 2 + 1] = tone - noise;
+		}
+	}
+	virtual void Process(float* out, uint32 numSamples) override
+	{
+		uint32 length = (uint32)(signal.size() / 2);
+		for(uint32 i = 0; i < numSamples;)
+		{
+			uint32 count = Math::Min(numSamples - i, length - position);
+			memcpy(out + i * 2, signal.data() + position * 2, sizeof(float) * 2 * count);
+			position = (position + count) % length;
+			i += count;
+		}
+	}
+};
+
+// Creates the DSP for an effect like the game does, with the default settings at half laser input
+static DSP* CreateEffectDSP(AudioBase* item, EffectType type)
+{
+	const AudioEffect& effect = AudioEffect::GetDefault(type);
+	const float input = 0.5f;
+	// Whole note at 120 BPM
+	const double noteDuration = 2000.0;
+	uint32 length = effect.duration.Sample(input).Absolute(noteDuration);
+
+	DSP* ret = nullptr;
+	switch(type)
+	{
+	case EffectType::Bitcrush:
+	{
+		BitCrusherDSP* dsp = new BitCrusherDSP();
+		item->AddDSP(dsp);
+		dsp->SetPeriod((float)effect.bitcrusher.reduction.Sample(input));
+		ret = dsp;
+		break;
+	}
+	case EffectType::Echo:
+	{
+		EchoDSP* dsp = new EchoDSP();
+		item->AddDSP(dsp);
+		dsp->feedback = effect.echo.feedback.Sample(input);
+		dsp->SetLength(length);
+		ret = dsp;
+		break;
+	}
+	case EffectType::PeakingFilter:
+	{
+		BQFDSP* dsp = new BQFDSP();
+		item->AddDSP(dsp);
+		dsp->SetPeaking(effect.peaking.q.Sample(input), effect.peaking.freq.Sample(input), effect.peaking.gain.Sample(input));
+		ret = dsp;
+		break;
+	}
+	case EffectType::LowPassFilter:
+	{
+		BQFDSP* dsp = new BQFDSP();
+		item->AddDSP(dsp);
+		dsp->SetLowPass(effect.lpf.q.Sample(input) + 0.1f, effect.lpf.freq.Sample(input));
+		ret = dsp;
+		break;
+	}
+	case EffectType::HighPassFilter:
+	{
+		BQFDSP* dsp = new BQFDSP();
+		item->AddDSP(dsp);
+		dsp->SetHighPass(effect.hpf.q.Sample(input) + 0.1f, effect.hpf.freq.Sample(input));
+		ret = dsp;
+		break;
+	}
+	case EffectType::Gate:
+	{
+		GateDSP* dsp = new GateDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		dsp->SetGating(effect.gate.gate.Sample(input));
+		ret = dsp;
+		break;
+	}
+	case EffectType::TapeStop:
+	{
+		TapeStopDSP* dsp = new TapeStopDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		ret = dsp;
+		break;
+	}
+	case EffectType::Retrigger:
+	{
+		RetriggerDSP* dsp = new RetriggerDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		dsp->SetGating(effect.retrigger.gate.Sample(input));
+		dsp->SetResetDuration(effect.retrigger.reset.Sample(input).Absolute(noteDuration));
+		ret = dsp;
+		break;
+	}
+	case EffectType::Wobble:
+	{
+		WobbleDSP* dsp = new WobbleDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		dsp->q = effect.wobble.q.Sample(input);
+		dsp->fmax = effect.wobble.max.Sample(input);
+		dsp->fmin = effect.wobble.min.Sample(input);
+		ret = dsp;
+		break;
+	}
+	case EffectType::Phaser:
+	{
+		PhaserDSP* dsp = new PhaserDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		dsp->dmin = effect.phaser.min.Sample(input);
+		dsp->dmax = effect.phaser.max.Sample(input);
+		dsp->fb = effect.phaser.feedback.Sample(input);
+		ret = dsp;
+		break;
+	}
+	case EffectType::Flanger:
+	{
+		FlangerDSP* dsp = new FlangerDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		dsp->SetDelayRange(effect.flanger.offset.Sample(input), effect.flanger.depth.Sample(input));
+		ret = dsp;
+		break;
+	}
+	case EffectType::SideChain:
+	{
+		SidechainDSP* dsp = new SidechainDSP();
+		item->AddDSP(dsp);
+		dsp->SetLength(length);
+		dsp->amount = 1.0f;
+		dsp->curve = Interpolation::CubicBezier(0.39, 0.575, 0.565, 1);
+		ret = dsp;
+		break;
+	}
+	case EffectType::Panning:
+	{
+		PanDSP* dsp = new PanDSP();
+		item->AddDSP(dsp);
+		dsp->panning = effect.panning.panning.Sample(input);
+		ret = dsp;
+		break;
+	}
+	case EffectType::PitchShift:
+	{
+		PitchShiftDSP* dsp = new PitchShiftDSP();
+		item->AddDSP(dsp);
+		dsp->amount = effect.pitchshift.amount.Sample(input);
+		ret = dsp;
+		break;
+	}
+	default:
+		break;
+	}
+	if(ret)
+		ret->mix = 1.0f;
+	return ret;
+}
+
+// Renders every DSP offline, reports the time it takes and checks that rendering is deterministic
+//	"None" is the cost of the mixer itself
+Test("Audio.Benchmark")
+{
+	struct Entry
+	{
+		String name;
+		std::function<DSP*(AudioBase*)> create;
+	};
+	Vector<Entry> entries;
+	entries.Add({ "None", [](AudioBase*) { return (DSP*)nullptr; } });
+	for(uint32 i = (uint32)EffectType::Retrigger; i <= (uint32)EffectType::PeakingFilter; i++)
+	{
+		EffectType type = (EffectType)i;
+		entries.Add({ Enum_EffectType::ToString(type), [=](AudioBase* item) { return CreateEffectDSP(item, type); } });
+	}
+	entries.Add({ "CombinedFilter", [](AudioBase* item)
+	{
+		CombinedFilterDSP* dsp = new CombinedFilterDSP();
+		item->AddDSP(dsp);
+		dsp->SetLowPass(1.0f, 2000.0f, 1.0f, 6.0f);
+		return (DSP*)dsp;
+	} });
+	entries.Add({ "Limiter", [](AudioBase* item)
+	{
+		LimiterDSP* dsp = new LimiterDSP();
+		item->AddDSP(dsp);
+		return (DSP*)dsp;
+	} });
+
+	const uint32 numSamples = 44100 * 10;
+	Vector<float> output[2];
+	double mixerTime = 0.0;
+	for(auto& entry : entries)
+	{
+		double nsPerSample = DBL_MAX;
+		for(uint32 pass = 0; pass < 2; pass++)
+		{
+			Audio* audio = new Audio();
+			TestEnsure(audio->InitOffline(512, 44100));
+
+			BenchmarkSource source;
+			audio->GetImpl()->Register(&source);
+			DSP* dsp = entry.create(&source);
+
+			output[pass].resize(numSamples * 2);
+			Timer t;
+			audio->Render(output[pass].data(), numSamples);
+			nsPerSample = Math::Min(nsPerSample, t.SecondsAsDouble() * 1e9 / numSamples);
+
+			if(dsp)
+			{
+				source.RemoveDSP(dsp);
+				delete dsp;
+			}
+			source.Deregister();
+			delete audio;
+		}
+
+		if(entry.name == "None")
+			mixerTime = nsPerSample;
+		Logf("%-16s %8.2f ns/sample (%+.2f over the mixer)", Logger::Info, entry.name, nsPerSample, nsPerSample - mixerTime);
+		TestEnsure(memcmp(output[0].data(), output[1].data(), numSamples * 2 * sizeof(float)) == 0);
+	}
+
+	// Wav output
+	Audio* audio = new Audio();
+	TestEnsure(audio->InitOffline());
+	String wavPath = TestFilename + ".wav";
+	TestEnsure(audio->RenderToFile(wavPath, 4410));
+	delete audio;
+	File wav;
+	TestEnsure(wav.OpenRead(wavPath));
+	TestEnsure(wav.GetSize() == 44 + 4410 * 2 * sizeof(float));
+}
+
+// Items rendered by the mix workers add up to the same mix as rendering them one at a time
+Test("Audio.MixWorkers")
+{
+	const uint32 numItems = 6;
+	const uint32 numSamples = 44100;
+	auto RenderItems = [&](uint32 first, uint32 count, Vector<float>& out)
+	{
+		Audio* audio = new Audio();
+		TestEnsure(audio->InitOffline(512, 44100));
+		audio->GetImpl()->globalDSPs.Remove(audio->GetImpl()->limiter);
+		BenchmarkSource sources[numItems];
+		for(uint32 i = 0; i < count; i++)
+		{
+			sources[i].position = (first + i) * 5000;
+			sources[i].SetVolume(0.1f * (float)(first + i + 1));
+			audio->GetImpl()->Register(&sources[i]);
+		}
+		out.resize(numSamples * 2);
+		audio->Render(out.data(), numSamples);
+		for(uint32 i = 0; i < count; i++)
+			sources[i].Deregister();
+		delete audio;
+	};
+
+	Vector<float> mix, again, single;
+	RenderItems(0, numItems, mix);
+	RenderItems(0, numItems, again);
+	TestEnsure(memcmp(mix.data(), again.data(), numSamples * 2 * sizeof(float)) == 0);
+
+	Vector<float> sum;
+	sum.resize(numSamples * 2, 0.0f);
+	for(uint32 i = 0; i < numItems; i++)
+	{
+		RenderItems(i, 1, single);
+		for(uint32 j = 0; j < numSamples * 2; j++)
+			sum[j] += single[j];
+	}
+	float maxDifference = 0.0f;
+	for(uint32 i = 0; i < numSamples * 2; i++)
+	{
+		maxDifference = Math::Max(maxDifference, fabsf(mix[i] - sum[i]));
+	}
+	TestEnsure(maxDifference < 0.0001f);
+}
+
+// Items that take too long to render have their DSP's bypassed, workers that don't finish in time have their items dropped
+Test("Audio.MixDeadline")
+{
+	// Sleeps while rendering, for a different time on the thread that calls Render than on the mix workers
+	class SlowSource : public BenchmarkSource
+	{
+	public:
+		thread::id renderThread = this_thread::get_id();
+		uint32 renderThreadSleep = 0;
+		uint32 workerSleep = 0;
+
+		virtual void Process(float* out, uint32 numSamples) override
+		{
+			BenchmarkSource::Process(out, numSamples);
+			bool onRenderThread = this_thread::get_id() == renderThread;
+			this_thread::sleep_for(chrono::milliseconds(onRenderThread ? renderThreadSleep : workerSleep));
+		}
+	};
+	class CountingDSP : public DSP
+	{
+	public:
+		uint32 numCalls = 0;
+		virtual void Process(float* out, uint32 numSamples) override
+		{
+			numCalls++;
+		}
+	};
+
+	// Every block takes longer than it lasts, so the DSP never runs
+	//	the mixer's stats are kept between instances
+	Audio* audio = new Audio();
+	TestEnsure(audio->InitOffline(512, 44100));
+	audio->GetImpl()->enforceMixDeadline = true;
+	uint64 numBypassed = audio->GetImpl()->GetNumBypassedBlocks();
+	SlowSource slow;
+	slow.renderThreadSleep = 20;
+	slow.workerSleep = 20;
+	CountingDSP dsp;
+	audio->GetImpl()->Register(&slow);
+	slow.AddDSP(&dsp);
+	Vector<float> out;
+	out.resize(1024 * 2);
+	audio->Render(out.data(), 1024);
+	audio->GetImpl()->enforceMixDeadline = false;
+	slow.RemoveDSP(&dsp);
+	slow.Deregister();
+	TestEnsure(audio->GetImpl()->GetNumBypassedBlocks() >= numBypassed + 2);
+	TestEnsure(dsp.numCalls == 0);
+	numBypassed = audio->GetImpl()->GetNumBypassedBlocks();
+	delete audio;
+
+	// Without a deadline the same item is rendered with it's DSP
+	audio = new Audio();
+	TestEnsure(audio->InitOffline(512, 44100));
+	audio->GetImpl()->Register(&slow);
+	slow.AddDSP(&dsp);
+	audio->Render(out.data(), 1024);
+	slow.RemoveDSP(&dsp);
+	slow.Deregister();
+	TestEnsure(audio->GetImpl()->GetNumBypassedBlocks() == numBypassed);
+	TestEnsure(dsp.numCalls > 0);
+	delete audio;
+
+	// Items picked up by the workers outlast the timeout while the mixer's own items are quick
+	audio = new Audio();
+	TestEnsure(audio->InitOffline(512, 44100));
+	if(audio->GetImpl()->GetNumMixWorkers() == 0)
+	{
+		Logf("No mix workers on this machine, skipping dropped items", Logger::Warning);
+		delete audio;
+		return;
+	}
+	audio->GetImpl()->enforceMixDeadline = true;
+	uint64 numDropped = audio->GetImpl()->stats.GetNumDroppedItems();
+	SlowSource sources[8];
+	for(auto& source : sources)
+	{
+		source.renderThreadSleep = 1;
+		source.workerSleep = 50;
+		audio->GetImpl()->Register(&source);
+	}
+	audio->Render(out.data(), 1024);
+	audio->GetImpl()->enforceMixDeadline = false;
+	for(auto& source : sources)
+		source.Deregister();
+	TestEnsure(audio->GetImpl()->stats.GetNumDroppedItems() > numDropped);
+	delete audio;
+}
+
 Test("Audio.Playback")
 {
 	Audio* audio = new Audio();
@@ -1,6 +1,9 @@
 #include "stdafx.h"
 #include <Audio/Audio.hpp>
 #include <Beatmap/BeatmapPlayback.hpp>
+#include <Beatmap/ChartCache.hpp>
+#include <Beatmap/KShootMap.hpp>
+#include <Shared/MemoryStream.hpp>
 #include <Audio/DSP.hpp>
 #include "TestMusicPlayer.hpp"
 
@@ -51,6 +54,154 @@ Test("Beatmap.Loading")
 	Logf("Jacket File: %s", Logger::Info, settings.jacketPath);
 }
 
+static bool LoadChartText(const String& chart, Beatmap& map)
+{
+	Buffer data;
+	data.resize(chart.size());
+	memcpy(data.data(), chart.data(), chart.size());
+	MemoryReader reader(data);
+	return map.Load(reader);
+}
+
+// Test that both line endings are read the same and where the ticks of a chart end
+Test("Beatmap.KSHBars")
+{
+	// Expected button index for each beat at 120 BPM, only the first two bars are read
+	auto CheckButtons = [&](const Beatmap& map)
+	{
+		const Vector<ObjectState*>& objects = map.GetLinearObjects();
+		TestEnsure(objects.size() == 3);
+		for(uint32 i = 0; i < objects.size() && i < 3; i++)
+		{
+			MultiObjectState* obj = *objects[i];
+			TestEnsure(obj->type == ObjectType::Single);
+			TestEnsure(obj->button.index == i);
+			TestEnsure(obj->time == (MapTime)i * 1000);
+		}
+	};
+
+	String chart = "title=Bars\r\nt=120\r\n--\r\n1000|00|--\r\n0100|00|--\r\n--\r\n0010|00|--\r\n0000|00|--\r\n--\r\n";
+	Beatmap crlf;
+	TestEnsure(LoadChartText(chart, crlf));
+	CheckButtons(crlf);
+
+	String lfChart = chart;
+	lfChart.erase(std::remove(lfChart.begin(), lfChart.end(), '\r'), lfChart.end());
+	Beatmap lf;
+	TestEnsure(LoadChartText(lfChart, lf));
+	CheckButtons(lf);
+
+	// Nothing after an empty bar is read
+	Beatmap emptyBar;
+	TestEnsure(LoadChartText(chart + "--\r\n0001|00|--\r\n--\r\n", emptyBar));
+	CheckButtons(emptyBar);
+
+	// Nor a last bar that is not closed
+	Beatmap unclosed;
+	TestEnsure(LoadChartText(chart + "0001|00|--\r\n", unclosed));
+	CheckButtons(unclosed);
+}
+
+// Test the string views ticks are read with, the text they point to goes on after them like in a map file
+Test("Beatmap.KShootString")
+{
+	const char* text = "fx-l=Echo;12;345|t=128.5999";
+	KShootString value(text + 5, 10);
+	TestEnsure(value == "Echo;12;34");
+	TestEnsure(value.ToString() == "Echo;12;34");
+
+	KShootString name, params, a, b;
+	TestEnsure(value.Split(';', &name, &params));
+	TestEnsure(name == "Echo" && params == "12;34");
+	TestEnsure(params.Split(';', &a, &b));
+	TestEnsure(a.ToInt() == 12 && b.ToInt() == 34);
+	TestEnsure(!b.Split(';', nullptr, nullptr));
+
+	// Either output can be the string itself
+	KShootString self = value;
+	TestEnsure(self.Split(';', &self, nullptr) && self == "Echo");
+
+	KShootString bpm(text + 19, 5);
+	TestEnsure(bpm.ToDouble() == 128.5);
+
+	KShootString tilt("keep_bigger_x", 11);
+	TestEnsure(tilt.Find("keep_") == 0);
+	TestEnsure(tilt.Find("bigger") == 5);
+	TestEnsure(tilt.Find("_x") == -1);
+}
+
+// Test loading a map from the chart cache, and that changing the chart invalidates it
+Test("Beatmap.ChartCache")
+{
+	String chart = "title=Cache\r\nartist=Test\r\nt=120\r\nm=song.ogg\r\nlevel=5\r\ntotal=180\r\n--\r\n"
+		"1000|00|0-\r\n0000|02|:-\r\n0200|02|o-\r\n0200|02|:-\r\n0000|02|0-\r\n0000|00|--\r\n--\r\n"
+		"t=180\r\nstop=48\r\n0001|20|-0\r\n0001|20|-:\r\n0000|00|-o\r\n0000|00|--\r\n--\r\n";
+	String chartPath = TestFilename + ".ksh";
+	ChartCache::cacheFolder = context.GetTestBasePath() + Path::sep + "chartcache";
+	File file;
+	TestEnsure(file.OpenWrite(chartPath));
+	file.Write(chart.data(), chart.size());
+	file.Close();
+
+	Beatmap* parsed = ChartCache::LoadMap(chartPath);
+	TestEnsure(parsed);
+	Beatmap cached;
+	TestEnsure(ChartCache::Load(chartPath, cached));
+	TestEnsure(cached.GetMapSettings().title == "Cache");
+	TestEnsure(cached.GetMapSettings().total == 180);
+	TestEnsure(cached.GetLinearTimingPoints().size() == parsed->GetLinearTimingPoints().size());
+	TestEnsure(cached.GetLinearChartStops().size() == parsed->GetLinearChartStops().size());
+
+	const Vector<ObjectState*>& parsedObjects = parsed->GetLinearObjects();
+	const Vector<ObjectState*>& cachedObjects = cached.GetLinearObjects();
+	TestEnsure(cachedObjects.size() == parsedObjects.size());
+	auto IndexOf = [](const Vector<ObjectState*>& objects, ObjectState* obj)
+	{
+		return std::find(objects.begin(), objects.end(), obj) - objects.begin();
+	};
+	for(size_t i = 0; i < parsedObjects.size(); i++)
+	{
+		MultiObjectState* a = *parsedObjects[i];
+		MultiObjectState* b = *cachedObjects[i];
+		TestEnsure(a->type == b->type && a->time == b->time);
+		if(a->type == ObjectType::Laser)
+		{
+			// Links point to the same objects
+			TestEnsure(!a->laser.next == !b->laser.next);
+			if(a->laser.next)
+				TestEnsure(IndexOf(parsedObjects, *a->laser.next) == IndexOf(cachedObjects, *b->laser.next));
+			TestEnsure(a->laser.points[0] == b->laser.points[0] && a->laser.points[1] == b->laser.points[1]);
+		}
+	}
+	delete parsed;
+
+	// Changed charts are parsed again
+	TestEnsure(file.OpenWrite(chartPath, true));
+	file.Write("\r\n", 2);
+	file.Close();
+	Beatmap outdated;
+	TestEnsure(!ChartCache::Load(chartPath, outdated));
+}
+
+// Test reading the settings of a map, without reading it's objects
+Test("Beatmap.LoadSettings")
+{
+	String chart = "title=Header\r\nt=150\r\nlevel=12\r\ndifficulty=extended\r\n--\r\n";
+	for(uint32 i = 0; i < 1000; i++)
+		chart += "1000|00|0-\r\n0000|00|o-\r\n--\r\n";
+	Buffer data;
+	data.resize(chart.size());
+	memcpy(data.data(), chart.data(), chart.size());
+
+	MemoryReader reader(data);
+	BeatmapSettings settings;
+	TestEnsure(Beatmap::LoadSettings(reader, settings));
+	TestEnsure(settings.title == "Header" && settings.bpm == "150");
+	TestEnsure(settings.level == 12 && settings.difficulty == 2);
+	// Stops reading after the header
+	TestEnsure(reader.Tell() < reader.GetSize());
+}
+
 // Test 4/4 single bpm map
 Test("Beatmap.Playback")
 {
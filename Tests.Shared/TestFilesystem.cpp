@@ -120,6 +120,13 @@ Test("File.Operations")
 	TestEnsure(Path::FileExists(TestFilename));
 	TestEnsure(!Path::FileExists(newFilename));
 
+	// Existing files are only replaced when asked to
+	CreateDummyFile(newFilename);
+	TestEnsure(!Path::Rename(TestFilename, newFilename));
+	TestEnsure(Path::Rename(TestFilename, newFilename, true));
+	TestEnsure(!Path::FileExists(TestFilename));
+	TestEnsure(Path::Rename(newFilename, TestFilename));
+
 	TestEnsure(Path::Delete(TestFilename));
 	TestEnsure(!Path::FileExists(TestFilename));
 }
@@ -0,0 +1,295 @@
+#include <Shared/Shared.hpp>
+#include <Shared/Jobs.hpp>
+#include <Shared/Thread.hpp>
+#include <Tests/Tests.hpp>
+
+// Runs Update until all jobs are finalized or the timeout is reached
+static bool WaitForJobs(JobSheduler& sheduler, const Vector<Job>& jobs, float timeout = 5.0f)
+{
+	Timer t;
+	while(t.SecondsAsFloat() < timeout)
+	{
+		sheduler.Update();
+		bool done = true;
+		for(const Job& job : jobs)
+			done = done && job->IsFinished();
+		if(done)
+			return true;
+		std::this_thread::yield();
+	}
+	return false;
+}
+
+Test("Jobs.Run")
+{
+	JobSheduler sheduler;
+	std::atomic<uint32> counter = { 0 };
+	uint32 callbacks = 0;
+
+	Vector<Job> jobs;
+	for(uint32 i = 0; i < 200; i++)
+	{
+		Job job = JobBase::CreateLambda([&]()
+		{
+			counter++;
+			return true;
+		});
+		if(i % 3 == 0)
+			job->jobFlags = JobFlags::IO;
+		job->priority = (JobPriority)(i % 3);
+		job->OnFinished.AddLambda([&](Job j) { callbacks++; });
+		TestEnsure(sheduler.Queue(job));
+		jobs.Add(job);
+	}
+	TestEnsure(WaitForJobs(sheduler, jobs));
+	TestEnsure(counter == 200);
+	TestEnsure(callbacks == 200);
+	for(Job& job : jobs)
+	{
+		TestEnsure(job->IsSuccessfull());
+		TestEnsure(!job->IsQueued());
+	}
+}
+
+Test("Jobs.Continuations")
+{
+	JobSheduler sheduler;
+	Vector<uint32> order;
+	Mutex lock;
+	auto makeJob = [&](uint32 index)
+	{
+		return JobBase::CreateLambda([&, index]()
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			lock.lock();
+			order.Add(index);
+			lock.unlock();
+			return true;
+		});
+	};
+
+	// Chain of jobs that each wait for the previous one
+	Vector<Job> jobs;
+	jobs.Add(makeJob(0));
+	TestEnsure(sheduler.Queue(jobs[0]));
+	for(uint32 i = 1; i < 8; i++)
+	{
+		jobs.Add(makeJob(i));
+		TestEnsure(sheduler.QueueAfter(jobs[i], jobs[i - 1]));
+	}
+	TestEnsure(WaitForJobs(sheduler, jobs));
+	TestEnsure(order.size() == 8);
+	for(uint32 i = 0; i < order.size(); i++)
+		TestEnsure(order[i] == i);
+
+	// Terminating a job cancels the jobs waiting for it
+	std::atomic<bool> started = { false };
+	std::atomic<bool> release = { false };
+	Job blocker = JobBase::CreateLambda([&]()
+	{
+		started = true;
+		while(!release)
+			std::this_thread::yield();
+		return true;
+	});
+	Job first = makeJob(100);
+	Job second = makeJob(101);
+	sheduler.Queue(blocker);
+	sheduler.QueueAfter(first, blocker);
+	sheduler.QueueAfter(second, first);
+	while(!started)
+		std::this_thread::yield();
+	first->Terminate();
+	TestEnsure(!first->IsQueued());
+	TestEnsure(!second->IsQueued());
+	release = true;
+	blocker->Terminate();
+	TestEnsure(!blocker->IsQueued());
+	TestEnsure(blocker->IsSuccessfull());
+	TestEnsure(!order.Contains(100) && !order.Contains(101));
+}
+
+Test("Jobs.WakeUp")
+{
+	JobSheduler sheduler;
+
+	// Jobs queued after the threads went idle should start right away
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	Timer t;
+	std::atomic<float> startTime = { -1.0f };
+	Job job = JobBase::CreateLambda([&]()
+	{
+		startTime = t.SecondsAsFloat();
+		return true;
+	});
+	sheduler.Queue(job);
+	TestEnsure(WaitForJobs(sheduler, { job }));
+	Logf("Job started after %.3f ms", Logger::Info, startTime * 1000.0f);
+	TestEnsure(startTime >= 0.0f && startTime < 0.05f);
+}
+
+Test("Jobs.ReadFile")
+{
+	JobSheduler sheduler;
+
+	// Files of different sizes, read in batches by the IO threads
+	Vector<String> paths;
+	for(uint32 i = 0; i < 12; i++)
+	{
+		String path = TestFilename + Utility::Sprintf("_%d", i);
+		File file;
+		TestEnsure(file.OpenWrite(path));
+		Buffer data(1000 * i + 1);
+		for(size_t j = 0; j < data.size(); j++)
+			data[j] = (uint8)(j + i);
+		file.Write(data.data(), data.size());
+		paths.Add(path);
+	}
+
+	Vector<Job> jobs;
+	Vector<Ref<FileReadJob>> reads;
+	std::atomic<uint32> processed = { 0 };
+	for(uint32 i = 0; i < paths.size(); i++)
+	{
+		Ref<FileReadJob> read = sheduler.QueueRead(paths[i]);
+		// Owned by <reads>, Ref can't be copied on the job threads
+		FileReadJob* readJob = read.GetData();
+		Job process = JobBase::CreateLambda([&, i, readJob]()
+		{
+			FileReadJob* read = readJob;
+			// Runs after the read is done
+			if(!read->IsSuccessfull() || read->data.size() != 1000 * i + 1)
+				return false;
+			for(size_t j = 0; j < read->data.size(); j++)
+			{
+				if(read->data[j] != (uint8)(j + i))
+					return false;
+			}
+			processed++;
+			return true;
+		});
+		TestEnsure(sheduler.QueueAfter(process, read.As<JobBase>()));
+		reads.Add(read);
+		jobs.Add(process);
+	}
+	Job missing = sheduler.QueueRead(TestFilename + "_missing").As<JobBase>();
+	jobs.Add(missing);
+
+	TestEnsure(WaitForJobs(sheduler, jobs));
+	TestEnsure(processed == paths.size());
+	TestEnsure(!missing->IsSuccessfull());
+	for(Ref<FileReadJob>& read : reads)
+		TestEnsure(read->IsFinished());
+}
+
+Test("Jobs.Futures")
+{
+	JobSheduler sheduler;
+
+	Vector<Future<uint64>> sums;
+	Vector<Job> jobs;
+	for(uint32 i = 0; i < 16; i++)
+	{
+		sums.Add(sheduler.Async([i]()
+		{
+			uint64 sum = 0;
+			for(uint64 j = 0; j <= i * 1000; j++)
+				sum += j;
+			return sum;
+		}));
+		jobs.Add(sums.back().GetJob());
+	}
+
+	// Job that depends on all the others
+	std::atomic<bool> dependencyOrder = { true };
+	Job after = JobBase::CreateLambda([&]()
+	{
+		for(Future<uint64>& sum : sums)
+			dependencyOrder = dependencyOrder && sum.IsReady();
+		return true;
+	});
+	TestEnsure(sheduler.QueueAfter(after, jobs));
+	Job all = sheduler.WhenAll(jobs);
+
+	for(uint32 i = 0; i < sums.size(); i++)
+	{
+		uint64 n = i * 1000;
+		TestEnsure(sums[i].Get() == n * (n + 1) / 2);
+	}
+	all->Wait();
+	after->Wait();
+	TestEnsure(all->HasRun() && all->IsSuccessfull());
+	TestEnsure(dependencyOrder);
+
+	jobs.Add(after);
+	jobs.Add(all);
+	TestEnsure(WaitForJobs(sheduler, jobs));
+}
+
+Test("Jobs.ParallelFor")
+{
+	JobSheduler sheduler;
+
+	Vector<uint32> values(10000, 0);
+	sheduler.ParallelFor(0, (uint32)values.size(), 64, [&](uint32 i)
+	{
+		values[i] += i * 2;
+	});
+	for(uint32 i = 0; i < values.size(); i++)
+		TestEnsure(values[i] == i * 2);
+
+	// Nested in a job, waiting runs the other jobs so this can't deadlock
+	std::atomic<uint32> count = { 0 };
+	Future<bool> nested = sheduler.Async([&]()
+	{
+		sheduler.ParallelFor(10, 20, 1, [&](uint32 i)
+		{
+			count += i;
+		});
+		return true;
+	});
+	TestEnsure(nested.Get());
+	TestEnsure(count == 145);
+
+	// Empty range
+	sheduler.ParallelFor(5, 5, 8, [&](uint32 i)
+	{
+		count = 0;
+	});
+	TestEnsure(count == 145);
+}
+
+Test("Jobs.FinalizeBudget")
+{
+	JobSheduler sheduler;
+	Vector<uint32> order;
+
+	Vector<Job> jobs;
+	for(uint32 i = 0; i < 6; i++)
+	{
+		Job job = JobBase::CreateLambda([]() { return true; });
+		job->priority = JobPriority::Low;
+		job->OnFinished.AddLambda([&order, i](Job j)
+		{
+			order.Add(i);
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		});
+		TestEnsure(sheduler.Queue(job));
+		jobs.Add(job);
+	}
+	for(Job job : jobs)
+		job->Wait();
+
+	// Finished jobs that are needed now are finalized first
+	sheduler.Prioritize(jobs[4]);
+	sheduler.Update(0.001f);
+	TestEnsure(order.size() == 1);
+	TestEnsure(order[0] == 4);
+
+	// At least one job is finalized per update
+	sheduler.Update(0.0f);
+	TestEnsure(order.size() == 2);
+
+	TestEnsure(WaitForJobs(sheduler, jobs));
+	TestEnsure(order.size() == 6);
+}